@@ -6,6 +6,7 @@
 #include <bluetooth/hci_lib.h>
 #include <bluetooth/mgmt.h>
 #include <functional>
+#include <unordered_set>
 
 namespace WPEFramework {
 
@@ -110,6 +111,20 @@ namespace Bluetooth {
         {
             ba2oui(Data(), oui);
         }
+        // Allows an address to be the key of a hashed container.
+        struct Hash {
+            size_t operator()(const Address& address) const
+            {
+                size_t result = address._length;
+
+                for (uint8_t index = 0; index < address._length; index++) {
+                    result = (result * 31) ^ address._address.b[index];
+                }
+
+                return (result);
+            }
+        };
+
         string ToString() const
         {
             static constexpr TCHAR _hexArray[] = "0123456789ABCDEF";
@@ -145,6 +160,9 @@ namespace Bluetooth {
         static constexpr uint8_t EIR_NAME_COMPLETE = 0x09;
 
     public:
+        // Value reported by the controller if it can not tell the signal strength of a device.
+        static constexpr int8_t RSSI_NOT_AVAILABLE = 127;
+
         enum capabilities {
             DISPLAY_ONLY = 0x00,
             DISPLAY_YES_NO = 0x01,
@@ -157,7 +175,7 @@ namespace Bluetooth {
         struct IScanning {
             virtual ~IScanning() {}
 
-            virtual void DiscoveredDevice(const bool lowEnergy, const Address&, const string& name) = 0;
+            virtual void DiscoveredDevice(const bool lowEnergy, const Address&, const string& name, const int8_t rssi) = 0;
         };
 
         template <const uint16_t OPCODE, typename OUTBOUND>
@@ -453,11 +471,13 @@ namespace Bluetooth {
         HCISocket()
             : Core::SynchronousChannelType<Core::SocketPort>(SocketPort::RAW, Core::NodeId(), Core::NodeId(), 256, 256)
             , _state(IDLE)
+            , _callback(nullptr)
         {
         }
         HCISocket(const Core::NodeId& sourceNode)
             : Core::SynchronousChannelType<Core::SocketPort>(SocketPort::RAW, sourceNode, Core::NodeId(), 256, 256)
             , _state(IDLE)
+            , _callback(nullptr)
         {
         }
         virtual ~HCISocket()
@@ -534,7 +554,7 @@ namespace Bluetooth {
 
                 void* buf = ALLOCA(sizeof(struct hci_inquiry_req) + (sizeof(inquiry_info) * 128));
                 struct hci_inquiry_req* ir = reinterpret_cast<struct hci_inquiry_req*>(buf);
-                std::list<Address> reported;
+                std::unordered_set<Address, Address::Hash> reported;
 
                 ir->dev_id = hci_get_route(nullptr);
                 ir->num_rsp = 128;
@@ -554,11 +574,8 @@ namespace Bluetooth {
                         bdaddr_t* address = &(info[index].bdaddr);
                         Address newSource(*address);
 
-                        std::list<Address>::const_iterator finder(std::find(reported.begin(), reported.end(), newSource));
-
-                        if (finder == reported.end()) {
-                            reported.push_back(newSource);
-                            callback->DiscoveredDevice(false, newSource, _T("[Unknown]"));
+                        if (reported.insert(newSource).second == true) {
+                            callback->DiscoveredDevice(false, newSource, _T("[Unknown]"), RSSI_NOT_AVAILABLE);
                         }
                     }
 
@@ -621,6 +638,29 @@ namespace Bluetooth {
 
             _state.Unlock();
         }
+        // Handles an HCI event recorded during an earlier scan (packet type, event header and parameters)
+        // as if the controller reports it now, the devices in it are passed on to the callback.
+        void Replay(IScanning* callback, const uint8_t dataFrame[], const uint16_t length)
+        {
+            _state.Lock();
+
+            bool idle = (((_state & ACTION_MASK) == 0) && (length >= (1 + HCI_EVENT_HDR_SIZE)));
+
+            if (idle == true) {
+                _callback = callback;
+            }
+
+            _state.Unlock();
+
+            // Deserialize takes the state lock itself, when reporting a device.
+            if (idle == true) {
+                Deserialize(dataFrame, length);
+
+                _state.Lock();
+                _callback = nullptr;
+                _state.Unlock();
+            }
+        }
         uint32_t Pair(const Address& remote, const uint8_t type = BDADDR_BREDR, const capabilities cap = NO_INPUT_NO_OUTPUT)
         {
 
@@ -739,31 +779,42 @@ namespace Bluetooth {
                 } else if (eventMetaData->subevent == EVT_DISCONNECT_PHYSICAL_LINK_COMPLETE) {
                     TRACE(Trace::Information, (_T("==EVT_DISCONNECT_PHYSICAL_LINK_COMPLETE: unexpected")));
                 } else if (eventMetaData->subevent == EVT_LE_ADVERTISING_REPORT) {
-                    string shortName;
-                    string longName;
-                    const le_advertising_info* advertisingInfo = reinterpret_cast<const le_advertising_info*>(&(eventMetaData->data[1]));
-                    uint16_t offset = 0;
-                    const uint8_t* buffer = advertisingInfo->data;
-                    const char* name = nullptr;
-                    uint8_t pos = 0;
-
-                    while (((offset + buffer[offset]) <= advertisingInfo->length) && (buffer[offset] != 0)) {
-
-                        if (((buffer[offset + 1] == EIR_NAME_SHORT) && (name == nullptr)) || (buffer[offset + 1] == EIR_NAME_COMPLETE)) {
-                            name = reinterpret_cast<const char*>(&(buffer[offset + 2]));
-                            pos = buffer[offset] - 1;
+                    // A single event may carry several reports, each followed by the RSSI of the device.
+                    const uint8_t* report = &(eventMetaData->data[1]);
+                    const uint8_t* end = &(dataFrame[availableData]);
+                    uint8_t reports = eventMetaData->data[0];
+
+                    while ((reports-- > 0) && ((report + LE_ADVERTISING_INFO_SIZE) < end)) {
+                        const le_advertising_info* advertisingInfo = reinterpret_cast<const le_advertising_info*>(report);
+                        const uint8_t* buffer = advertisingInfo->data;
+                        uint16_t offset = 0;
+                        const char* name = nullptr;
+                        uint8_t pos = 0;
+
+                        if ((buffer + advertisingInfo->length) >= end) {
+                            break;
                         }
-                        offset += (buffer[offset] + 1);
-                    }
 
-                    if ((name == nullptr) || (pos == 0)) {
-                        TRACE_L1("Entry[%s] has no name. Do not report it.", Address(advertisingInfo->bdaddr).ToString());
-                    } else {
-                        _state.Lock();
-                        if (_callback != nullptr) {
-                            _callback->DiscoveredDevice(true, Address(advertisingInfo->bdaddr), string(name, pos));
+                        while (((offset + buffer[offset]) <= advertisingInfo->length) && (buffer[offset] != 0)) {
+
+                            if (((buffer[offset + 1] == EIR_NAME_SHORT) && (name == nullptr)) || (buffer[offset + 1] == EIR_NAME_COMPLETE)) {
+                                name = reinterpret_cast<const char*>(&(buffer[offset + 2]));
+                                pos = buffer[offset] - 1;
+                            }
+                            offset += (buffer[offset] + 1);
                         }
-                        _state.Unlock();
+
+                        if ((name == nullptr) || (pos == 0)) {
+                            TRACE_L1("Entry[%s] has no name. Do not report it.", Address(advertisingInfo->bdaddr).ToString().c_str());
+                        } else {
+                            _state.Lock();
+                            if (_callback != nullptr) {
+                                _callback->DiscoveredDevice(true, Address(advertisingInfo->bdaddr), string(name, pos), static_cast<int8_t>(buffer[advertisingInfo->length]));
+                            }
+                            _state.Unlock();
+                        }
+
+                        report = buffer + advertisingInfo->length + 1;
                     }
                 } else {
                     TRACE(Trace::Information, (_T("==EVT_LE_META_EVENT: unexpected subevent: %d"), eventMetaData->subevent));
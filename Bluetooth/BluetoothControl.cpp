@@ -488,8 +488,7 @@ namespace Plugin {
 
             TRACE(Trace::Information, ("Start Bluetooth Scan"));
 
-            // Clearing previously discovered devices.
-            RemoveDevices([](DeviceImpl* device) -> bool { if ((device->IsPaired() == false) && (device->IsConnected() == false)) device->Clear(); return(false); });
+            // Devices that are not seen during this scan are cleared once it completes.
 
             bool lowEnergy = true;
             bool limited = false;
@@ -527,40 +526,79 @@ namespace Plugin {
         return (Core::Service<DeviceImpl::IteratorImpl>::Create<IBluetooth::IDevice::IIterator>(_devices));
     }
 
-    void BluetoothControl::DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name)
+    void BluetoothControl::DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name, const int8_t rssi)
     {
 
         _adminLock.Lock();
 
-        std::list<DeviceImpl*>::iterator index = _devices.begin();
+        std::unordered_map<Bluetooth::Address, DeviceImpl*, Bluetooth::Address::Hash>::iterator index(_index.find(address));
 
-        while ((index != _devices.end()) && (*(*index) != address)) {
-            index++;
+        if (index != _index.end()) {
+            // Dense environments report the same devices over and over again, only pass on what changed.
+            if (index->second->Discovered(rssi) == true) {
+                Notify(index->second);
+            }
+        } else {
+            DeviceImpl* device;
+
+            if (lowEnergy == true) {
+                TRACE(Trace::Information, ("Added LowEnergy Bluetooth device: %s, name: %s", address.ToString().c_str(), name.c_str()));
+                device = Core::Service<DeviceLowEnergy>::Create<DeviceImpl>(&_administrator, &_application, address, name);
+            } else {
+                TRACE(Trace::Information, ("Added Regular Bluetooth device: %s, name: %s", address.ToString().c_str(), name.c_str()));
+                device = Core::Service<DeviceRegular>::Create<DeviceImpl>(&_administrator, &_application, address, name);
+            }
+
+            _devices.push_back(device);
+            _index.emplace(address, device);
+
+            device->Discovered(rssi);
+            Notify(device);
         }
 
-        if (index != _devices.end()) {
-            (*index)->Discovered();
-        } else if (lowEnergy == true) {
-            TRACE(Trace::Information, ("Added LowEnergy Bluetooth device: %s, name: %s", address.ToString().c_str(), name.c_str()));
-            _devices.push_back(Core::Service<DeviceLowEnergy>::Create<DeviceImpl>(&_administrator, &_application, address, name));
-        } else {
-            TRACE(Trace::Information, ("Added Regular Bluetooth device: %s, name: %s", address.ToString().c_str(), name.c_str()));
-            _devices.push_back(Core::Service<DeviceRegular>::Create<DeviceImpl>(&_administrator, &_application, address, name));
+        _adminLock.Unlock();
+    }
+
+    void BluetoothControl::ScanCompleted(const uint64_t start)
+    {
+        _adminLock.Lock();
+
+        // Devices that did not show up during the scan are lost, unless we are still bound to them.
+        for (DeviceImpl* device : _devices) {
+            if ((device->LastSeen() < start) && (device->IsDiscovered() == true) && (device->IsPaired() == false) && (device->IsConnected() == false)) {
+                device->Clear();
+
+                if (device->IsDiscovered() == false) {
+                    Notify(device);
+                }
+            }
         }
 
         _adminLock.Unlock();
     }
 
+    void BluetoothControl::Notify(DeviceImpl* device)
+    {
+        for (IBluetooth::INotification* observer : _observers) {
+            observer->Update(device);
+        }
+    }
+
     void BluetoothControl::RemoveDevices(std::function<bool(DeviceImpl*)> filter)
     {
 
         _adminLock.Lock();
 
-        for (std::list<DeviceImpl*>::iterator index = _devices.begin(), end = _devices.end(); index != end; ++index) {
+        std::list<DeviceImpl*>::iterator index = _devices.begin();
+
+        while (index != _devices.end()) {
             // call the function passed into findMatchingAddresses and see if it matches
             if (filter(*index) == true) {
+                _index.erase((*index)->Locator());
                 (*index)->Release();
                 index = _devices.erase(index);
+            } else {
+                index++;
             }
         }
 
@@ -568,14 +606,9 @@ namespace Plugin {
     }
     BluetoothControl::DeviceImpl* BluetoothControl::Find(const string& address)
     {
-        Bluetooth::Address search(address.c_str());
-        std::list<DeviceImpl*>::const_iterator index = _devices.begin();
-
-        while ((index != _devices.end()) && ((*index)->operator==(search) == false)) {
-            index++;
-        }
+        std::unordered_map<Bluetooth::Address, DeviceImpl*, Bluetooth::Address::Hash>::const_iterator index(_index.find(Bluetooth::Address(address.c_str())));
 
-        return (index != _devices.end() ? (*index) : nullptr);
+        return (index != _index.end() ? index->second : nullptr);
     }
     void BluetoothControl::Notification(const uint8_t subEvent, const uint16_t length, const uint8_t* dataFrame)
     {
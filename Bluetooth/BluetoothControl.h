@@ -6,6 +6,7 @@
 #include <functional>
 #include <interfaces/IBluetooth.h>
 #include <linux/uhid.h>
+#include <unordered_map>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -44,6 +45,7 @@ namespace Plugin {
                 Job(Scanner* parent)
                     : _parent(*parent)
                     , _mode(0)
+                    , _submitted(false)
                 {
                 }
                 virtual ~Job()
@@ -51,9 +53,14 @@ namespace Plugin {
                 }
 
             public:
+                inline bool IsSubmitted() const
+                {
+                    return (_submitted);
+                }
                 void Load(const uint16_t scanTime, const uint32_t type, const uint8_t flags)
                 {
                     if (_mode == 0) {
+                        _submitted = true;
                         _mode = REGULAR;
                         _scanTime = scanTime;
                         _type = type;
@@ -64,6 +71,7 @@ namespace Plugin {
                 void Load(const uint16_t scanTime, const bool limited, const bool passive)
                 {
                     if (_mode == 0) {
+                        _submitted = true;
                         _mode = LOW_ENERGY | (passive ? PASSIVE : 0) | (limited ? LIMITED : 0);
                         _scanTime = scanTime;
                         PluginHost::WorkerPool::Instance().Submit(Core::ProxyType<Core::IDispatch>(*this));
@@ -91,6 +99,7 @@ namespace Plugin {
                 uint32_t _type;
                 uint8_t _flags;
                 uint8_t _mode;
+                bool _submitted;
             };
 
         public:
@@ -102,13 +111,20 @@ namespace Plugin {
             }
             virtual ~Scanner()
             {
-                PluginHost::WorkerPool::Instance().Revoke(Core::ProxyType<Core::IDispatch>(_activity));
+                // Only recorded scans might have been replayed, then there is no job to revoke.
+                if (_activity->IsSubmitted() == true) {
+                    PluginHost::WorkerPool::Instance().Revoke(Core::ProxyType<Core::IDispatch>(_activity));
+                }
             }
 
         public:
-            virtual void DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name) override
+            virtual void DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name, const int8_t rssi) override
             {
-                _parent.DiscoveredDevice(lowEnergy, address, name);
+                _parent.DiscoveredDevice(lowEnergy, address, name, rssi);
+            }
+            void Replay(const uint8_t dataFrame[], const uint16_t length)
+            {
+                Bluetooth::HCISocket::Replay(this, dataFrame, length);
             }
             void Scan(const uint16_t scanTime, const uint32_t type, const uint8_t flags)
             {
@@ -155,11 +171,15 @@ namespace Plugin {
             }
             void Run(const uint16_t scanTime, const uint32_t type, const uint8_t flags)
             {
+                uint64_t start = Core::Time::Now().Ticks();
                 Bluetooth::HCISocket::Scan(this, scanTime, type, flags);
+                _parent.ScanCompleted(start);
             }
             void Run(const uint16_t scanTime, const bool limited, const bool passive)
             {
+                uint64_t start = Core::Time::Now().Ticks();
                 Bluetooth::HCISocket::Scan(this, scanTime, limited, passive);
+                _parent.ScanCompleted(start);
             }
 
         private:
@@ -532,6 +552,9 @@ namespace Plugin {
 
             static constexpr uint16_t ACTION_MASK = 0x0FFF;
 
+            // Changes of the signal strength, in dBm, that are smaller than this are not reported.
+            static constexpr int8_t RSSI_HYSTERESIS = 6;
+
         public:
             static constexpr uint32_t MAX_ACTION_TIMEOUT = 2000; /* 2S to setup a connection ? */
 
@@ -558,6 +581,7 @@ namespace Plugin {
                     , Connected(false)
                     , Paired(false)
                     , Reason(0)
+                    , RSSI(0)
                 {
                     Add(_T("address"), &Address);
                     Add(_T("name"), &Name);
@@ -565,6 +589,7 @@ namespace Plugin {
                     Add(_T("connected"), &Connected);
                     Add(_T("paired"), &Paired);
                     Add(_T("reason"), &Reason);
+                    Add(_T("rssi"), &RSSI);
                 }
                 JSON(const JSON& copy)
                     : Core::JSON::Container()
@@ -574,6 +599,7 @@ namespace Plugin {
                     , Connected(false)
                     , Paired(false)
                     , Reason(0)
+                    , RSSI(0)
                 {
                     Add(_T("address"), &Address);
                     Add(_T("name"), &Name);
@@ -581,12 +607,14 @@ namespace Plugin {
                     Add(_T("connected"), &Connected);
                     Add(_T("paired"), &Paired);
                     Add(_T("reason"), &Reason);
+                    Add(_T("rssi"), &RSSI);
                     Address = copy.Address;
                     Name = copy.Name;
                     LowEnergy = copy.LowEnergy;
                     Connected = copy.Connected;
                     Paired = copy.Paired;
                     Reason = copy.Reason;
+                    RSSI = copy.RSSI;
                 }
                 virtual ~JSON()
                 {
@@ -601,12 +629,18 @@ namespace Plugin {
                         LowEnergy = source->LowEnergy();
                         Connected = source->IsConnected();
                         Paired = source->IsPaired();
+                        if (source->RSSI() != Bluetooth::HCISocket::RSSI_NOT_AVAILABLE) {
+                            RSSI = source->RSSI();
+                        } else {
+                            RSSI.Clear();
+                        }
                     } else {
                         Address.Clear();
                         Name.Clear();
                         LowEnergy.Clear();
                         Paired.Clear();
                         Connected.Clear();
+                        RSSI.Clear();
                     }
                     return (*this);
                 }
@@ -616,6 +650,7 @@ namespace Plugin {
                 Core::JSON::Boolean Connected;
                 Core::JSON::Boolean Paired;
                 Core::JSON::DecUInt16 Reason;
+                Core::JSON::DecSInt8 RSSI;
             };
 
             class IteratorImpl : public IBluetooth::IDevice::IIterator {
@@ -762,6 +797,9 @@ namespace Plugin {
                 , _address(address)
                 , _name(name)
                 , _state(static_cast<state>(lowEnergy ? LOWENERGY : 0))
+                , _rssi(Bluetooth::HCISocket::RSSI_NOT_AVAILABLE)
+                , _reportedRSSI(Bluetooth::HCISocket::RSSI_NOT_AVAILABLE)
+                , _lastSeen(0)
             {
                 ASSERT(_administrator != nullptr);
                 ASSERT(_application != nullptr);
@@ -810,13 +848,39 @@ namespace Plugin {
                 }
                 _state.Unlock();
             }
-            inline void Discovered()
+            // Records a sighting of the device during a scan. Returns true if the observers should hear
+            // about it: the device (re)appeared or its, smoothed, signal strength moved noticeably.
+            inline bool Discovered(const int8_t rssi)
             {
+                bool changed = false;
+
                 _state.Lock();
                 if (((_state & ACTION_MASK) == DECOUPLED) && (_application != nullptr)) {
                     _state.SetState(static_cast<state>(_state.GetState() & (~DECOUPLED)));
+                    changed = true;
                 }
                 _state.Unlock();
+
+                _lastSeen = Core::Time::Now().Ticks();
+
+                if (rssi != Bluetooth::HCISocket::RSSI_NOT_AVAILABLE) {
+                    _rssi = (_rssi == Bluetooth::HCISocket::RSSI_NOT_AVAILABLE ? rssi : static_cast<int8_t>(((3 * static_cast<int16_t>(_rssi)) + rssi) / 4));
+
+                    if ((_reportedRSSI == Bluetooth::HCISocket::RSSI_NOT_AVAILABLE) || (std::abs(_rssi - _reportedRSSI) >= RSSI_HYSTERESIS)) {
+                        _reportedRSSI = _rssi;
+                        changed = true;
+                    }
+                }
+
+                return (changed);
+            }
+            inline int8_t RSSI() const
+            {
+                return (_rssi);
+            }
+            inline uint64_t LastSeen() const
+            {
+                return (_lastSeen);
             }
             inline bool operator==(const Bluetooth::Address& rhs) const
             {
@@ -917,6 +981,9 @@ namespace Plugin {
             string _name;
             Core::StateTrigger<state> _state;
             uint8_t _features[8];
+            int8_t _rssi;
+            int8_t _reportedRSSI;
+            uint64_t _lastSeen;
         };
 
         class EXTERNAL DeviceRegular : public DeviceImpl, Core::IOutbound::ICallback {
@@ -1164,6 +1231,7 @@ namespace Plugin {
             , _btAddress()
             , _interface()
             , _devices()
+            , _index()
             , _observers()
             , _gattRemotes()
         {
@@ -1216,14 +1284,27 @@ namespace Plugin {
         virtual IBluetooth::IDevice* Device(const string&) override;
         virtual IBluetooth::IDevice::IIterator* Devices() override;
 
+        // Handles HCI events recorded during a scan as if the controller reports them now, Replayed()
+        // completes a replayed scan that started at the given time, see benchmark/ScanReplay.cpp.
+        inline void Replay(const uint8_t dataFrame[], const uint16_t length)
+        {
+            _application.Replay(dataFrame, length);
+        }
+        inline void Replayed(const uint64_t start)
+        {
+            ScanCompleted(start);
+        }
+
     private:
         Core::ProxyType<Web::Response> GetMethod(Core::TextSegmentIterator& index);
         Core::ProxyType<Web::Response> PutMethod(Core::TextSegmentIterator& index, const Web::Request& request);
         Core::ProxyType<Web::Response> PostMethod(Core::TextSegmentIterator& index, const Web::Request& request);
         Core::ProxyType<Web::Response> DeleteMethod(Core::TextSegmentIterator& index, const Web::Request& request);
         void RemoveDevices(std::function<bool(DeviceImpl*)> filter);
-        void DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name);
+        void DiscoveredDevice(const bool lowEnergy, const Bluetooth::Address& address, const string& name, const int8_t rssi);
+        void ScanCompleted(const uint64_t start);
         void Notification(const uint8_t subEvent, const uint16_t length, const uint8_t* dataFrame);
+        void Notify(DeviceImpl* device);
         DeviceImpl* Find(const string&);
 
     private:
@@ -1236,6 +1317,7 @@ namespace Plugin {
         Bluetooth::Address _btAddress;
         Bluetooth::Driver::Interface _interface;
         std::list<DeviceImpl*> _devices;
+        std::unordered_map<Bluetooth::Address, DeviceImpl*, Bluetooth::Address::Hash> _index;
         std::list<IBluetooth::INotification*> _observers;
         std::list<GATTRemote> _gattRemotes;
         static string _HIDPath;
@@ -0,0 +1,301 @@
+// Replays LE advertising reports recorded during scans through the scanner and the device table of
+// the BluetoothControl plugin, and measures how fast it keeps up and how many updates the observers
+// get, in a dense environment with many advertisers repeating their reports.
+//
+//     ScanReplay [-t <btsnoop trace>] [-w <window s>] [-d <devices>] [-n <windows>] [-o <btsnoop trace>]
+//
+// A trace is read in the btsnoop format, as written by "btmon -w" or the HCI snoop log of Android,
+// and cut into scans of the window length (10 s by default) by the time stamps of its records. Only
+// the LE advertising reports in it are replayed. Without a trace, one is generated: 300 advertisers
+// reporting 5 times per window over 20 windows, with a varying signal strength, and a tenth of them
+// out of range in every window. The generated trace can be written with -o, to replay it elsewhere.
+//
+// There is no controller answering the connection attempts the plugin makes to new LE devices, so
+// these stay pending and, like in the plugin itself while an attempt is pending, are not reported lost.
+
+#include "BluetoothControl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+
+using namespace WPEFramework;
+
+namespace {
+
+struct Event {
+    uint64_t Time; // us
+    std::vector<uint8_t> Frame; // packet type, event header and parameters
+};
+
+class Observer : public Exchange::IBluetooth::INotification {
+private:
+    Observer(const Observer&) = delete;
+    Observer& operator=(const Observer&) = delete;
+
+public:
+    Observer()
+        : _known()
+        , New(0)
+        , Changed(0)
+        , Lost(0)
+    {
+    }
+    ~Observer() override
+    {
+    }
+
+public:
+    void Update(Exchange::IBluetooth::IDevice* device) override
+    {
+        if (device->IsDiscovered() == false) {
+            Lost++;
+        } else if (_known.insert(device).second == true) {
+            New++;
+        } else {
+            Changed++;
+        }
+    }
+
+    BEGIN_INTERFACE_MAP(Observer)
+    INTERFACE_ENTRY(Exchange::IBluetooth::INotification)
+    END_INTERFACE_MAP
+
+private:
+    std::set<const Exchange::IBluetooth::IDevice*> _known;
+
+public:
+    uint32_t New;
+    uint32_t Changed;
+    uint32_t Lost;
+};
+
+uint32_t Read32(const uint8_t data[])
+{
+    return ((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+void Write32(FILE* file, const uint32_t value)
+{
+    const uint8_t data[] = { static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value) };
+    fwrite(data, 1, sizeof(data), file);
+}
+
+// Reads the LE advertising reports from a btsnoop file, with H4 (1002) or unencapsulated HCI (1001) packets.
+bool Load(const string& fileName, std::vector<Event>& events)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    bool result = false;
+
+    if (file != nullptr) {
+        uint8_t header[16];
+
+        if ((fread(header, 1, sizeof(header), file) == sizeof(header)) && (memcmp(header, "btsnoop\0", 8) == 0)) {
+            const uint32_t datalink = Read32(&header[12]);
+            uint8_t record[24];
+
+            result = ((datalink == 1001) || (datalink == 1002));
+
+            while ((result == true) && (fread(record, 1, sizeof(record), file) == sizeof(record))) {
+                const uint32_t length = Read32(&record[4]);
+                const uint32_t flags = Read32(&record[8]);
+                const uint64_t time = (static_cast<uint64_t>(Read32(&record[16])) << 32) | Read32(&record[20]);
+                Event event;
+
+                if (datalink == 1001) {
+                    // Received command/event packets are events.
+                    event.Frame.push_back((flags & 0x03) == 0x03 ? HCI_EVENT_PKT : 0);
+                }
+
+                const size_t offset = event.Frame.size();
+                event.Frame.resize(offset + length);
+
+                if (fread(&(event.Frame[offset]), 1, length, file) != length) {
+                    break;
+                }
+
+                if ((event.Frame.size() >= (1 + HCI_EVENT_HDR_SIZE + 2)) && (event.Frame[0] == HCI_EVENT_PKT) && (event.Frame[1] == EVT_LE_META_EVENT) && (event.Frame[3] == EVT_LE_ADVERTISING_REPORT)) {
+                    event.Time = time;
+                    events.push_back(std::move(event));
+                }
+            }
+        }
+
+        fclose(file);
+    }
+
+    return (result);
+}
+
+bool Save(const string& fileName, const std::vector<Event>& events)
+{
+    FILE* file = fopen(fileName.c_str(), "wb");
+
+    if (file != nullptr) {
+        fwrite("btsnoop\0", 1, 8, file);
+        Write32(file, 1);
+        Write32(file, 1002);
+
+        for (const Event& event : events) {
+            Write32(file, static_cast<uint32_t>(event.Frame.size()));
+            Write32(file, static_cast<uint32_t>(event.Frame.size()));
+            Write32(file, 0x03);
+            Write32(file, 0);
+            Write32(file, static_cast<uint32_t>(event.Time >> 32));
+            Write32(file, static_cast<uint32_t>(event.Time));
+            fwrite(event.Frame.data(), 1, event.Frame.size(), file);
+        }
+
+        fclose(file);
+    }
+
+    return (file != nullptr);
+}
+
+// Generates the advertising reports of a dense environment, every event carries up to 3 reports.
+void Generate(const uint32_t devices, const uint32_t windows, const uint32_t window, std::vector<Event>& events)
+{
+    std::mt19937 random(1);
+    std::vector<int8_t> strength(devices);
+    uint64_t time = 0;
+
+    for (uint32_t index = 0; index < devices; index++) {
+        strength[index] = static_cast<int8_t>(-40 - (random() % 50));
+    }
+
+    for (uint32_t round = 0; round < windows; round++) {
+        std::vector<uint32_t> reports;
+
+        for (uint32_t index = 0; index < devices; index++) {
+            // A tenth of the devices is out of range during a window, another one walks away or closer.
+            if ((random() % 10) != 0) {
+                reports.insert(reports.end(), 5, index);
+            }
+            if ((index % 10) == 1) {
+                strength[index] = static_cast<int8_t>(std::max(-95, std::min(-30, strength[index] + static_cast<int>(random() % 9) - 4)));
+            }
+        }
+
+        std::shuffle(reports.begin(), reports.end(), random);
+
+        const uint64_t step = (static_cast<uint64_t>(window) * 1000 * 1000) / std::max(reports.size(), static_cast<size_t>(1));
+
+        for (size_t index = 0; index < reports.size();) {
+            const uint8_t count = static_cast<uint8_t>(std::min(static_cast<size_t>(1 + (random() % 3)), reports.size() - index));
+            Event event;
+
+            event.Time = time;
+            event.Frame = { HCI_EVENT_PKT, EVT_LE_META_EVENT, 0, EVT_LE_ADVERTISING_REPORT, count };
+
+            for (uint8_t report = 0; report < count; report++, index++) {
+                const uint32_t device = reports[index];
+                char name[16];
+                const uint8_t length = static_cast<uint8_t>(snprintf(name, sizeof(name), "Device-%u", device));
+
+                // Event type, random address, the address, the advertising data: flags and the complete name.
+                event.Frame.insert(event.Frame.end(), { 0x00, 0x01, static_cast<uint8_t>(device), static_cast<uint8_t>(device >> 8), static_cast<uint8_t>(device >> 16), 0x5A, 0x3C, 0xC0 });
+                event.Frame.insert(event.Frame.end(), { static_cast<uint8_t>(3 + 2 + length), 0x02, 0x01, 0x06, static_cast<uint8_t>(length + 1), 0x09 });
+                event.Frame.insert(event.Frame.end(), name, name + length);
+                event.Frame.push_back(static_cast<uint8_t>(strength[device] + static_cast<int>(random() % 7) - 3));
+            }
+
+            event.Frame[2] = static_cast<uint8_t>(event.Frame.size() - (1 + HCI_EVENT_HDR_SIZE));
+            events.push_back(std::move(event));
+
+            time += step * count;
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    string trace;
+    string output;
+    uint32_t window = 10;
+    uint32_t devices = 300;
+    uint32_t windows = 20;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:w:d:n:o:")) != -1) {
+        switch (option) {
+        case 't':
+            trace = optarg;
+            break;
+        case 'w':
+            window = std::max(atoi(optarg), 1);
+            break;
+        case 'd':
+            devices = std::max(std::min(atoi(optarg), 0xFFFFFF), 1);
+            break;
+        case 'n':
+            windows = std::max(atoi(optarg), 1);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-t <btsnoop trace>] [-w <window s>] [-d <devices>] [-n <windows>] [-o <btsnoop trace>]\n", argv[0]);
+            return (1);
+        }
+    }
+
+    std::vector<Event> events;
+
+    if (trace.empty() == false) {
+        if (Load(trace, events) == false) {
+            fprintf(stderr, "Could not read the btsnoop trace %s\n", trace.c_str());
+            return (1);
+        }
+    } else {
+        Generate(devices, windows, window, events);
+
+        if ((output.empty() == false) && (Save(output, events) == false)) {
+            fprintf(stderr, "Could not write the btsnoop trace %s\n", output.c_str());
+        }
+    }
+
+    Plugin::BluetoothControl* plugin = Core::Service<Plugin::BluetoothControl>::Create<Plugin::BluetoothControl>();
+    Core::Sink<Observer> observer;
+    uint32_t reports = 0;
+    uint32_t scans = 0;
+
+    plugin->Register(&observer);
+
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point begin = Clock::now();
+
+    for (size_t index = 0; index < events.size();) {
+        const uint64_t end = events[index].Time + (static_cast<uint64_t>(window) * 1000 * 1000);
+        const uint64_t start = Core::Time::Now().Ticks();
+
+        while ((index < events.size()) && (events[index].Time < end)) {
+            reports += events[index].Frame[4];
+            plugin->Replay(events[index].Frame.data(), static_cast<uint16_t>(events[index].Frame.size()));
+            index++;
+        }
+
+        plugin->Replayed(start);
+        scans++;
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    plugin->Unregister(&observer);
+
+    printf("%u advertising events, %u reports in %u scan(s) of %u s, replayed in %.3f s\n\n",
+        static_cast<uint32_t>(events.size()), reports, scans, window, elapsed);
+    printf("%-20s %12.0f\n", "events/s", events.size() / elapsed);
+    printf("%-20s %12.0f\n", "reports/s", reports / elapsed);
+    printf("%-20s %12.1f\n", "us per scan", (elapsed * 1000 * 1000) / std::max(scans, 1u));
+    printf("\nobserver updates: %u new, %u changed, %u lost (%.1f%% of the reports)\n",
+        observer.New, observer.Changed, observer.Lost, (100.0 * (observer.New + observer.Changed + observer.Lost)) / std::max(reports, 1u));
+
+    plugin->Release();
+
+    Core::Singleton::Dispose();
+
+    return (0);
+}
@@ -241,6 +241,8 @@ namespace Plugin {
             data.Index = sequencer.Index();
         }
 
+        sequencer.Timing(data);
+
         return (data);
     }
 
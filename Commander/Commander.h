@@ -22,20 +22,28 @@ namespace Plugin {
                 , Item()
                 , Label()
                 , Parameters(false)
+                , After()
+                , Parallel(false)
             {
                 Add(_T("command"), &Item);
                 Add(_T("label"), &Label);
                 Add(_T("parameters"), &Parameters);
+                Add(_T("after"), &After);
+                Add(_T("parallel"), &Parallel);
             }
             Command(const Command& copy)
                 : Core::JSON::Container()
                 , Item(copy.Item)
                 , Label(copy.Label)
                 , Parameters(copy.Parameters)
+                , After(copy.After)
+                , Parallel(copy.Parallel)
             {
                 Add(_T("command"), &Item);
                 Add(_T("label"), &Label);
                 Add(_T("parameters"), &Parameters);
+                Add(_T("after"), &After);
+                Add(_T("parallel"), &Parallel);
             }
             ~Command()
             {
@@ -46,6 +54,8 @@ namespace Plugin {
                 Item = RHS.Item;
                 Label = RHS.Label;
                 Parameters = RHS.Parameters;
+                After = RHS.After;
+                Parallel = RHS.Parallel;
 
                 return (*this);
             }
@@ -54,9 +64,57 @@ namespace Plugin {
             Core::JSON::String Item;
             Core::JSON::String Label;
             Core::JSON::String Parameters;
+            // A parallel step does not wait for the steps before it, only for the steps with the
+            // labels it runs after. The sequence continues with the next step right away.
+            Core::JSON::ArrayType<Core::JSON::String> After;
+            Core::JSON::Boolean Parallel;
         };
 
         class Data : public Core::JSON::Container {
+        public:
+            class Step : public Core::JSON::Container {
+            public:
+                Step()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("label"), &Label);
+                    Add(_T("start"), &Start);
+                    Add(_T("duration"), &Duration);
+                    Add(_T("result"), &Result);
+                }
+                Step(const Step& copy)
+                    : Core::JSON::Container()
+                    , Label(copy.Label)
+                    , Start(copy.Start)
+                    , Duration(copy.Duration)
+                    , Result(copy.Result)
+                {
+                    Add(_T("label"), &Label);
+                    Add(_T("start"), &Start);
+                    Add(_T("duration"), &Duration);
+                    Add(_T("result"), &Result);
+                }
+                ~Step()
+                {
+                }
+
+                Step& operator=(const Step& RHS)
+                {
+                    Label = RHS.Label;
+                    Start = RHS.Start;
+                    Duration = RHS.Duration;
+                    Result = RHS.Result;
+
+                    return (*this);
+                }
+
+            public:
+                Core::JSON::String Label;
+                Core::JSON::DecUInt64 Start; // Time in us after the start of the sequence
+                Core::JSON::DecUInt64 Duration; // Time in us the step took
+                Core::JSON::String Result;
+            };
+
         public:
             Data()
                 : Core::JSON::Container()
@@ -66,6 +124,8 @@ namespace Plugin {
                 Add(_T("index"), &Index);
                 Add(_T("label"), &Label);
                 Add(_T("command"), &Command);
+                Add(_T("duration"), &Duration);
+                Add(_T("steps"), &Steps);
             }
             Data(const string& name, const state actualState, const uint32_t index, const string& label)
                 : Core::JSON::Container()
@@ -75,6 +135,8 @@ namespace Plugin {
                 Add(_T("index"), &Index);
                 Add(_T("label"), &Label);
                 Add(_T("command"), &Command);
+                Add(_T("duration"), &Duration);
+                Add(_T("steps"), &Steps);
 
                 Sequencer = name;
                 State = actualState;
@@ -88,12 +150,16 @@ namespace Plugin {
                 , Index(copy.Index)
                 , Label(copy.Label)
                 , Command(copy.Command)
+                , Duration(copy.Duration)
+                , Steps(copy.Steps)
             {
                 Add(_T("sequencer"), &Sequencer);
                 Add(_T("state"), &State);
                 Add(_T("index"), &Index);
                 Add(_T("label"), &Label);
                 Add(_T("Command"), &Command);
+                Add(_T("duration"), &Duration);
+                Add(_T("steps"), &Steps);
             }
             ~Data()
             {
@@ -106,6 +172,8 @@ namespace Plugin {
                 Index = RHS.Index;
                 Label = RHS.Label;
                 Command = RHS.Command;
+                Duration = RHS.Duration;
+                Steps = RHS.Steps;
 
                 return (*this);
             }
@@ -116,6 +184,8 @@ namespace Plugin {
             Core::JSON::DecUInt32 Index;
             Core::JSON::String Label;
             Core::JSON::String Command;
+            Core::JSON::DecUInt64 Duration; // Time in us the last completed sequence took
+            Core::JSON::ArrayType<Step> Steps;
         };
 
     private:
@@ -218,12 +288,60 @@ namespace Plugin {
             Core::CriticalSection _adminLock;
             std::map<const string, Exchange::ICommand::IFactory*> _factory;
         };
+        // The steps of a sequence are started in order. A regular step waits until all steps started
+        // before it have completed and is executed by the sequencer itself, so it can still redirect
+        // the sequence to a label. A parallel step only waits for the running steps that carry one of
+        // the labels it should run after, is handed to the worker pool and the sequence continues
+        // with the next step right away. The result of a parallel step is recorded, but does not
+        // redirect the sequence. Whichever thread completes a step makes the sequence progress.
         class Sequencer : public Core::IDispatchType<void> {
         private:
             Sequencer() = delete;
             Sequencer(const Sequencer& copy) = delete;
             Sequencer& operator=(const Sequencer&) = delete;
 
+            class Step : public Core::IDispatchType<void> {
+            private:
+                Step() = delete;
+                Step(const Step&) = delete;
+                Step& operator=(const Step&) = delete;
+
+            public:
+                Step(Sequencer* parent, const uint32_t index)
+                    : _parent(*parent)
+                    , _index(index)
+                {
+                    ASSERT(parent != nullptr);
+                }
+                virtual ~Step()
+                {
+                }
+
+            public:
+                virtual void Dispatch() override
+                {
+                    _parent.Run(_index);
+                }
+
+            private:
+                Sequencer& _parent;
+                const uint32_t _index;
+            };
+
+            struct Schedule {
+                bool Parallel;
+                bool Running;
+                std::list<string> After;
+                uint64_t Start;
+                Core::ProxyType<Core::IDispatchType<void>> Job;
+            };
+            struct Measurement {
+                string Label;
+                uint64_t Start;
+                uint64_t Duration;
+                string Result;
+            };
+
         public:
             Sequencer(const string& name, Administrator* commandFactory, PluginHost::IShell* service)
                 : _commandFactory(commandFactory)
@@ -233,6 +351,13 @@ namespace Plugin {
                 , _name(name)
                 , _service(service)
                 , _sequenceList(5)
+                , _schedule()
+                , _timing()
+                , _running(0)
+                , _executing(false)
+                , _pending(false)
+                , _begin(0)
+                , _duration(0)
             {
                 ASSERT(service != nullptr);
 
@@ -295,6 +420,24 @@ namespace Plugin {
 
                 return (result);
             }
+            // Reports the timing of the steps that were started in the current, or last, sequence.
+            void Timing(Data& data) const
+            {
+                _adminLock.Lock();
+
+                data.Duration = _duration;
+
+                for (const Measurement& entry : _timing) {
+                    Data::Step& step(data.Steps.Add());
+
+                    step.Label = entry.Label;
+                    step.Start = entry.Start - _begin;
+                    step.Duration = entry.Duration;
+                    step.Result = entry.Result;
+                }
+
+                _adminLock.Unlock();
+            }
             uint32_t Load(const Core::JSON::ArrayType<Command>& commandList)
             {
 
@@ -310,6 +453,7 @@ namespace Plugin {
                     if (_sequenceList.Count() > 0) {
                         _sequenceList.Clear(0, _sequenceList.Count());
                     }
+                    _schedule.clear();
 
                     Core::JSON::ArrayType<Command>::ConstIterator index(commandList.Elements());
 
@@ -322,6 +466,20 @@ namespace Plugin {
                         Core::ProxyType<Exchange::ICommand> newCommand(_commandFactory->Create(label, className, parameters));
 
                         if (newCommand.IsValid() == true) {
+                            _schedule.emplace_back();
+
+                            Schedule& entry(_schedule.back());
+                            Core::JSON::ArrayType<Core::JSON::String>::ConstIterator after(index.Current().After.Elements());
+
+                            entry.Parallel = index.Current().Parallel.Value();
+                            entry.Running = false;
+                            entry.Start = 0;
+                            entry.Job = Core::proxy_cast<Core::IDispatchType<void>>(Core::ProxyType<Step>::Create(this, _sequenceList.Count()));
+
+                            while (after.Next() == true) {
+                                entry.After.push_back(after.Current().Value());
+                            }
+
                             _sequenceList.Add(newCommand);
                         }
                     }
@@ -346,6 +504,9 @@ namespace Plugin {
                 if (_state == Commander::LOADED) {
                     result = Core::ERROR_NONE;
                     _state = Commander::RUNNING;
+                    _begin = Core::Time::Now().Ticks();
+                    _duration = 0;
+                    _timing.clear();
                 }
 
                 _adminLock.Unlock();
@@ -355,30 +516,65 @@ namespace Plugin {
             uint32_t Abort()
             {
                 uint32_t result = Core::ERROR_ILLEGAL_STATE;
+                std::list<Core::ProxyType<Core::IDispatchType<void>>> jobs;
 
                 _adminLock.Lock();
 
                 if (_state == Commander::RUNNING) {
                     result = Core::ERROR_NONE;
                     _state = Commander::ABORTING;
-                    _sequenceList[_currentIndex]->Abort();
+
+                    for (uint32_t index = 0; index < _schedule.size(); index++) {
+                        if ((_schedule[index].Running == true) || ((index == _currentIndex) && (_executing == true))) {
+                            _sequenceList[index]->Abort();
+                        }
+                        if (_schedule[index].Parallel == true) {
+                            jobs.push_back(_schedule[index].Job);
+                        }
+                    }
                 }
 
                 _adminLock.Unlock();
 
+                if (result == Core::ERROR_NONE) {
+                    // Steps that did not get a thread from the pool yet, will never report back.
+                    for (Core::ProxyType<Core::IDispatchType<void>>& job : jobs) {
+                        PluginHost::WorkerPool::Instance().Revoke(job);
+                    }
+
+                    _adminLock.Lock();
+
+                    for (Schedule& entry : _schedule) {
+                        if (entry.Running == true) {
+                            entry.Running = false;
+                            _running--;
+                        }
+                    }
+
+                    // If the sequence is not progressing on any thread, nobody else will close it.
+                    if ((_executing == false) && (_state == Commander::ABORTING)) {
+                        Finish();
+                    }
+
+                    _adminLock.Unlock();
+                }
+
                 // Wait for the sequencer to reaach a safe positon..
                 return (result);
             }
 
         private:
             virtual void Dispatch()
+            {
+                Progress();
+            }
+            void Run(const uint32_t index)
             {
                 _adminLock.Lock();
 
-                // See if we still need to take some "next steps"
-                while ((_currentIndex < _sequenceList.Count()) && (_state == Commander::RUNNING)) {
+                if ((index < _sequenceList.Count()) && (_schedule[index].Running == true)) {
 
-                    Core::ProxyType<Exchange::ICommand> step(_sequenceList[_currentIndex]);
+                    Core::ProxyType<Exchange::ICommand> step(_sequenceList[index]);
 
                     _adminLock.Unlock();
 
@@ -386,44 +582,143 @@ namespace Plugin {
 
                     _adminLock.Lock();
 
-                    if (result.empty() == true) {
-                        _currentIndex++;
-                    } else {
-                        uint32_t index = _currentIndex + 1;
+                    // An abort might have written this step off already.
+                    if (_schedule[index].Running == true) {
+                        Completed(index, result);
+                        _schedule[index].Running = false;
+                        _running--;
+                    }
+                }
 
-                        // See if we have a forward label, as mentioned from the execute
-                        while ((index < _sequenceList.Count()) && (_sequenceList[index]->Label() != result)) {
-                            index++;
-                        }
+                _adminLock.Unlock();
 
-                        if (index < _sequenceList.Count()) {
-                            // Seems like we found a next step, set it..
-                            _currentIndex = index;
-                        } else {
-                            // There are no steps before our current step, so no label found, just progress...
-                            _currentIndex++;
+                Progress();
+            }
+            void Progress()
+            {
+                _adminLock.Lock();
 
-                            // But let's check if there is a step before us (or we are ourselves :-), we might need to jump to..
-                            index = _currentIndex;
+                if (_executing == true) {
+                    // Another thread is taking the next steps, it will pick up what changed.
+                    _pending = true;
+                } else {
+                    _executing = true;
 
-                            // Check if we have a step with the given label prior to our current step..
-                            while ((index > 0) && (_sequenceList[index - 1]->Label() != result)) {
-                                index--;
-                            }
+                    do {
+                        _pending = false;
+
+                        // See if we still need to take some "next steps"
+                        while ((_currentIndex < _sequenceList.Count()) && (_state == Commander::RUNNING)) {
+
+                            Schedule& entry(_schedule[_currentIndex]);
+
+                            if (entry.Parallel == true) {
+                                if (IsBlocked(entry) == true) {
+                                    break;
+                                }
+
+                                entry.Running = true;
+                                entry.Start = Core::Time::Now().Ticks();
+                                _running++;
+                                _currentIndex++;
+
+                                PluginHost::WorkerPool::Instance().Submit(entry.Job);
+                            } else if (_running > 0) {
+                                break;
+                            } else {
+                                Core::ProxyType<Exchange::ICommand> step(_sequenceList[_currentIndex]);
+
+                                entry.Start = Core::Time::Now().Ticks();
 
-                            if (index > 0) {
-                                _currentIndex = (index - 1);
+                                _adminLock.Unlock();
+
+                                const string result = step->Execute(_service);
+
+                                _adminLock.Lock();
+
+                                Completed(_currentIndex, result);
+                                Next(result);
                             }
                         }
+
+                        if ((_running == 0) && ((_state == Commander::ABORTING) || ((_state == Commander::RUNNING) && (_currentIndex >= _sequenceList.Count())))) {
+                            Finish();
+                        }
+
+                    } while (_pending == true);
+
+                    _executing = false;
+                }
+
+                _adminLock.Unlock();
+            }
+
+            // The methods below should be called with the _adminLock taken.
+            bool IsBlocked(const Schedule& entry) const
+            {
+                bool result = false;
+
+                if (entry.After.empty() == false) {
+                    for (uint32_t index = 0; (index < _schedule.size()) && (result == false); index++) {
+                        result = (_schedule[index].Running == true) && (std::find(entry.After.begin(), entry.After.end(), _sequenceList[index]->Label()) != entry.After.end());
                     }
                 }
 
+                return (result);
+            }
+            void Completed(const uint32_t index, const string& result)
+            {
+                Measurement timing;
+
+                timing.Label = _sequenceList[index]->Label();
+                timing.Start = _schedule[index].Start;
+                timing.Duration = Core::Time::Now().Ticks() - timing.Start;
+                timing.Result = result;
+
+                _timing.push_back(timing);
+            }
+            void Next(const string& result)
+            {
+                if (result.empty() == true) {
+                    _currentIndex++;
+                } else {
+                    uint32_t index = _currentIndex + 1;
+
+                    // See if we have a forward label, as mentioned from the execute
+                    while ((index < _sequenceList.Count()) && (_sequenceList[index]->Label() != result)) {
+                        index++;
+                    }
+
+                    if (index < _sequenceList.Count()) {
+                        // Seems like we found a next step, set it..
+                        _currentIndex = index;
+                    } else {
+                        // There are no steps before our current step, so no label found, just progress...
+                        _currentIndex++;
+
+                        // But let's check if there is a step before us (or we are ourselves :-), we might need to jump to..
+                        index = _currentIndex;
+
+                        // Check if we have a step with the given label prior to our current step..
+                        while ((index > 0) && (_sequenceList[index - 1]->Label() != result)) {
+                            index--;
+                        }
+
+                        if (index > 0) {
+                            _currentIndex = (index - 1);
+                        }
+                    }
+                }
+            }
+            void Finish()
+            {
                 ASSERT((_state == Commander::RUNNING) || (_state == Commander::ABORTING));
+
                 _state = IDLE;
+                _duration = Core::Time::Now().Ticks() - _begin;
 
+                // The schedule is kept until the next load, a step job might still be on its way out.
                 _sequenceList.Clear(0, _sequenceList.Count());
-
-                _adminLock.Unlock();
             }
 
         private:
@@ -434,6 +729,13 @@ namespace Plugin {
             string _name;
             PluginHost::IShell* _service;
             Core::ProxyList<Exchange::ICommand> _sequenceList;
+            std::vector<Schedule> _schedule;
+            std::list<Measurement> _timing;
+            uint32_t _running;
+            bool _executing;
+            bool _pending;
+            uint64_t _begin;
+            uint64_t _duration;
         };
 
         Commander(const Commander&) = delete;
@@ -36,6 +36,14 @@ namespace Plugin {
         _skipURL = static_cast<uint8_t>(service->WebPrefix().length());
 
         Core::NodeId dns(config.DNS.Value().c_str());
+
+        // The leases are kept per interface in the persistent path, if it can be created.
+        string storage(service->PersistentPath());
+        if (Core::Directory(storage.c_str()).CreatePath() == false) {
+            SYSLOG(Logging::Startup, (_T("Could not create %s, leases will not survive a restart"), storage.c_str()));
+            storage.clear();
+        }
+
         Core::JSON::ArrayType<Config::Server>::Iterator index(config.Servers.Elements());
 
         while (index.Next() == true) {
@@ -48,7 +56,8 @@ namespace Plugin {
                         index.Current().PoolStart.Value(),
                         index.Current().PoolSize.Value(),
                         index.Current().Router.Value(),
-                        dns));
+                        dns,
+                        (storage.empty() == true ? storage : storage + index.Current().Interface.Value() + _T(".leases"))));
             }
         }
 
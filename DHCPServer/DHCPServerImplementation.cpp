@@ -32,9 +32,7 @@ namespace Plugin {
                 uint32_t mask = (0xFFFFFFFF >> selectedNode.Mask());
                 uint32_t address = ntohl(_server);
 
-                _minAddress = ((address & (~mask)) + (_poolStart & mask));
-                _maxAddress = ((address & (~mask)) + ((_poolStart + _poolSize) & mask));
-                _nextFreeIp = _minAddress;
+                Pool(((address & (~mask)) + (_poolStart & mask)), ((address & (~mask)) + ((_poolStart + _poolSize) & mask)));
 
                 if (_router != static_cast<uint32_t>(~0)) {
                     if (_router == 0) {
@@ -51,8 +49,37 @@ namespace Plugin {
 
         return (result);
     }
+    void DHCPServerImplementation::Pool(const uint32_t minAddress, const uint32_t maxAddress)
+    {
+        _minAddress = minAddress;
+        _maxAddress = maxAddress;
+        _nextFreeIp = _minAddress;
+
+        _leases.Lock();
+
+        // Pick up the leases handed out before a restart, so the clients keep their address.
+        if ((_storage.empty() == false) && (_store.IsOpen() == false)) {
+            _store.Open(_storage, [this](const uint32_t leaseAddress, const uint64_t expiration, const uint8_t id[], const uint8_t length) {
+                Restore(leaseAddress, expiration, id, length);
+            });
+
+            if (_store.Records() > _leases.size()) {
+                _store.Compact(_leases);
+            }
+        }
+
+        _leases.Pool(_minAddress, _maxAddress);
+        _leases.Unlock();
+    }
     uint32_t DHCPServerImplementation::Close()
     {
+        PluginHost::WorkerPool::Instance().Revoke(_syncer);
+
+        _leases.Lock();
+        _syncScheduled = false;
+        _store.Sync();
+        _leases.Unlock();
+
         return (SocketDatagram::Close(Core::infinite));
     }
 
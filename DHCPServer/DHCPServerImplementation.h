@@ -2,6 +2,10 @@
 #define __DHCPSERVERIMPLEMENTATION_H__
 
 #include "Module.h"
+#include "LeaseStore.h"
+
+#include <queue>
+#include <unordered_map>
 
 namespace WPEFramework {
 
@@ -14,6 +18,7 @@ namespace Plugin {
         DHCPServerImplementation& operator=(const DHCPServerImplementation&) = delete;
 
         static constexpr uint32_t DefaultLeaseTime = 24; // hours
+        static constexpr uint32_t SyncInterval = 1000; // ms, changes to the lease store are synced in batches
 
         // RFC 2131 section 2
         enum operations {
@@ -414,14 +419,51 @@ namespace Plugin {
             uint32_t _preferred;
             classifications _classification;
         };
+        // The leases are kept in a list, so their location never changes, the list is indexed by
+        // address and by client identifier. The addresses of the pool that have a lease are marked
+        // in a bitmap, so a free address is found a word at a time. Every expiration time that is
+        // set is pushed on a min heap, an entry on the heap is only valid if the lease still has
+        // that expiration time, outdated entries are dropped once they reach the top.
         class LeaseList : public std::list<Lease> {
         private:
             LeaseList(const LeaseList&) = delete;
             LeaseList& operator=(const LeaseList&) = delete;
 
+            struct IdentifierHash {
+                size_t operator()(const Identifier* id) const
+                {
+                    // FNV-1a
+                    uint32_t hash = 2166136261;
+                    const uint8_t* data = id->Id();
+
+                    for (uint8_t index = 0; index < id->Length(); index++) {
+                        hash = (hash ^ data[index]) * 16777619;
+                    }
+
+                    return (hash);
+                }
+            };
+            struct IdentifierEqual {
+                bool operator()(const Identifier* lhs, const Identifier* rhs) const
+                {
+                    return (*lhs == *rhs);
+                }
+            };
+
+            using AddressMap = std::unordered_map<uint32_t, Lease*>;
+            using IdentifierMap = std::unordered_map<const Identifier*, Lease*, IdentifierHash, IdentifierEqual>;
+            using Expiry = std::pair<uint64_t, uint32_t>;
+            using ExpiryHeap = std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>>;
+
         public:
             LeaseList()
                 : std::list<Lease>()
+                , _addresses()
+                , _identifiers()
+                , _expiries()
+                , _occupied()
+                , _minAddress(0)
+                , _maxAddress(0)
             {
             }
             ~LeaseList()
@@ -446,8 +488,185 @@ namespace Plugin {
                 _adminLock.Unlock();
             }
 
+            // NOTE:
+            // All methods below need to be executed within the lock. The identifier and the expiration
+            // time of a lease should only be changed through this list, to keep the indexes up to date.
+            void Pool(const uint32_t minAddress, const uint32_t maxAddress)
+            {
+                ASSERT(minAddress <= maxAddress);
+
+                _minAddress = minAddress;
+                _maxAddress = maxAddress;
+                _occupied.assign(((maxAddress - minAddress) / 64) + 1, 0);
+
+                for (const Lease& lease : *this) {
+                    Occupy(lease.Raw());
+                }
+            }
+            inline Lease* Find(const uint32_t address)
+            {
+                AddressMap::iterator index(_addresses.find(address));
+
+                return (index != _addresses.end() ? index->second : nullptr);
+            }
+            inline Lease* Find(const Identifier& id)
+            {
+                IdentifierMap::iterator index(_identifiers.find(&id));
+
+                return (index != _identifiers.end() ? index->second : nullptr);
+            }
+            Lease* Create(const Identifier& id, const uint32_t address)
+            {
+                ASSERT(Find(address) == nullptr);
+
+                push_back(Lease(id, address));
+
+                Lease* result = &(back());
+
+                _addresses.emplace(address, result);
+                _identifiers.emplace(&(result->Id()), result);
+                _expiries.push(Expiry(result->Expiration(), address));
+                Occupy(address);
+
+                return (result);
+            }
+            void Update(Lease& lease, const Identifier& id)
+            {
+                IdentifierMap::iterator index(_identifiers.find(&(lease.Id())));
+
+                if ((index != _identifiers.end()) && (index->second == &lease)) {
+                    _identifiers.erase(index);
+                }
+
+                lease.Update(id);
+
+                _identifiers.emplace(&(lease.Id()), &lease);
+            }
+            void Expiration(Lease& lease, const uint64_t time)
+            {
+                lease.Expiration(time);
+
+                // Every renewal leaves an outdated entry behind, rebuild the heap before it grows out of bounds.
+                if (_expiries.size() >= ((size() + 16) * 4)) {
+                    ExpiryHeap rebuild;
+
+                    for (const Lease& entry : *this) {
+                        rebuild.push(Expiry(entry.Expiration(), entry.Raw()));
+                    }
+
+                    _expiries.swap(rebuild);
+                } else {
+                    _expiries.push(Expiry(time, lease.Raw()));
+                }
+            }
+            // Returns the lowest address, starting from the given one, of the pool without a lease, or
+            // 0 if all addresses from there on have one.
+            uint32_t Unallocated(const uint32_t from) const
+            {
+                uint32_t result = 0;
+
+                if ((from >= _minAddress) && (from <= _maxAddress)) {
+                    uint32_t offset = from - _minAddress;
+                    uint32_t word = offset / 64;
+                    uint64_t bits = ~_occupied[word] & (~static_cast<uint64_t>(0) << (offset % 64));
+
+                    while ((bits == 0) && (++word < _occupied.size())) {
+                        bits = ~_occupied[word];
+                    }
+
+                    if (bits != 0) {
+                        uint8_t bit = 0;
+
+                        while ((bits & (static_cast<uint64_t>(1) << bit)) == 0) {
+                            bit++;
+                        }
+
+                        offset = (word * 64) + bit;
+
+                        if (offset <= (_maxAddress - _minAddress)) {
+                            result = _minAddress + offset;
+                        }
+                    }
+                }
+
+                return (result);
+            }
+            // Returns the lease that expired the longest time ago, or nullptr if no lease has expired.
+            Lease* Expired()
+            {
+                Lease* result = nullptr;
+                const uint64_t now = Core::Time::Now().Ticks();
+
+                while ((result == nullptr) && (_expiries.empty() == false) && (_expiries.top().first < now)) {
+                    const Expiry& entry(_expiries.top());
+                    Lease* lease = Find(entry.second);
+
+                    if ((lease != nullptr) && (lease->Expiration() == entry.first) && (lease->Raw() >= _minAddress) && (lease->Raw() <= _maxAddress)) {
+                        result = lease;
+                    }
+
+                    _expiries.pop();
+                }
+
+                return (result);
+            }
+            // Checks the indexes, the bitmap and the heap against the leases, see test/LeaseReplay.cpp.
+            bool IsConsistent() const
+            {
+                bool result = (_addresses.size() == size()) && (_identifiers.size() <= size()) && (_expiries.size() <= ((size() + 16) * 4));
+                std::vector<uint64_t> occupied(_occupied.size(), 0);
+                std::vector<Expiry> expiries;
+                ExpiryHeap heap(_expiries);
+
+                expiries.reserve(heap.size());
+                while (heap.empty() == false) {
+                    expiries.push_back(heap.top());
+                    heap.pop();
+                }
+
+                for (const_iterator index(begin()); (result == true) && (index != end()); index++) {
+                    const Lease& lease(*index);
+                    AddressMap::const_iterator address(_addresses.find(lease.Raw()));
+                    IdentifierMap::const_iterator id(_identifiers.find(&(lease.Id())));
+
+                    // Leases sharing an identifier (cleared ones) are indexed once, by the first of them.
+                    result = (address != _addresses.end()) && (address->second == &lease) && (id != _identifiers.end()) && (id->second->Id() == lease.Id());
+
+                    if ((result == true) && (lease.Raw() >= _minAddress) && (lease.Raw() <= _maxAddress) && (occupied.empty() == false)) {
+                        const uint32_t offset = lease.Raw() - _minAddress;
+
+                        occupied[offset / 64] |= (static_cast<uint64_t>(1) << (offset % 64));
+
+                        // Entries are only dropped from the heap once they are outdated or handed out again.
+                        result = std::binary_search(expiries.begin(), expiries.end(), Expiry(lease.Expiration(), lease.Raw()));
+                    }
+                }
+
+                // A key should point to the identifier of the lease itself, it is not a copy.
+                for (IdentifierMap::const_iterator index(_identifiers.begin()); (result == true) && (index != _identifiers.end()); index++) {
+                    result = (index->first == &(index->second->Id()));
+                }
+
+                return ((result == true) && (occupied == _occupied));
+            }
+
+        private:
+            void Occupy(const uint32_t address)
+            {
+                if ((address >= _minAddress) && (address <= _maxAddress) && (_occupied.empty() == false)) {
+                    const uint32_t offset = address - _minAddress;
+                    _occupied[offset / 64] |= (static_cast<uint64_t>(1) << (offset % 64));
+                }
+            }
+
         private:
             mutable Core::CriticalSection _adminLock;
+            AddressMap _addresses;
+            IdentifierMap _identifiers;
+            ExpiryHeap _expiries;
+            std::vector<uint64_t> _occupied;
+            uint32_t _minAddress;
+            uint32_t _maxAddress;
         };
 
         class Response {
@@ -640,11 +859,40 @@ namespace Plugin {
             uint32_t _yiaddr;
         };
 
+        class Syncer : public Core::IDispatchType<void> {
+        private:
+            Syncer() = delete;
+            Syncer(const Syncer&) = delete;
+            Syncer& operator=(const Syncer&) = delete;
+
+        public:
+            Syncer(DHCPServerImplementation* parent)
+                : _parent(*parent)
+            {
+                ASSERT(parent != nullptr);
+            }
+            virtual ~Syncer()
+            {
+            }
+
+        public:
+            virtual void Dispatch() override
+            {
+                _parent.Sync();
+            }
+
+        private:
+            DHCPServerImplementation& _parent;
+        };
+
     public:
         typedef Core::LockableIteratorType<const LeaseList, const Lease&, LeaseList::const_iterator> Iterator;
 
     public:
-        DHCPServerImplementation(const string& serverName, const string& interfaceName, const uint32_t poolStart, const uint32_t poolSize, const uint32_t router, const Core::NodeId& DNS)
+#ifdef __WIN32__
+#pragma warning(disable : 4355)
+#endif
+        DHCPServerImplementation(const string& serverName, const string& interfaceName, const uint32_t poolStart, const uint32_t poolSize, const uint32_t router, const Core::NodeId& DNS, const string& storage)
             : Core::SocketDatagram(false, Core::NodeId("255.255.255.255", DefaultDHCPServerPort), Core::NodeId("255.255.255.255", DefaultDHCPClientPort), 1024, 16384)
             , _serverName(Core::ToString(serverName))
             , _interfaceName(interfaceName)
@@ -658,6 +906,11 @@ namespace Plugin {
             , _dns(~0)
             , _leases()
             , _responses()
+            , _storage(storage)
+            , _store()
+            , _syncer(Core::ProxyType<Syncer>::Create(this))
+            , _syncScheduled(false)
+            , _compactRequested(false)
         {
             static_assert(sizeof(uint32_t) == 4, "Incorrect architecture chosen. uint32_t must by 4 bytes");
 
@@ -665,8 +918,15 @@ namespace Plugin {
                 _dns = ntohl(static_cast<const Core::NodeId::SocketInfo&>(DNS).IPV4Socket.sin_addr.s_addr);
             }
         }
+#ifdef __WIN32__
+#pragma warning(default : 4355)
+#endif
         virtual ~DHCPServerImplementation()
         {
+            // The syncer is only scheduled while there is a store to sync.
+            if (_store.IsOpen() == true) {
+                PluginHost::WorkerPool::Instance().Revoke(_syncer);
+            }
         }
 
     public:
@@ -708,48 +968,35 @@ namespace Plugin {
         uint32_t Open();
         uint32_t Close();
 
-    private:
-        // NOTE:
-        // The next three methods, Find,Find and Create need to be executed within the lock.
-        inline Lease* Find(const uint32_t address)
+    protected:
+        // Sets the markers of the address pool, picks up the leases of a previous run and sizes the bitmap.
+        void Pool(const uint32_t minAddress, const uint32_t maxAddress);
+        inline bool IsConsistent() const
         {
-            LeaseList::iterator index(_leases.begin());
-            while ((index != _leases.end()) && (index->Raw() != address)) {
-                index++;
-            }
+            _leases.ReadLock();
+            bool result = _leases.IsConsistent();
+            _leases.ReadUnlock();
 
-            return (index != _leases.end() ? &(*index) : nullptr);
+            return (result);
         }
-        inline Lease* Find(const Identifier& id)
-        {
-            LeaseList::iterator index(_leases.begin());
-            while ((index != _leases.end()) && (index->Id() != id)) {
-                index++;
-            }
 
-            return (index != _leases.end() ? &(*index) : nullptr);
-        }
-        inline Lease* Create(const Identifier& id, const uint32_t address)
-        {
-            _leases.push_back(Lease(id, address));
-            return &(_leases.back());
-        }
+    private:
         void Discover(Response& response, const ScratchPad& scratchPad)
         {
             _leases.Lock();
-            Lease* result = Find(scratchPad.Id());
+            Lease* result = _leases.Find(scratchPad.Id());
 
             // RFC 2131 section 4.3.1
             if ((result == nullptr) && (scratchPad.RequestedIP() != 0)) {
                 // Make sure the preferred IP address is within the pool, otherwise offer a correct one anyway
                 if ((scratchPad.RequestedIP() >= _minAddress) && (scratchPad.RequestedIP() <= _maxAddress)) {
-                    result = Find(scratchPad.RequestedIP());
+                    result = _leases.Find(scratchPad.RequestedIP());
 
                     if (result == nullptr) {
                         // Ip address has not been taken yet, time to "assign" it to this client.
-                        result = Create(scratchPad.Id(), scratchPad.RequestedIP());
+                        result = _leases.Create(scratchPad.Id(), scratchPad.RequestedIP());
                     } else if (result->IsExpired() == true) {
-                        result->Update(scratchPad.Id());
+                        _leases.Update(*result, scratchPad.Id());
                     } else {
                         // IP address is taken
                         result = nullptr;
@@ -759,24 +1006,17 @@ namespace Plugin {
 
             if (result == nullptr) {
                 // First look in previously unallocated IP slots
-                uint32_t ip;
-                for (ip = _nextFreeIp; ip <= _maxAddress; ip++) {
-                    if (Find(ip) == nullptr) {
-                        result = Create(scratchPad.Id(), ip);
-                        _nextFreeIp = (ip + 1);
-                        break;
-                    }
-                }
+                uint32_t ip = _leases.Unallocated(_nextFreeIp);
 
-                if (result == nullptr) {
+                if (ip != 0) {
+                    result = _leases.Create(scratchPad.Id(), ip);
+                    _nextFreeIp = (ip + 1);
+                } else {
                     // Still not found a free IP slot, attempt picking up one of the expired ones
-                    for (ip = _minAddress; ip <= _maxAddress ; ip++) {
-                        Lease* lease = Find(ip);
-                        if ((lease != nullptr) && (lease->IsExpired() == true)) {
-                            result = lease;
-                            result->Update(scratchPad.Id());
-                            break;
-                        }
+                    result = _leases.Expired();
+
+                    if (result != nullptr) {
+                        _leases.Update(*result, scratchPad.Id());
                     }
                 }
             }
@@ -788,7 +1028,7 @@ namespace Plugin {
                     // Temporarily lock out the offered IP address until the client actually requests it
                     Core::Time timeout = Core::Time::Now();
                     timeout.Add(60 /* sec */ * 1000);
-                    result->Expiration(timeout.Ticks());
+                    _leases.Expiration(*result, timeout.Ticks());
                 }
 
                 response.Offer(result->Raw());
@@ -802,7 +1042,7 @@ namespace Plugin {
             _leases.Lock();
 
             // RFC 2131 section 4.3.2 Determine requested IP address
-            Lease* result = Find(scratchPad.Id());
+            Lease* result = _leases.Find(scratchPad.Id());
             uint32_t serverId = scratchPad.ServerIdentifier();
             uint32_t requested = scratchPad.RequestedIP();
             bool positive = ((serverId != 0) && (result != nullptr));
@@ -813,15 +1053,112 @@ namespace Plugin {
                 Core::Time leaseExp = Core::Time::Now();
                 leaseExp.Add(DefaultLeaseTime * (60 /* min */ * 60 * 1000));
                 response.LeaseTime(DefaultLeaseTime);
-                result->Expiration(leaseExp.Ticks());
+                _leases.Expiration(*result, leaseExp.Ticks());
+                Persist(*result);
             } else {
                 if (result != nullptr) {
-                    result->Expiration(0); // Invalidate
+                    _leases.Expiration(*result, 0); // Invalidate
+                    Persist(*result);
                 }
             }
 
             _leases.Unlock();
         }
+        void Release(const ScratchPad& scratchPad)
+        {
+            _leases.Lock();
+
+            // RFC 2131 section 4.3.4, the address can be handed out again.
+            Lease* result = _leases.Find(scratchPad.Id());
+
+            if ((result != nullptr) && (result->IsExpired() == false)) {
+                _leases.Expiration(*result, 0);
+                Persist(*result);
+            }
+
+            _leases.Unlock();
+        }
+        // NOTE:
+        // The next two methods need to be executed within the lock of the leases.
+        void Restore(const uint32_t address, const uint64_t expiration, const uint8_t id[], const uint8_t length)
+        {
+            const Identifier identifier(id, length);
+            Lease* result = _leases.Find(address);
+            Lease* previous = _leases.Find(identifier);
+
+            // The client moved to this address, its previous lease is no longer in use.
+            if ((previous != nullptr) && (previous != result)) {
+                _leases.Update(*previous, Identifier());
+                _leases.Expiration(*previous, 0);
+            }
+
+            if (result == nullptr) {
+                result = _leases.Create(identifier, address);
+            } else {
+                _leases.Update(*result, identifier);
+            }
+
+            _leases.Expiration(*result, expiration);
+        }
+        void Persist(const Lease& lease)
+        {
+            if (_store.IsOpen() == true) {
+                _store.Append(lease.Raw(), lease.Expiration(), lease.Id().Id(), lease.Id().Length());
+
+                // Most records are outdated by now, the next sync rewrites the store instead.
+                if ((_store.IsCompacting() == false) && (_store.Records() >= ((_leases.size() * 2) + 64))) {
+                    _compactRequested = true;
+                }
+
+                if (_syncScheduled == false) {
+                    Core::Time syncTime = Core::Time::Now();
+                    syncTime.Add(SyncInterval);
+
+                    _syncScheduled = true;
+                    PluginHost::WorkerPool::Instance().Schedule(syncTime, _syncer);
+                }
+            }
+        }
+        // Syncing and rewriting the store take a while, so they are done without holding the lock, a
+        // rewrite from a snapshot of the leases. Leases handed out meanwhile still get appended, see LeaseStore.
+        void Sync()
+        {
+            std::vector<Lease> snapshot;
+            int descriptor = -1;
+
+            _leases.Lock();
+
+            _syncScheduled = false;
+
+            bool compact = (_compactRequested == true) && (_store.Prepare() == true);
+
+            _compactRequested = false;
+
+            if (compact == true) {
+                snapshot.reserve(_leases.size());
+
+                // Leases can not be assigned, so they are copied in one by one.
+                for (const Lease& lease : _leases) {
+                    snapshot.push_back(lease);
+                }
+            } else {
+                descriptor = _store.Detach();
+            }
+
+            _leases.Unlock();
+
+            if (compact == true) {
+                bool rewritten = _store.Rewrite(snapshot);
+
+                _leases.Lock();
+                _store.Complete(rewritten);
+                _leases.Unlock();
+            } else if ((descriptor >= 0) && (_store.Sync(descriptor) == false)) {
+                _leases.Lock();
+                _store.Unsynced();
+                _leases.Unlock();
+            }
+        }
         void Submit(const Core::ProxyType<Response> entry)
         {
             _responses.push_back(entry);
@@ -830,6 +1167,8 @@ namespace Plugin {
                 SocketDatagram::Trigger();
             }
         }
+
+    protected:
         // Signal a state change, Opened, Closed or Accepted
         virtual void StateChange()
         {
@@ -888,9 +1227,10 @@ namespace Plugin {
                         Request(*response, scratchPad);
                         break;
                     case CLASSIFICATION_DECLINE:
-                        // Fall-through
+                        // UNSUPPORTED: Mark address as in use by an unknown party
+                        break;
                     case CLASSIFICATION_RELEASE:
-                        // UNSUPPORTED: Mark address as unused
+                        Release(scratchPad);
                         break;
                     case CLASSIFICATION_INFORM:
                         // Unsupported DHCP message type - fail silently
@@ -926,6 +1266,11 @@ namespace Plugin {
         uint32_t _dns;
         LeaseList _leases;
         std::list<Core::ProxyType<Response>> _responses;
+        const string _storage;
+        LeaseStore _store;
+        Core::ProxyType<Core::IDispatchType<void>> _syncer;
+        bool _syncScheduled;
+        bool _compactRequested;
 
         static Core::ProxyPoolType<Response> _responseFactory;
     };
@@ -0,0 +1,394 @@
+#ifndef __DHCPSERVER_LEASESTORE_H__
+#define __DHCPSERVER_LEASESTORE_H__
+
+#include "Module.h"
+
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Binary file holding the leases of a DHCP server, so the clients keep their address over a
+    // restart of the server. Every change of a lease is appended as a record:
+    //
+    //   crc32 (4) - address (4) - expiration (8) - identifier length (1) - identifier
+    //
+    // where the checksum covers everything after it and all values are stored little endian. The
+    // last record of an address is its current state. Appending does not sync, the owner decides
+    // when the records written so far go to disk with Sync(). To sync without holding its lock, the
+    // owner takes a Detach()ed descriptor with the lock taken and hands it to Sync() after. Once the file holds many outdated
+    // records it is rewritten with one record per lease, through a temporary file that is renamed
+    // over the original, so a crash leaves either the old or the new file.
+    //
+    // Rewriting is split up, so the owner only needs its lock for the short steps. Prepare() and
+    // Complete() must be called with the lock taken, like Append(), Rewrite() in between without it,
+    // with a snapshot of the leases taken at Prepare(). Records appended during the rewrite are kept
+    // aside and added to the new file by Complete().
+    //
+    // The store relies on POSIX file I/O, on Windows it never opens and leases are not persisted.
+    class LeaseStore {
+    private:
+        LeaseStore(const LeaseStore&) = delete;
+        LeaseStore& operator=(const LeaseStore&) = delete;
+
+        static constexpr uint32_t RecordHeaderSize = 4 + 4 + 8 + 1;
+
+    public:
+        LeaseStore()
+            : _fileName()
+            , _descriptor(-1)
+            , _records(0)
+            , _dirty(false)
+            , _compacting(false)
+            , _rewritten(-1)
+            , _rewrittenRecords(0)
+            , _pending()
+            , _pendingRecords(0)
+        {
+        }
+        ~LeaseStore()
+        {
+            Close();
+        }
+
+    public:
+        inline bool IsOpen() const
+        {
+            return (_descriptor >= 0);
+        }
+        inline uint32_t Records() const
+        {
+            return (_records);
+        }
+        inline bool IsDirty() const
+        {
+            return (_dirty);
+        }
+        inline bool IsCompacting() const
+        {
+            return (_compacting);
+        }
+        // Calls the handler for every valid record in the file, in the order they were written, and
+        // opens the file for appending. A torn record at the end of the file is cut off.
+        template <typename HANDLER>
+        bool Open(const string& fileName, HANDLER handler)
+        {
+            ASSERT(_descriptor < 0);
+
+            _fileName = fileName;
+            _records = 0;
+
+#ifdef __WIN32__
+            TRACE_L1("The lease store %s is not supported on this platform", _fileName.c_str());
+#else
+            _descriptor = ::open(_fileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+            if (_descriptor < 0) {
+                TRACE_L1("Could not open the lease store %s, error %d", _fileName.c_str(), errno);
+            } else {
+                std::vector<uint8_t> content;
+                uint8_t block[4096];
+                ssize_t size;
+
+                while ((size = ::read(_descriptor, block, sizeof(block))) > 0) {
+                    content.insert(content.end(), block, block + size);
+                }
+
+                uint32_t offset = 0;
+
+                while ((offset + RecordHeaderSize) <= content.size()) {
+                    const uint8_t* record = &(content[offset]);
+                    const uint32_t length = RecordHeaderSize + record[RecordHeaderSize - 1];
+                    uint32_t crc, address;
+                    uint64_t expiration;
+
+                    if ((offset + length) > content.size()) {
+                        break;
+                    }
+
+                    Load(record, crc);
+
+                    if (crc != CRC32(&(record[4]), length - 4)) {
+                        break;
+                    }
+
+                    Load(Load(&(record[4]), address), expiration);
+                    handler(address, expiration, &(record[RecordHeaderSize]), record[RecordHeaderSize - 1]);
+
+                    offset += length;
+                    _records++;
+                }
+
+                if (offset < content.size()) {
+                    TRACE_L1("Dropping %d bytes of incomplete records from the lease store %s", static_cast<uint32_t>(content.size() - offset), _fileName.c_str());
+                    if (::ftruncate(_descriptor, offset) != 0) {
+                        TRACE_L1("Could not truncate the lease store %s, error %d", _fileName.c_str(), errno);
+                    }
+                }
+
+                ::lseek(_descriptor, offset, SEEK_SET);
+            }
+#endif
+
+            return (_descriptor >= 0);
+        }
+        void Close()
+        {
+#ifndef __WIN32__
+            if (_descriptor >= 0) {
+                Sync();
+                ::close(_descriptor);
+                _descriptor = -1;
+            }
+#endif
+        }
+        bool Append(const uint32_t address, const uint64_t expiration, const uint8_t id[], const uint8_t length)
+        {
+            bool result = false;
+
+            if (_descriptor >= 0) {
+                uint8_t record[RecordHeaderSize + 255];
+
+                Serialize(record, address, expiration, id, length);
+
+                result = Write(_descriptor, record, RecordHeaderSize + length);
+                _dirty = true;
+                _records++;
+
+                if (_compacting == true) {
+                    _pending.insert(_pending.end(), record, record + RecordHeaderSize + length);
+                    _pendingRecords++;
+                }
+            }
+
+            return (result);
+        }
+        void Sync()
+        {
+#ifndef __WIN32__
+            if ((_descriptor >= 0) && (_dirty == true)) {
+                if (::fdatasync(_descriptor) != 0) {
+                    TRACE_L1("Could not sync the lease store %s, error %d", _fileName.c_str(), errno);
+                }
+                _dirty = false;
+            }
+#endif
+        }
+        // Returns a duplicate of the descriptor if there is something to sync, -1 otherwise. As a
+        // duplicate, it stays valid if the file is closed or replaced by a rewrite in the mean time.
+        int Detach()
+        {
+            int result = -1;
+
+#ifndef __WIN32__
+            if ((_descriptor >= 0) && (_dirty == true)) {
+                result = ::dup(_descriptor);
+                _dirty = (result < 0);
+            }
+#endif
+
+            return (result);
+        }
+        // Syncs and closes a descriptor handed out by Detach(), should be called without the lock.
+        bool Sync(const int descriptor) const
+        {
+            bool result = false;
+
+#ifndef __WIN32__
+            ASSERT(descriptor >= 0);
+
+            result = (::fdatasync(descriptor) == 0);
+
+            if (result == false) {
+                TRACE_L1("Could not sync the lease store %s, error %d", _fileName.c_str(), errno);
+            }
+
+            ::close(descriptor);
+#endif
+
+            return (result);
+        }
+        // A sync of a Detach()ed descriptor failed, the records are not on disk yet.
+        inline void Unsynced()
+        {
+            _dirty = true;
+        }
+        // Rewrites the file with one record per lease in one go, for when there is no one to block.
+        template <typename LEASES>
+        bool Compact(const LEASES& leases)
+        {
+            bool result = false;
+
+            if (Prepare() == true) {
+                result = Complete(Rewrite(leases));
+            }
+
+            return (result);
+        }
+        bool Prepare()
+        {
+            ASSERT(_compacting == false);
+
+            _compacting = (_descriptor >= 0);
+            _pending.clear();
+            _pendingRecords = 0;
+
+            return (_compacting);
+        }
+        // Writes and syncs one record per lease to the temporary file, a lease must offer Raw(),
+        // Expiration() and Id(). Only touches the temporary file, so no lock is needed.
+        template <typename LEASES>
+        bool Rewrite(const LEASES& leases)
+        {
+            bool result = false;
+
+            ASSERT((_compacting == true) && (_rewritten < 0));
+
+#ifndef __WIN32__
+            const string tempName(_fileName + _T(".tmp"));
+
+            _rewritten = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            _rewrittenRecords = 0;
+
+            if (_rewritten < 0) {
+                TRACE_L1("Could not create the lease store %s, error %d", tempName.c_str(), errno);
+            } else {
+                uint8_t record[RecordHeaderSize + 255];
+
+                result = true;
+
+                typename LEASES::const_iterator index(leases.begin());
+
+                while ((result == true) && (index != leases.end())) {
+                    Serialize(record, index->Raw(), index->Expiration(), index->Id().Id(), index->Id().Length());
+                    result = Write(_rewritten, record, RecordHeaderSize + index->Id().Length());
+                    _rewrittenRecords++;
+                    index++;
+                }
+
+                result = (result == true) && (::fsync(_rewritten) == 0);
+            }
+#endif
+
+            return (result);
+        }
+        // Adds the records appended since Prepare() to the rewritten file and puts it in place of
+        // the current one. Those records are synced with the next Sync(), like any appended record.
+        bool Complete(const bool rewritten)
+        {
+            bool result = false;
+
+            ASSERT(_compacting == true);
+
+#ifndef __WIN32__
+            if (_rewritten >= 0) {
+                const string tempName(_fileName + _T(".tmp"));
+
+                result = (rewritten == true) && ((_pending.empty() == true) || (Write(_rewritten, _pending.data(), static_cast<uint32_t>(_pending.size())) == true));
+
+                if ((result == true) && (::rename(tempName.c_str(), _fileName.c_str()) == 0)) {
+                    ::close(_descriptor);
+                    _descriptor = _rewritten;
+                    _records = _rewrittenRecords + _pendingRecords;
+                    _dirty = (_pending.empty() == false);
+                } else {
+                    TRACE_L1("Could not rewrite the lease store %s, error %d", _fileName.c_str(), errno);
+                    ::close(_rewritten);
+                    ::unlink(tempName.c_str());
+                    result = false;
+                }
+
+                _rewritten = -1;
+            }
+#endif
+
+            _compacting = false;
+            _pending.clear();
+            _pendingRecords = 0;
+
+            return (result);
+        }
+
+    private:
+        static void Serialize(uint8_t record[], const uint32_t address, const uint64_t expiration, const uint8_t id[], const uint8_t length)
+        {
+            Store(Store(&(record[4]), address), expiration);
+            record[RecordHeaderSize - 1] = length;
+            ::memcpy(&(record[RecordHeaderSize]), id, length);
+            Store(record, CRC32(&(record[4]), RecordHeaderSize - 4 + length));
+        }
+        bool Write(const int descriptor, const uint8_t buffer[], const uint32_t length) const
+        {
+            uint32_t written = 0;
+
+#ifndef __WIN32__
+            while (written < length) {
+                ssize_t result = ::write(descriptor, &(buffer[written]), length - written);
+
+                if (result > 0) {
+                    written += static_cast<uint32_t>(result);
+                } else if ((result < 0) && (errno != EINTR)) {
+                    TRACE_L1("Could not write to the lease store %s, error %d", _fileName.c_str(), errno);
+                    break;
+                }
+            }
+#endif
+
+            return (written == length);
+        }
+        static uint32_t CRC32(const uint8_t buffer[], const uint32_t length)
+        {
+            uint32_t crc = 0xFFFFFFFF;
+
+            for (uint32_t index = 0; index < length; index++) {
+                crc ^= buffer[index];
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+                }
+            }
+
+            return (~crc);
+        }
+        static uint8_t* Store(uint8_t* buffer, const uint32_t value)
+        {
+            buffer[0] = static_cast<uint8_t>(value & 0xFF);
+            buffer[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+            buffer[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+            buffer[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
+            return (buffer + 4);
+        }
+        static uint8_t* Store(uint8_t* buffer, const uint64_t value)
+        {
+            return (Store(Store(buffer, static_cast<uint32_t>(value & 0xFFFFFFFF)), static_cast<uint32_t>(value >> 32)));
+        }
+        static const uint8_t* Load(const uint8_t* buffer, uint32_t& value)
+        {
+            value = static_cast<uint32_t>(buffer[0]) | (static_cast<uint32_t>(buffer[1]) << 8) | (static_cast<uint32_t>(buffer[2]) << 16) | (static_cast<uint32_t>(buffer[3]) << 24);
+            return (buffer + 4);
+        }
+        static const uint8_t* Load(const uint8_t* buffer, uint64_t& value)
+        {
+            uint32_t low, high;
+            buffer = Load(Load(buffer, low), high);
+            value = (static_cast<uint64_t>(high) << 32) | low;
+            return (buffer);
+        }
+
+    private:
+        string _fileName;
+        int _descriptor;
+        uint32_t _records;
+        bool _dirty;
+        bool _compacting;
+        int _rewritten;
+        uint32_t _rewrittenRecords;
+        std::vector<uint8_t> _pending;
+        uint32_t _pendingRecords;
+    };
+}
+}
+
+#endif // __DHCPSERVER_LEASESTORE_H__
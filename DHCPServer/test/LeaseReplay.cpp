@@ -0,0 +1,286 @@
+// Replays a mass reboot against the lease administration of the DHCPServer plugin: a thousand clients
+// DISCOVER at once, and REQUEST the address they are offered once all offers are out. After every
+// phase the indexes, the free address bitmap and the expiry heap are checked against the leases.
+//
+//     LeaseReplay [clients]
+//
+// The requests are fed to the server as frames, like they arrive from its socket, but no socket is
+// opened, so it runs without privileges. Returns 0 if all checks pass.
+
+#include "DHCPServerImplementation.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace WPEFramework;
+
+namespace {
+
+constexpr uint32_t PoolStart = 0xC0A80000; // 192.168.0.0
+constexpr uint32_t ServerAddress = 0xC0A803FE;
+
+constexpr uint16_t FrameSize = 576;
+constexpr uint16_t OptionsOffset = 240; // BOOTP header and magic cookie, RFC 2131 section 3
+
+class Server : public Plugin::DHCPServerImplementation {
+public:
+    Server(const uint32_t poolSize)
+        : Plugin::DHCPServerImplementation(_T("replay"), _T("replay0"), 0, poolSize, 0, Core::NodeId(), string())
+    {
+        Pool(PoolStart, PoolStart + poolSize);
+    }
+    ~Server() override
+    {
+    }
+
+public:
+    using Plugin::DHCPServerImplementation::IsConsistent;
+
+    // Hands the frame to the server and returns the message type of the reply, 0 if there is none.
+    uint8_t Exchange(uint8_t frame[], const uint16_t length, uint32_t& address)
+    {
+        uint8_t reply[FrameSize];
+        uint8_t result = 0;
+
+        ReceiveData(frame, length);
+
+        if (SendData(reply, sizeof(reply)) > OptionsOffset) {
+            address = (reply[16] << 24) | (reply[17] << 16) | (reply[18] << 8) | reply[19];
+            result = reply[OptionsOffset + 2];
+        }
+
+        return (result);
+    }
+};
+
+class Client {
+public:
+    Client(const uint32_t id)
+        : _id(id)
+        , _xid(0)
+        , _address(0)
+    {
+    }
+
+public:
+    inline uint32_t Address() const
+    {
+        return (_address);
+    }
+    uint8_t Discover(Server& server)
+    {
+        uint8_t frame[FrameSize];
+        uint16_t length = Frame(frame, 1);
+
+        frame[length++] = 255;
+
+        return (server.Exchange(frame, length, _address));
+    }
+    uint8_t Request(Server& server)
+    {
+        uint8_t frame[FrameSize];
+        uint16_t length = Frame(frame, 3);
+
+        length = Option(frame, length, 50, _address);
+        length = Option(frame, length, 54, ServerAddress);
+        frame[length++] = 255;
+
+        uint32_t acknowledged = 0;
+        uint8_t result = server.Exchange(frame, length, acknowledged);
+
+        if ((result == 5) && (acknowledged != _address)) {
+            result = 0;
+        }
+
+        return (result);
+    }
+    void Release(Server& server)
+    {
+        uint8_t frame[FrameSize];
+        uint16_t length = Frame(frame, 7);
+        uint32_t address;
+
+        frame[length++] = 255;
+        server.Exchange(frame, length, address);
+        _address = 0;
+    }
+
+private:
+    uint16_t Frame(uint8_t frame[], const uint8_t type)
+    {
+        ::memset(frame, 0, FrameSize);
+
+        frame[0] = 1; // BOOTREQUEST
+        frame[1] = 1; // Ethernet
+        frame[2] = 6;
+        frame[4] = static_cast<uint8_t>(++_xid);
+
+        // Locally administered MAC address, the client identifier is derived from it.
+        frame[28] = 0x02;
+        frame[29] = 0x00;
+        frame[30] = static_cast<uint8_t>(_id >> 24);
+        frame[31] = static_cast<uint8_t>(_id >> 16);
+        frame[32] = static_cast<uint8_t>(_id >> 8);
+        frame[33] = static_cast<uint8_t>(_id);
+
+        frame[236] = 99;
+        frame[237] = 130;
+        frame[238] = 83;
+        frame[239] = 99;
+
+        frame[OptionsOffset] = 53;
+        frame[OptionsOffset + 1] = 1;
+        frame[OptionsOffset + 2] = type;
+
+        return (OptionsOffset + 3);
+    }
+    uint16_t Option(uint8_t frame[], uint16_t length, const uint8_t option, const uint32_t value)
+    {
+        frame[length++] = option;
+        frame[length++] = 4;
+        frame[length++] = static_cast<uint8_t>(value >> 24);
+        frame[length++] = static_cast<uint8_t>(value >> 16);
+        frame[length++] = static_cast<uint8_t>(value >> 8);
+        frame[length++] = static_cast<uint8_t>(value);
+
+        return (length);
+    }
+
+private:
+    const uint32_t _id;
+    uint32_t _xid;
+    uint32_t _address;
+};
+
+uint32_t _failures = 0;
+
+void Check(const bool condition, const char description[])
+{
+    printf("%s: %s\n", (condition == true ? "PASS" : "FAIL"), description);
+
+    if (condition == false) {
+        _failures++;
+    }
+}
+
+// All clients DISCOVER before any of them REQUESTs, in a random order. Returns the number of clients
+// that got an address acknowledged.
+uint32_t Boot(Server& server, std::vector<Client*>& clients, std::mt19937& random)
+{
+    std::vector<Client*> offered;
+    uint32_t acknowledged = 0;
+
+    std::shuffle(clients.begin(), clients.end(), random);
+
+    const uint64_t start = Core::Time::Now().Ticks();
+
+    for (Client* client : clients) {
+        if (client->Discover(server) == 2) {
+            offered.push_back(client);
+        }
+    }
+
+    std::shuffle(offered.begin(), offered.end(), random);
+
+    for (Client* client : offered) {
+        if (client->Request(server) == 5) {
+            acknowledged++;
+        }
+    }
+
+    const uint64_t duration = Core::Time::Now().Ticks() - start;
+
+    printf("      %u clients, %u offered, %u acknowledged in %llu us (%.1f us per exchange)\n",
+        static_cast<uint32_t>(clients.size()), static_cast<uint32_t>(offered.size()), acknowledged,
+        static_cast<unsigned long long>(duration), static_cast<double>(duration) / std::max(clients.size(), static_cast<size_t>(1)));
+
+    return (acknowledged);
+}
+
+bool Distinct(const std::vector<Client>& clients)
+{
+    std::set<uint32_t> addresses;
+    bool result = true;
+
+    for (const Client& client : clients) {
+        if (client.Address() != 0) {
+            result = result && (client.Address() >= PoolStart) && (addresses.insert(client.Address()).second == true);
+        }
+    }
+
+    return (result);
+}
+
+void Replay(const uint32_t count)
+{
+    // A pool a little larger than the number of clients, the first newcomers still find unallocated
+    // addresses, the rest get the ones released.
+    const uint32_t poolSize = count + (count / 32);
+    const uint32_t leaving = (count * 3) / 10;
+
+    std::mt19937 random(1);
+    std::vector<Client> clients;
+    std::vector<Client*> booting;
+    Server server(poolSize);
+
+    clients.reserve(count + leaving + 64);
+
+    for (uint32_t index = 0; index < count; index++) {
+        clients.emplace_back(index + 1);
+        booting.push_back(&clients.back());
+    }
+
+    printf("Mass reboot\n");
+    Check(Boot(server, booting, random) == count, "every client gets an address");
+    Check(Distinct(clients) == true, "no address is handed out twice");
+    Check(server.IsConsistent() == true, "indexes, bitmap and heap are consistent");
+
+    printf("Renewals\n");
+    uint32_t renewed = 0;
+    for (uint8_t round = 0; round < 8; round++) {
+        for (Client& client : clients) {
+            renewed += (client.Request(server) == 5 ? 1 : 0);
+        }
+    }
+    Check(renewed == (count * 8), "every renewal is acknowledged with the same address");
+    Check(server.IsConsistent() == true, "the heap stays bounded while renewing");
+
+    printf("Leaving and joining clients\n");
+    booting.clear();
+    for (uint32_t index = 0; index < leaving; index++) {
+        clients[index * 3].Release(server);
+    }
+    for (uint32_t index = 0; index < leaving; index++) {
+        clients.emplace_back(count + index + 1);
+        booting.push_back(&clients.back());
+    }
+    Check(server.IsConsistent() == true, "indexes, bitmap and heap are consistent after releases");
+    Check(Boot(server, booting, random) == leaving, "released addresses are handed out again");
+    Check(Distinct(clients) == true, "no address is handed out twice");
+    Check(server.IsConsistent() == true, "indexes, bitmap and heap are consistent");
+
+    printf("Exhausted pool\n");
+    booting.clear();
+    for (uint32_t index = 0; index < 64; index++) {
+        clients.emplace_back(count + leaving + index + 1);
+        booting.push_back(&clients.back());
+    }
+    const uint32_t left = poolSize + 1 - count;
+    Check(Boot(server, booting, random) == std::min(left, 64u), "only the addresses left are handed out");
+    Check(Distinct(clients) == true, "no address is handed out twice");
+    Check(server.IsConsistent() == true, "indexes, bitmap and heap are consistent");
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Replay(argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 1000);
+
+    Core::Singleton::Dispose();
+
+    printf("%u check(s) failed\n", _failures);
+
+    return (_failures == 0 ? 0 : 1);
+}
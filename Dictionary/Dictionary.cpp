@@ -27,7 +27,7 @@ namespace Plugin {
         bool correctStructure(true);
         Core::JSON::ArrayType<NameSpace::Entry>::ConstIterator keyIndex(current.Dictionary.Elements());
         Core::JSON::ArrayType<NameSpace>::ConstIterator spaceIndex(current.Spaces.Elements());
-        std::list<RuntimeEntry>* currentList = NULL;
+        KeyTable* currentList = NULL;
 
         // Fill in the keys from this name space...
         while ((correctStructure == true) && (keyIndex.Next() == true)) {
@@ -42,7 +42,13 @@ namespace Plugin {
                     ASSERT(currentList != NULL);
                 }
 
-                currentList->push_back(RuntimeEntry(key, keyIndex.Current().Value.Value(), keyIndex.Current().Type.Value()));
+                RuntimeEntry* entry(currentList->Find(key));
+
+                if (entry == nullptr) {
+                    currentList->Insert(RuntimeEntry(key, keyIndex.Current().Value.Value(), keyIndex.Current().Type.Value()));
+                } else {
+                    *entry = RuntimeEntry(key, keyIndex.Current().Value.Value(), keyIndex.Current().Type.Value());
+                }
             }
         }
 
@@ -67,7 +73,8 @@ namespace Plugin {
                 NameSpace& blockToFill(current[index->first]);
 
                 // No we got the namespace bloc, fill in the keys..
-                const std::list<RuntimeEntry>& keyList(index->second);
+                std::list<RuntimeEntry> keyList;
+                index->second.Entries(keyList);
                 std::list<RuntimeEntry>::const_iterator keyIndex(keyList.begin());
 
                 while (keyIndex != keyList.end()) {
@@ -86,11 +93,121 @@ namespace Plugin {
         }
     }
 
+    // Stores the value without journaling it or notifying anyone, used to restore the journal.
+    bool Dictionary::Store(const string& nameSpace, const string& key, const string& value, const enumType type)
+    {
+        bool result = false;
+
+        if ((IsValidName(key) == true) && ((nameSpace.empty() == true) || (nameSpace[0] == NameSpaceDelimiter))) {
+            KeyTable& container(_dictionary[nameSpace]);
+            RuntimeEntry* entry(container.Find(key));
+
+            if (entry == nullptr) {
+                container.Insert(RuntimeEntry(key, value, type));
+            } else {
+                entry->Value(value);
+                entry->Type(type);
+            }
+            result = true;
+        }
+
+        return (result);
+    }
+
+    // Replaces the storage file, through a temporary file, so a crash never leaves a partial file behind.
+    bool Dictionary::WriteStorage(const string& content)
+    {
+        bool result = false;
+
+#ifdef __WIN32__
+        // No atomic replace here, the file is rewritten in place.
+        Core::File dictionaryFile(_storage);
+
+        if (dictionaryFile.Create() == true) {
+            result = (dictionaryFile.Write(reinterpret_cast<const uint8_t*>(content.c_str()), static_cast<uint32_t>(content.length())) == content.length());
+            dictionaryFile.Close();
+        }
+#else
+        const string fileName(_storage + _T(".tmp"));
+        int descriptor = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+        if (descriptor < 0) {
+            TRACE_L1("Could not create the dictionary storage %s, error %d", fileName.c_str(), errno);
+        } else {
+            size_t written = 0;
+
+            while (written < content.length()) {
+                ssize_t size = ::write(descriptor, &(content[written]), content.length() - written);
+
+                if (size > 0) {
+                    written += static_cast<size_t>(size);
+                } else if ((size < 0) && (errno != EINTR)) {
+                    break;
+                }
+            }
+
+            result = ((written == content.length()) && (::fsync(descriptor) == 0));
+            _syncs++;
+
+            ::close(descriptor);
+
+            if ((result == false) || (::rename(fileName.c_str(), _storage.c_str()) != 0)) {
+                TRACE_L1("Could not write the dictionary storage %s, error %d", _storage.c_str(), errno);
+                ::unlink(fileName.c_str());
+                result = false;
+            }
+        }
+#endif
+
+        return (result);
+    }
+
+    // Folds the journal into the storage file. The journal is moved aside, under the lock, together
+    // with taking the snapshot, so modifications made while the storage file is written end up in
+    // the new journal. The old journal is only removed once the new storage file is in place.
+    void Dictionary::Compact()
+    {
+        const string journal(_storage + _T(".journal"));
+        const string previous(journal + _T(".old"));
+        NameSpace dictionary;
+        string content;
+
+        _adminLock.WriteLock();
+
+        if (_stopping == true) {
+            _compacting = false;
+            _adminLock.Unlock();
+            return;
+        }
+
+        CreateExternalDictionary(EMPTY_STRING, dictionary);
+        dictionary.ToString(content);
+
+        _journal.Close();
+        ::rename(journal.c_str(), previous.c_str());
+        _journal.Open(journal);
+
+        _adminLock.Unlock();
+
+        if (WriteStorage(content) == true) {
+            ::unlink(previous.c_str());
+        }
+
+        _adminLock.WriteLock();
+        _compactions++;
+        _compacting = false;
+        _adminLock.Unlock();
+    }
+
     /* virtual */ const string Dictionary::Initialize(PluginHost::IShell* service)
     {
+        const uint64_t start = Core::Time::Now().Ticks();
+
         _config.FromString(service->ConfigLine());
 
-        Core::File dictionaryFile(service->PersistentPath() + _config.Storage.Value());
+        _storage = service->PersistentPath() + _config.Storage.Value();
+
+        Core::File dictionaryFile(_storage);
 
         if (dictionaryFile.Open(true) == true) {
             NameSpace dictionary;
@@ -98,28 +215,92 @@ namespace Plugin {
             CreateInternalDictionary(EMPTY_STRING, dictionary);
         }
 
+        // Apply the modifications made since the storage file was written. If a compaction got
+        // interrupted, the old journal is still there and holds the older modifications.
+        const string journal(_storage + _T(".journal"));
+        const string previous(journal + _T(".old"));
+        // A record of a key that is no longer persistent means it should not survive a restart.
+        auto restore = [this](const uint8_t type, const string& nameSpace, const string& key, const string& value) {
+            if (static_cast<enumType>(type) == PERSISTENT) {
+                Store(nameSpace, key, value, PERSISTENT);
+            } else {
+                DictionaryMap::iterator index(_dictionary.find(nameSpace));
+
+                if (index != _dictionary.end()) {
+                    index->second.Remove(key);
+                }
+            }
+        };
+
+        _replayed = Journal::Replay(previous, restore) + Journal::Replay(journal, restore);
+
+        if (Core::File(previous).Exists() == true) {
+            NameSpace dictionary;
+            string content;
+
+            CreateExternalDictionary(EMPTY_STRING, dictionary);
+            dictionary.ToString(content);
+
+            if (WriteStorage(content) == true) {
+                ::unlink(previous.c_str());
+                ::unlink(journal.c_str());
+                _compactions++;
+            }
+        }
+
+        _journal.Open(journal);
+
         _skipURL = static_cast<uint8_t>(service->WebPrefix().length());
 
+        _startup = Core::Time::Now().Ticks() - start;
+
         // On succes return a name as a Callsign to be used in the URL, after the "service"prefix
         return (_T(""));
     }
 
     /* virtual */ void Dictionary::Deinitialize(PluginHost::IShell* service)
     {
+        _adminLock.WriteLock();
+        _stopping = true;
+        _adminLock.Unlock();
 
-        Core::File dictionaryFile(service->PersistentPath() + _config.Storage.Value());
+        // A compaction that is running is waited for, it uses the journal closed below.
+        PluginHost::WorkerPool::Instance().Revoke(_compactor, Core::infinite);
 
-        if (dictionaryFile.Open(true) == true) {
-            NameSpace dictionary;
-            CreateExternalDictionary(EMPTY_STRING, dictionary);
-            dictionary.ToFile(dictionaryFile);
+        NameSpace dictionary;
+        string content;
+
+        CreateExternalDictionary(EMPTY_STRING, dictionary);
+        dictionary.ToString(content);
+
+        // Once the storage file holds everything, the journal has no more value.
+        if (WriteStorage(content) == true) {
+            _journal.Close();
+            ::unlink((_storage + _T(".journal")).c_str());
+        } else {
+            _journal.Close();
         }
     }
 
     /* virtual */ string Dictionary::Information() const
     {
-        // No additional info to report.
-        return (string());
+        Metrics metrics;
+        string result;
+
+        _adminLock.ReadLock();
+
+        metrics.Startup = _startup;
+        metrics.Replayed = _replayed;
+        metrics.JournalSize = _journal.Size();
+        metrics.Syncs = _syncs + _journal.Syncs();
+        metrics.Failures = _journal.Failures();
+        metrics.Compactions = _compactions;
+
+        _adminLock.Unlock();
+
+        metrics.ToString(result);
+
+        return (result);
     }
 
     /* virtual */ void Dictionary::Inbound(Web::Request& request)
@@ -167,6 +348,7 @@ namespace Plugin {
             result->Message = _T("OK");
         } else if ((request.Verb == Web::Request::HTTP_POST) && (key.empty() == false) && (request.HasBody() == true)) {
             Dictionary::enumType keyType(Dictionary::enumType::VOLATILE);
+            bool typed = false;
             Core::ProxyType<const Web::TextBody> valueBody(request.Body<Web::TextBody>());
             const string value(valueBody.IsValid() == true ? string(*valueBody) : string());
             Core::TextSegmentIterator typeIterator(Core::TextSegmentIterator(Core::TextFragment(request.Query), true, '='));
@@ -174,10 +356,11 @@ namespace Plugin {
             if ((typeIterator.Next() == true) && (typeIterator.Current() == _T("Type")) && (typeIterator.Next() == true)) {
                 // Seems we have a type specifier
                 keyType = Core::EnumerateType<Dictionary::enumType>(typeIterator.Current(), false).Value();
+                typed = true;
             }
 
             TRACE(Trace::Information, (_T("SetKey ( %s, %s, %s)"), key.c_str(), value.c_str(), Core::EnumerateType<Dictionary::enumType>(keyType).Data()));
-            Set(nameSpace, key, value);
+            Set(nameSpace, key, value, (typed == true ? &keyType : nullptr));
 
             result->ErrorCode = Web::STATUS_OK;
             result->Message = _T("OK");
@@ -193,21 +376,16 @@ namespace Plugin {
     {
         bool result = false;
 
-        _adminLock.Lock();
+        _adminLock.ReadLock();
 
         DictionaryMap::const_iterator index(_dictionary.find(nameSpace));
 
         if (index != _dictionary.end()) {
-            const std::list<RuntimeEntry>& container(index->second);
-            std::list<RuntimeEntry>::const_iterator listIndex(container.begin());
-
-            while ((listIndex != container.end()) && (listIndex->Key() != key)) {
-                listIndex++;
-            }
+            const RuntimeEntry* entry(index->second.Find(key));
 
-            if (listIndex != container.end()) {
+            if (entry != nullptr) {
                 result = true;
-                value = listIndex->Value();
+                value = entry->Value();
             }
         }
 
@@ -223,14 +401,14 @@ namespace Plugin {
 
         Exchange::IDictionary::IIterator* result = nullptr;
 
-        _adminLock.Lock();
+        _adminLock.ReadLock();
 
         DictionaryMap::const_iterator index(_dictionary.find(nameSpace));
 
         if (index != _dictionary.end()) {
             Core::ProxyType<Iterator> entries(iterators.Element());
 
-            entries->Load(InternalIterator(index->second));
+            entries->Load(index->second);
 
             result = &(*entries);
             result->AddRef();
@@ -246,79 +424,115 @@ namespace Plugin {
     /* virtual */ bool Dictionary::Set(const string& nameSpace, const string& key, const string& value)
     {
         // Direct method to Set a value for a key in a certain namespace from the dictionary.
+        return (Set(nameSpace, key, value, nullptr));
+    }
+
+    // If no type is given, an existing key keeps its type and a new key is VOLATILE.
+    bool Dictionary::Set(const string& nameSpace, const string& key, const string& value, const enumType* type)
+    {
         bool result = false;
+        bool persistent = false;
+        bool journaled = false;
 
-        _adminLock.Lock();
+        _adminLock.WriteLock();
 
-        std::list<RuntimeEntry>& container(_dictionary[nameSpace]);
-        std::list<RuntimeEntry>::iterator listIndex(container.begin());
+        KeyTable& container(_dictionary[nameSpace]);
+        RuntimeEntry* entry(container.Find(key));
 
-        while ((listIndex != container.end()) && (listIndex->Key() != key)) {
-            listIndex++;
+        if (entry == nullptr) {
+            result = true;
+            container.Insert(RuntimeEntry(key, value, (type != nullptr ? *type : VOLATILE)));
+            persistent = ((type != nullptr) && (*type == PERSISTENT));
+        } else {
+            // Journal a change of type away from persistent as well, otherwise a replay would
+            // restore the key as persistent.
+            persistent = (entry->Type() == PERSISTENT) || ((type != nullptr) && (*type == PERSISTENT));
+
+            if ((type != nullptr) && (entry->Type() != *type)) {
+                entry->Type(*type);
+                result = true;
+            }
+            if (entry->Value() != value) {
+                entry->Value(value);
+                result = true;
+            }
         }
 
-        if (listIndex == container.end()) {
-            result = true;
-            container.push_back(RuntimeEntry(key, value, VOLATILE));
-        } else if (listIndex->Value() != value) {
-            result = true;
-            listIndex->Value(value);
+        if ((result == true) && (persistent == true)) {
+            journaled = _journal.Append(static_cast<uint8_t>(type != nullptr ? *type : container.Find(key)->Type()), nameSpace, key, value);
+
+            if ((_compacting == false) && (_stopping == false) && (_journal.Size() >= (static_cast<uint32_t>(_config.JournalSize.Value()) * 1024))) {
+                _compacting = true;
+                PluginHost::WorkerPool::Instance().Submit(_compactor);
+            }
         }
 
+        std::list<struct Exchange::IDictionary::INotification*> sinks;
+
         if (result == true) {
-            ObserverMap::iterator index(_observers.begin());
+            ObserverMap::iterator index(_observers.find(nameSpace));
 
-            // Right, we updated send out the modification !!!
-            while (index != _observers.end()) {
-                if (index->first == nameSpace) {
-                    index->second->Modified(nameSpace, key, value);
+            if (index != _observers.end()) {
+                sinks = index->second;
+
+                std::list<struct Exchange::IDictionary::INotification*>::iterator sink(sinks.begin());
+
+                while (sink != sinks.end()) {
+                    (*sink)->AddRef();
+                    sink++;
                 }
-                index++;
             }
         }
 
         _adminLock.Unlock();
 
+        // The record is synced to disk before the modification is reported.
+        if ((journaled == true) && (_journal.Sync() == false)) {
+            TRACE(Trace::Error, (_T("Modification of %s in %s acknowledged before it was synced to disk"), key.c_str(), nameSpace.c_str()));
+        }
+
+        // Right, we updated send out the modification !!! This is done without holding the lock, as
+        // the lock is not reentrant and a sink is likely to read from the dictionary again.
+        std::list<struct Exchange::IDictionary::INotification*>::iterator sink(sinks.begin());
+
+        while (sink != sinks.end()) {
+            (*sink)->Modified(nameSpace, key, value);
+            (*sink)->Release();
+            sink++;
+        }
+
         return (result);
     }
 
     /* virtual */ void Dictionary::Register(const string& nameSpace, struct Exchange::IDictionary::INotification* sink)
     {
-        _adminLock.Lock();
+        _adminLock.WriteLock();
 
-#ifdef __DEBUG__
-        ObserverMap::iterator index(_observers.begin());
+        std::list<struct Exchange::IDictionary::INotification*>& sinks(_observers[nameSpace]);
 
         // DO NOT REGISTER THE SAME NOTIFICATION SINK ON THE SAME NAMESPACE MORE THAN ONCE. !!!!!!
-        while (index != _observers.end()) {
-            ASSERT((index->second != sink) || (nameSpace != index->first));
+        ASSERT(std::find(sinks.begin(), sinks.end(), sink) == sinks.end());
 
-            index++;
-        }
-#endif
-
-        _observers.push_back(std::pair<string, struct Exchange::IDictionary::INotification*>(nameSpace, sink));
+        sinks.push_back(sink);
 
         _adminLock.Unlock();
     }
 
     /* virtual */ void Dictionary::Unregister(const string& nameSpace, struct Exchange::IDictionary::INotification* sink)
     {
-        bool found = false;
+        _adminLock.WriteLock();
 
-        _adminLock.Lock();
+        ObserverMap::iterator index(_observers.find(nameSpace));
 
-        ObserverMap::iterator index(_observers.begin());
+        if (index != _observers.end()) {
+            std::list<struct Exchange::IDictionary::INotification*>::iterator entry(std::find(index->second.begin(), index->second.end(), sink));
 
-        while ((found == false) && (index != _observers.end())) {
-            found = ((index->second == sink) && (nameSpace == index->first));
-            if (found == false) {
-                index++;
+            if (entry != index->second.end()) {
+                index->second.erase(entry);
+            }
+            if (index->second.empty() == true) {
+                _observers.erase(index);
             }
-        }
-
-        if (index != _observers.end()) {
-            _observers.erase(index);
         }
 
         _adminLock.Unlock();
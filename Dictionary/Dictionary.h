@@ -2,7 +2,9 @@
 #define __DICTIONARY_H
 
 #include "Module.h"
+#include "Journal.h"
 #include <interfaces/IDictionary.h>
+#include <unordered_map>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -74,6 +76,11 @@ namespace Plugin {
             {
                 return (_type);
             }
+            inline void Type(const enumType type)
+            {
+                _dirty = true;
+                _type = type;
+            }
 
         private:
             string _key;
@@ -82,8 +89,241 @@ namespace Plugin {
             bool _dirty;
         };
 
-        typedef std::map<const string, std::list<RuntimeEntry>> DictionaryMap;
-        typedef std::list<std::pair<const string, struct Exchange::IDictionary::INotification*>> ObserverMap;
+        // Open addressing (linear probing) hash table holding the keys of a single namespace.
+        // Keys can not be removed from the dictionary, so there is no need for tombstones.
+        class KeyTable {
+        private:
+            static constexpr uint32_t InitialSize = 16; // Must be a power of 2
+
+            class Slot {
+            public:
+                Slot()
+                    : Hash(0)
+                    , Used(false)
+                    , Entry()
+                {
+                }
+                Slot(const Slot& copy)
+                    : Hash(copy.Hash)
+                    , Used(copy.Used)
+                    , Entry(copy.Entry)
+                {
+                }
+                ~Slot()
+                {
+                }
+
+                Slot& operator=(const Slot& RHS)
+                {
+                    Hash = RHS.Hash;
+                    Used = RHS.Used;
+                    Entry = RHS.Entry;
+
+                    return (*this);
+                }
+
+            public:
+                size_t Hash;
+                bool Used;
+                RuntimeEntry Entry;
+            };
+
+        public:
+            KeyTable()
+                : _slots(InitialSize)
+                , _count(0)
+            {
+            }
+            KeyTable(const KeyTable& copy)
+                : _slots(copy._slots)
+                , _count(copy._count)
+            {
+            }
+            ~KeyTable()
+            {
+            }
+
+            KeyTable& operator=(const KeyTable& RHS)
+            {
+                _slots = RHS._slots;
+                _count = RHS._count;
+
+                return (*this);
+            }
+
+        public:
+            inline uint32_t Count() const
+            {
+                return (_count);
+            }
+            const RuntimeEntry* Find(const string& key) const
+            {
+                const Slot& slot(_slots[Locate(key, std::hash<string>()(key))]);
+
+                return (slot.Used == true ? &(slot.Entry) : nullptr);
+            }
+            RuntimeEntry* Find(const string& key)
+            {
+                Slot& slot(_slots[Locate(key, std::hash<string>()(key))]);
+
+                return (slot.Used == true ? &(slot.Entry) : nullptr);
+            }
+            // The key should not be in the table yet.
+            RuntimeEntry& Insert(const RuntimeEntry& entry)
+            {
+                // Keep the load factor below 0.75, so the probe sequences stay short.
+                if (((_count + 1) * 4) > (_slots.size() * 3)) {
+                    Grow();
+                }
+
+                size_t hash(std::hash<string>()(entry.Key()));
+                Slot& slot(_slots[Locate(entry.Key(), hash)]);
+
+                ASSERT(slot.Used == false);
+
+                slot.Hash = hash;
+                slot.Used = true;
+                slot.Entry = entry;
+                _count++;
+
+                return (slot.Entry);
+            }
+            // Entries further down the probe sequence move up, so no lookup stops early at the freed slot.
+            void Remove(const string& key)
+            {
+                const uint32_t mask(static_cast<uint32_t>(_slots.size() - 1));
+                uint32_t index(Locate(key, std::hash<string>()(key)));
+
+                if (_slots[index].Used == true) {
+                    uint32_t next((index + 1) & mask);
+
+                    while (_slots[next].Used == true) {
+                        const uint32_t home(static_cast<uint32_t>(_slots[next].Hash) & mask);
+                        const bool inPlace(index < next ? ((home > index) && (home <= next)) : ((home > index) || (home <= next)));
+
+                        if (inPlace == false) {
+                            _slots[index] = _slots[next];
+                            index = next;
+                        }
+                        next = (next + 1) & mask;
+                    }
+
+                    _slots[index].Used = false;
+                    _slots[index].Entry = RuntimeEntry();
+                    _count--;
+                }
+            }
+            void Entries(std::list<RuntimeEntry>& entries) const
+            {
+                std::vector<Slot>::const_iterator index(_slots.begin());
+
+                while (index != _slots.end()) {
+                    if (index->Used == true) {
+                        entries.push_back(index->Entry);
+                    }
+                    index++;
+                }
+            }
+
+        private:
+            // Returns the slot holding the key, or the empty slot where it should go.
+            uint32_t Locate(const string& key, const size_t hash) const
+            {
+                const uint32_t mask(static_cast<uint32_t>(_slots.size() - 1));
+                uint32_t index(static_cast<uint32_t>(hash) & mask);
+
+                while ((_slots[index].Used == true) && ((_slots[index].Hash != hash) || (_slots[index].Entry.Key() != key))) {
+                    index = (index + 1) & mask;
+                }
+
+                return (index);
+            }
+            void Grow()
+            {
+                std::vector<Slot> slots(_slots.size() * 2);
+
+                _slots.swap(slots);
+
+                std::vector<Slot>::const_iterator index(slots.begin());
+
+                while (index != slots.end()) {
+                    if (index->Used == true) {
+                        Slot& slot(_slots[Locate(index->Entry.Key(), index->Hash)]);
+                        slot = *index;
+                    }
+                    index++;
+                }
+            }
+
+        private:
+            std::vector<Slot> _slots;
+            uint32_t _count;
+        };
+
+        // Get() is by far the most used operation on the dictionary, so readers should not block
+        // each other, only a Set() requires exclusive access.
+        class ReadWriteLock {
+        private:
+            ReadWriteLock(const ReadWriteLock&) = delete;
+            ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+        public:
+#ifdef __WIN32__
+            ReadWriteLock()
+                : _lock()
+            {
+            }
+            ~ReadWriteLock()
+            {
+            }
+
+        public:
+            inline void ReadLock() const
+            {
+                _lock.Lock();
+            }
+            inline void WriteLock() const
+            {
+                _lock.Lock();
+            }
+            inline void Unlock() const
+            {
+                _lock.Unlock();
+            }
+
+        private:
+            mutable Core::CriticalSection _lock;
+#else
+            ReadWriteLock()
+            {
+                ::pthread_rwlock_init(&_lock, nullptr);
+            }
+            ~ReadWriteLock()
+            {
+                ::pthread_rwlock_destroy(&_lock);
+            }
+
+        public:
+            inline void ReadLock() const
+            {
+                ::pthread_rwlock_rdlock(&_lock);
+            }
+            inline void WriteLock() const
+            {
+                ::pthread_rwlock_wrlock(&_lock);
+            }
+            inline void Unlock() const
+            {
+                ::pthread_rwlock_unlock(&_lock);
+            }
+
+        private:
+            mutable pthread_rwlock_t _lock;
+#endif
+        };
+
+        typedef std::unordered_map<string, KeyTable> DictionaryMap;
+        typedef std::unordered_map<string, std::list<struct Exchange::IDictionary::INotification*>> ObserverMap;
         typedef Core::IteratorType<const std::list<RuntimeEntry>, const RuntimeEntry&, std::list<RuntimeEntry>::const_iterator> InternalIterator;
 
     public:
@@ -94,7 +334,8 @@ namespace Plugin {
 
         public:
             Iterator()
-                : _iterator()
+                : _entries()
+                , _iterator()
                 , _lifeTime(nullptr)
             {
             }
@@ -108,10 +349,14 @@ namespace Plugin {
             }
 
         public:
-            void Load(const InternalIterator& iterator)
+            // The iterator works on a copy of the entries, so the namespace can be modified
+            // while it is being iterated.
+            void Load(const KeyTable& table)
             {
                 ASSERT(_lifeTime != nullptr);
-                _iterator = iterator;
+                _entries.clear();
+                table.Entries(_entries);
+                _iterator = InternalIterator(_entries);
             }
             // IUnknown implementation
             // -----------------------------------------------
@@ -155,6 +400,7 @@ namespace Plugin {
             }
 
         private:
+            std::list<RuntimeEntry> _entries;
             InternalIterator _iterator;
             Core::IReferenceCounted* _lifeTime;
         };
@@ -309,9 +555,11 @@ namespace Plugin {
                 : Core::JSON::Container()
                 , Storage(_T("dictionary.json"))
                 , LingerTime(10)
+                , JournalSize(64)
             { // Time in minutes.
                 Add(_T("storage"), &Storage);
                 Add(_T("lingertime"), &LingerTime);
+                Add(_T("journalsize"), &JournalSize);
             }
             ~Config()
             {
@@ -320,16 +568,88 @@ namespace Plugin {
         public:
             Core::JSON::String Storage;
             Core::JSON::DecUInt16 LingerTime;
+            Core::JSON::DecUInt16 JournalSize; // Size in KB of the journal that triggers a compaction into the storage file
+        };
+
+        class Metrics : public Core::JSON::Container {
+        private:
+            Metrics(const Metrics&) = delete;
+            Metrics& operator=(const Metrics&) = delete;
+
+        public:
+            Metrics()
+                : Core::JSON::Container()
+            {
+                Add(_T("startup"), &Startup);
+                Add(_T("replayed"), &Replayed);
+                Add(_T("journal"), &JournalSize);
+                Add(_T("syncs"), &Syncs);
+                Add(_T("syncfailures"), &Failures);
+                Add(_T("compactions"), &Compactions);
+            }
+            ~Metrics()
+            {
+            }
+
+        public:
+            Core::JSON::DecUInt64 Startup; // Time in us to load the storage file and replay the journal
+            Core::JSON::DecUInt32 Replayed; // Number of journal records replayed on startup
+            Core::JSON::DecUInt32 JournalSize; // Current size of the journal in bytes
+            Core::JSON::DecUInt32 Syncs; // Number of fsyncs issued on the journal and storage file
+            Core::JSON::DecUInt32 Failures; // Number of journal fsyncs that failed
+            Core::JSON::DecUInt32 Compactions;
+        };
+
+        class Compactor : public Core::IDispatchType<void> {
+        private:
+            Compactor() = delete;
+            Compactor(const Compactor&) = delete;
+            Compactor& operator=(const Compactor&) = delete;
+
+        public:
+            Compactor(Dictionary* parent)
+                : _parent(*parent)
+            {
+                ASSERT(parent != nullptr);
+            }
+            virtual ~Compactor()
+            {
+            }
+
+        public:
+            virtual void Dispatch() override
+            {
+                _parent.Compact();
+            }
+
+        private:
+            Dictionary& _parent;
         };
 
     public:
+#ifdef __WIN32__
+#pragma warning(disable : 4355)
+#endif
         Dictionary()
             : _adminLock()
             , _skipURL(0)
             , _config()
             , _dictionary()
+            , _observers()
+            , _storage()
+            , _journal()
+            , _compactor(Core::ProxyType<Compactor>::Create(this))
+            , _compacting(false)
+            , _stopping(false)
+            , _startup(0)
+            , _replayed(0)
+            , _syncs(0)
+            , _compactions(0)
         {
         }
+#ifdef __WIN32__
+#pragma warning(default : 4355)
+#endif
         virtual ~Dictionary()
         {
         }
@@ -390,13 +710,26 @@ namespace Plugin {
     private:
         bool CreateInternalDictionary(const string& currentSpace, const NameSpace& data);
         void CreateExternalDictionary(const string& currentSpace, NameSpace& data) const;
+        bool Set(const string& nameSpace, const string& key, const string& value, const enumType* type);
+        bool Store(const string& nameSpace, const string& key, const string& value, const enumType type);
+        bool WriteStorage(const string& content);
+        void Compact();
 
     private:
-        mutable Core::CriticalSection _adminLock;
+        ReadWriteLock _adminLock;
         uint8_t _skipURL;
         Config _config;
         DictionaryMap _dictionary;
         ObserverMap _observers;
+        string _storage;
+        Journal _journal;
+        Core::ProxyType<Core::IDispatchType<void>> _compactor;
+        bool _compacting;
+        bool _stopping;
+        uint64_t _startup;
+        uint32_t _replayed;
+        uint32_t _syncs;
+        uint32_t _compactions;
     };
 }
 }
@@ -0,0 +1,366 @@
+#ifndef __DICTIONARY_JOURNAL_H
+#define __DICTIONARY_JOURNAL_H
+
+#include "Module.h"
+
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Append only log of modifications to the dictionary. Every record is written and synced
+    // to disk before the modification is acknowledged, so it survives a crash. Writing a record
+    // is cheap and keeps the order of the modifications, so it is done while the dictionary is
+    // locked. The sync is not, it is done after the lock is released, without holding the lock
+    // of the journal either, so appending never waits for the disk. Every record gets a sequence
+    // number, a sync covers all records appended before it started, so concurrent modifications
+    // share the same sync where possible. A record is:
+    //
+    //   length (4) - crc32 of the payload (4) - payload (length)
+    //
+    // where the payload is: type (1) - namespace length (2) - namespace - key length (2) - key
+    //                       - value length (4) - value
+    //
+    // All values are stored little endian. On replay, reading stops at the first record that is
+    // incomplete or does not match its checksum (a torn write), the file is truncated there.
+    //
+    // The journal relies on POSIX file I/O, on Windows it never opens and all modifications are
+    // only persisted when the storage file is written.
+    class Journal {
+    private:
+        Journal(const Journal&) = delete;
+        Journal& operator=(const Journal&) = delete;
+
+        static constexpr uint32_t RecordHeaderSize = 4 + 4;
+
+    public:
+        Journal()
+            : _lock()
+            , _fileName()
+            , _descriptor(-1)
+            , _size(0)
+            , _syncs(0)
+            , _failures(0)
+            , _appended(0)
+            , _synced(0)
+        {
+        }
+        ~Journal()
+        {
+            Close();
+        }
+
+    public:
+        inline const string& FileName() const
+        {
+            return (_fileName);
+        }
+        inline bool IsOpen() const
+        {
+            return (_descriptor >= 0);
+        }
+        inline uint32_t Size() const
+        {
+            return (_size);
+        }
+        inline uint32_t Syncs() const
+        {
+            _lock.Lock();
+            uint32_t result = _syncs;
+            _lock.Unlock();
+
+            return (result);
+        }
+        inline uint32_t Failures() const
+        {
+            _lock.Lock();
+            uint32_t result = _failures;
+            _lock.Unlock();
+
+            return (result);
+        }
+        bool Open(const string& fileName)
+        {
+            ASSERT(_descriptor < 0);
+
+            _lock.Lock();
+
+            _fileName = fileName;
+
+#ifdef __WIN32__
+            TRACE_L1("The dictionary journal %s is not supported on this platform", _fileName.c_str());
+#else
+            _descriptor = ::open(_fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+            if (_descriptor >= 0) {
+                off_t size = ::lseek(_descriptor, 0, SEEK_END);
+                _size = (size > 0 ? static_cast<uint32_t>(size) : 0);
+            } else {
+                TRACE_L1("Could not open the dictionary journal %s, error %d", _fileName.c_str(), errno);
+            }
+#endif
+
+            _lock.Unlock();
+
+            return (_descriptor >= 0);
+        }
+        // Whatever was appended is synced before the file is closed, so a Sync() that did not
+        // get to it before can report success.
+        void Close()
+        {
+            _lock.Lock();
+
+#ifndef __WIN32__
+            if (_descriptor >= 0) {
+                if (_synced != _appended) {
+                    if (::fdatasync(_descriptor) != 0) {
+                        _failures++;
+                    }
+                    _syncs++;
+                }
+                ::close(_descriptor);
+            }
+#endif
+            _descriptor = -1;
+            _size = 0;
+            _synced = _appended;
+
+            _lock.Unlock();
+        }
+        // Should be called with the dictionary locked, the records end up in the order of the modifications.
+        bool Append(const uint8_t type, const string& nameSpace, const string& key, const string& value)
+        {
+            bool result = false;
+
+            if (_descriptor >= 0) {
+                std::vector<uint8_t> record(RecordHeaderSize + 1 + 2 + nameSpace.length() + 2 + key.length() + 4 + value.length());
+                uint8_t* payload = &(record[RecordHeaderSize]);
+                uint8_t* location = payload;
+
+                location = Store(location, type);
+                location = Store(location, static_cast<uint16_t>(nameSpace.length()));
+                ::memcpy(location, nameSpace.c_str(), nameSpace.length());
+                location += nameSpace.length();
+                location = Store(location, static_cast<uint16_t>(key.length()));
+                ::memcpy(location, key.c_str(), key.length());
+                location += key.length();
+                location = Store(location, static_cast<uint32_t>(value.length()));
+                ::memcpy(location, value.c_str(), value.length());
+
+                const uint32_t length = static_cast<uint32_t>(record.size() - RecordHeaderSize);
+                Store(Store(&(record[0]), length), CRC32(payload, length));
+
+                _lock.Lock();
+
+                if (Write(&(record[0]), static_cast<uint32_t>(record.size())) == true) {
+                    _size += static_cast<uint32_t>(record.size());
+                    _appended++;
+                    result = true;
+                }
+
+                _lock.Unlock();
+            }
+
+            return (result);
+        }
+        // Called without the dictionary locked. If another modification synced the file in the
+        // mean time, the record appended before is on disk already and there is nothing to do.
+        // The descriptor is duplicated, so a Close() during the sync does not pull it away.
+        bool Sync()
+        {
+            bool result = true;
+
+#ifndef __WIN32__
+            _lock.Lock();
+
+            const uint64_t sequence = _appended;
+            const int descriptor = (((_descriptor >= 0) && (_synced != sequence)) ? ::dup(_descriptor) : -1);
+
+            _lock.Unlock();
+
+            if (descriptor >= 0) {
+                result = (::fdatasync(descriptor) == 0);
+
+                if (result == false) {
+                    TRACE_L1("Could not sync the dictionary journal, error %d", errno);
+                }
+
+                ::close(descriptor);
+
+                _lock.Lock();
+
+                _syncs++;
+
+                if (result == false) {
+                    _failures++;
+                } else if (static_cast<int64_t>(sequence - _synced) > 0) {
+                    _synced = sequence;
+                }
+
+                _lock.Unlock();
+            }
+#endif
+
+            return (result);
+        }
+
+        // Calls the handler for every valid record in the file, returns the number of records.
+        template <typename HANDLER>
+        static uint32_t Replay(const string& fileName, HANDLER handler)
+        {
+            uint32_t count = 0;
+
+#ifndef __WIN32__
+            int descriptor = ::open(fileName.c_str(), O_RDWR | O_CLOEXEC);
+
+            if (descriptor >= 0) {
+                std::vector<uint8_t> content;
+                uint8_t block[4096];
+                ssize_t size;
+
+                while ((size = ::read(descriptor, block, sizeof(block))) > 0) {
+                    content.insert(content.end(), block, block + size);
+                }
+
+                uint32_t offset = 0;
+                bool valid = true;
+
+                while ((valid == true) && ((offset + RecordHeaderSize) <= content.size())) {
+                    uint32_t length, crc;
+
+                    Load(Load(&(content[offset]), length), crc);
+
+                    valid = ((offset + RecordHeaderSize + length) <= content.size()) && (CRC32(&(content[offset + RecordHeaderSize]), length) == crc);
+
+                    if (valid == true) {
+                        const uint8_t* location = &(content[offset + RecordHeaderSize]);
+                        const uint8_t* end = location + length;
+                        uint8_t type;
+                        uint16_t spaceLength, keyLength;
+                        uint32_t valueLength;
+
+                        // The checksum matched, so the lengths are the ones written, still be defensive.
+                        valid = (length >= (1 + 2 + 2 + 4));
+
+                        if (valid == true) {
+                            location = Load(location, type);
+                            location = Load(location, spaceLength);
+                            valid = ((location + spaceLength + 2 + 4) <= end);
+                        }
+                        if (valid == true) {
+                            const string nameSpace(reinterpret_cast<const char*>(location), spaceLength);
+                            location = Load(location + spaceLength, keyLength);
+                            valid = ((location + keyLength + 4) <= end);
+
+                            if (valid == true) {
+                                const string key(reinterpret_cast<const char*>(location), keyLength);
+                                location = Load(location + keyLength, valueLength);
+                                valid = ((location + valueLength) == end);
+
+                                if (valid == true) {
+                                    handler(type, nameSpace, key, string(reinterpret_cast<const char*>(location), valueLength));
+                                    offset += RecordHeaderSize + length;
+                                    count++;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if (offset < content.size()) {
+                    TRACE_L1("Dropping %d bytes of incomplete records from the dictionary journal %s", static_cast<uint32_t>(content.size() - offset), fileName.c_str());
+                    if (::ftruncate(descriptor, offset) != 0) {
+                        TRACE_L1("Could not truncate the dictionary journal %s, error %d", fileName.c_str(), errno);
+                    }
+                }
+
+                ::close(descriptor);
+            }
+#endif
+
+            return (count);
+        }
+
+    private:
+        bool Write(const uint8_t buffer[], const uint32_t length)
+        {
+            uint32_t written = 0;
+
+#ifndef __WIN32__
+            while (written < length) {
+                ssize_t result = ::write(_descriptor, &(buffer[written]), length - written);
+
+                if (result > 0) {
+                    written += static_cast<uint32_t>(result);
+                } else if ((result < 0) && (errno != EINTR)) {
+                    TRACE_L1("Could not write to the dictionary journal %s, error %d", _fileName.c_str(), errno);
+                    break;
+                }
+            }
+#endif
+
+            return (written == length);
+        }
+        static uint32_t CRC32(const uint8_t buffer[], const uint32_t length)
+        {
+            uint32_t crc = 0xFFFFFFFF;
+
+            for (uint32_t index = 0; index < length; index++) {
+                crc ^= buffer[index];
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+                }
+            }
+
+            return (~crc);
+        }
+        static uint8_t* Store(uint8_t* buffer, const uint8_t value)
+        {
+            buffer[0] = value;
+            return (buffer + 1);
+        }
+        static uint8_t* Store(uint8_t* buffer, const uint16_t value)
+        {
+            buffer[0] = static_cast<uint8_t>(value & 0xFF);
+            buffer[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+            return (buffer + 2);
+        }
+        static uint8_t* Store(uint8_t* buffer, const uint32_t value)
+        {
+            return (Store(Store(buffer, static_cast<uint16_t>(value & 0xFFFF)), static_cast<uint16_t>(value >> 16)));
+        }
+        static const uint8_t* Load(const uint8_t* buffer, uint8_t& value)
+        {
+            value = buffer[0];
+            return (buffer + 1);
+        }
+        static const uint8_t* Load(const uint8_t* buffer, uint16_t& value)
+        {
+            value = static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+            return (buffer + 2);
+        }
+        static const uint8_t* Load(const uint8_t* buffer, uint32_t& value)
+        {
+            uint16_t low, high;
+            buffer = Load(Load(buffer, low), high);
+            value = (static_cast<uint32_t>(high) << 16) | low;
+            return (buffer);
+        }
+
+    private:
+        mutable Core::CriticalSection _lock;
+        string _fileName;
+        int _descriptor;
+        uint32_t _size;
+        uint32_t _syncs;
+        uint32_t _failures;
+        uint64_t _appended;
+        uint64_t _synced;
+    };
+}
+}
+
+#endif // __DICTIONARY_JOURNAL_H
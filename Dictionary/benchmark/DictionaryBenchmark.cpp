@@ -0,0 +1,328 @@
+// Compares the storage of the Dictionary plugin with the one it replaced: a std::map of namespaces,
+// each a linearly searched std::list of keys, behind a single lock, with the observers of all
+// namespaces in one list that is walked on every modification.
+//
+//     DictionaryBenchmark [keys] [namespaces] [threads]
+//
+// By default 10000 keys are spread over 16 namespaces, each with 4 observers, and read back by 4
+// threads. Only volatile keys are used, so neither storage touches the disk.
+
+#include "Dictionary.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+
+using namespace WPEFramework;
+
+namespace {
+
+// The storage of the Dictionary plugin before it was indexed.
+class Baseline {
+private:
+    Baseline(const Baseline&) = delete;
+    Baseline& operator=(const Baseline&) = delete;
+
+    class Entry {
+    public:
+        Entry(const string& key, const string& value)
+            : _key(key)
+            , _value(value)
+        {
+        }
+
+    public:
+        inline const string& Key() const
+        {
+            return (_key);
+        }
+        inline const string& Value() const
+        {
+            return (_value);
+        }
+        inline void Value(const string& value)
+        {
+            _value = value;
+        }
+
+    private:
+        string _key;
+        string _value;
+    };
+
+    typedef std::map<const string, std::list<Entry>> DictionaryMap;
+    typedef std::list<std::pair<const string, struct Exchange::IDictionary::INotification*>> ObserverMap;
+
+public:
+    Baseline()
+        : _adminLock()
+        , _dictionary()
+        , _observers()
+    {
+    }
+    ~Baseline()
+    {
+    }
+
+public:
+    bool Get(const string& nameSpace, const string& key, string& value) const
+    {
+        bool result = false;
+
+        _adminLock.Lock();
+
+        DictionaryMap::const_iterator index(_dictionary.find(nameSpace));
+
+        if (index != _dictionary.end()) {
+            const std::list<Entry>& container(index->second);
+            std::list<Entry>::const_iterator listIndex(container.begin());
+
+            while ((listIndex != container.end()) && (listIndex->Key() != key)) {
+                listIndex++;
+            }
+
+            if (listIndex != container.end()) {
+                result = true;
+                value = listIndex->Value();
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+    bool Set(const string& nameSpace, const string& key, const string& value)
+    {
+        bool result = false;
+
+        _adminLock.Lock();
+
+        std::list<Entry>& container(_dictionary[nameSpace]);
+        std::list<Entry>::iterator listIndex(container.begin());
+
+        while ((listIndex != container.end()) && (listIndex->Key() != key)) {
+            listIndex++;
+        }
+
+        if (listIndex == container.end()) {
+            result = true;
+            container.push_back(Entry(key, value));
+        } else if (listIndex->Value() != value) {
+            result = true;
+            listIndex->Value(value);
+        }
+
+        if (result == true) {
+            ObserverMap::iterator index(_observers.begin());
+
+            while (index != _observers.end()) {
+                if (index->first == nameSpace) {
+                    index->second->Modified(nameSpace, key, value);
+                }
+                index++;
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+    void Register(const string& nameSpace, struct Exchange::IDictionary::INotification* sink)
+    {
+        _adminLock.Lock();
+        _observers.push_back(std::pair<const string, struct Exchange::IDictionary::INotification*>(nameSpace, sink));
+        _adminLock.Unlock();
+    }
+    void Unregister(const string& nameSpace, struct Exchange::IDictionary::INotification* sink)
+    {
+        _adminLock.Lock();
+
+        ObserverMap::iterator index(_observers.begin());
+
+        while ((index != _observers.end()) && ((index->second != sink) || (index->first != nameSpace))) {
+            index++;
+        }
+        if (index != _observers.end()) {
+            _observers.erase(index);
+        }
+
+        _adminLock.Unlock();
+    }
+
+private:
+    mutable Core::CriticalSection _adminLock;
+    DictionaryMap _dictionary;
+    ObserverMap _observers;
+};
+
+class Observer : public Exchange::IDictionary::INotification {
+private:
+    Observer(const Observer&) = delete;
+    Observer& operator=(const Observer&) = delete;
+
+public:
+    Observer()
+        : _modifications(0)
+    {
+    }
+    ~Observer() override
+    {
+    }
+
+public:
+    inline uint32_t Modifications() const
+    {
+        return (_modifications);
+    }
+    void Modified(const string&, const string&, const string&) override
+    {
+        _modifications++;
+    }
+
+    BEGIN_INTERFACE_MAP(Observer)
+    INTERFACE_ENTRY(Exchange::IDictionary::INotification)
+    END_INTERFACE_MAP
+
+private:
+    std::atomic<uint32_t> _modifications;
+};
+
+struct Workload {
+    std::vector<string> NameSpaces;
+    std::vector<std::pair<uint32_t, string>> Keys; // Index of the namespace, key
+};
+
+class Stopwatch {
+public:
+    Stopwatch()
+        : _start(std::chrono::steady_clock::now())
+    {
+    }
+
+public:
+    // Returns the number of operations per second.
+    double Rate(const uint64_t operations) const
+    {
+        const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - _start);
+
+        return (elapsed.count() > 0 ? static_cast<double>(operations) / elapsed.count() : 0);
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+template <typename STORAGE>
+void Run(const char name[], STORAGE& storage, const Workload& load, const uint32_t threads, double rates[4])
+{
+    std::vector<std::unique_ptr<Core::Sink<Observer>>> observers;
+    const uint32_t rounds = 8;
+
+    for (const string& nameSpace : load.NameSpaces) {
+        for (uint8_t index = 0; index < 4; index++) {
+            observers.emplace_back(new Core::Sink<Observer>());
+            storage.Register(nameSpace, observers.back().get());
+        }
+    }
+
+    {
+        Stopwatch watch;
+        for (const auto& key : load.Keys) {
+            storage.Set(load.NameSpaces[key.first], key.second, key.second);
+        }
+        rates[0] = watch.Rate(load.Keys.size());
+    }
+    {
+        Stopwatch watch;
+        for (const auto& key : load.Keys) {
+            storage.Set(load.NameSpaces[key.first], key.second, _T("updated"));
+        }
+        rates[1] = watch.Rate(load.Keys.size());
+    }
+    {
+        Stopwatch watch;
+        string value;
+        for (uint32_t round = 0; round < rounds; round++) {
+            for (const auto& key : load.Keys) {
+                storage.Get(load.NameSpaces[key.first], key.second, value);
+            }
+        }
+        rates[2] = watch.Rate(load.Keys.size() * rounds);
+    }
+    {
+        std::vector<std::thread> readers;
+        Stopwatch watch;
+
+        for (uint32_t thread = 0; thread < threads; thread++) {
+            readers.emplace_back([&storage, &load, thread, threads, rounds]() {
+                string value;
+                for (uint32_t round = 0; round < rounds; round++) {
+                    for (size_t index = thread; index < load.Keys.size(); index += threads) {
+                        storage.Get(load.NameSpaces[load.Keys[index].first], load.Keys[index].second, value);
+                    }
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        rates[3] = watch.Rate(load.Keys.size() * rounds);
+    }
+
+    uint64_t notified = 0;
+
+    for (uint32_t index = 0; index < observers.size(); index++) {
+        notified += (*observers[index]).Modifications();
+        storage.Unregister(load.NameSpaces[index / 4], observers[index].get());
+    }
+
+    if (notified != (load.Keys.size() * 2 * 4)) {
+        fprintf(stderr, "%s: %llu notifications, expected %llu\n", name, static_cast<unsigned long long>(notified), static_cast<unsigned long long>(load.Keys.size() * 2 * 4));
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t keys = (argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 10000);
+    const uint32_t nameSpaces = std::max((argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 16), 1u);
+    const uint32_t threads = std::max((argc > 3 ? static_cast<uint32_t>(atoi(argv[3])) : 4), 1u);
+
+    Workload load;
+
+    for (uint32_t index = 0; index < nameSpaces; index++) {
+        load.NameSpaces.push_back(string(_T("/benchmark/space")) + Core::NumberType<uint32_t>(index).Text());
+    }
+    for (uint32_t index = 0; index < keys; index++) {
+        load.Keys.emplace_back(index % nameSpaces, string(_T("configuration.key.")) + Core::NumberType<uint32_t>(index).Text());
+    }
+
+    double baseline[4];
+    double current[4];
+
+    {
+        Baseline storage;
+        Run("baseline", storage, load, threads, baseline);
+    }
+    {
+        Exchange::IDictionary* storage = Core::Service<Plugin::Dictionary>::Create<Exchange::IDictionary>();
+        Run("dictionary", *storage, load, threads, current);
+        storage->Release();
+    }
+
+    const char* operations[] = { "insert", "update", "get", "concurrent get" };
+
+    printf("%u keys in %u namespace(s), %u reader thread(s), in operations/s\n\n", keys, nameSpaces, threads);
+    printf("%-16s %14s %14s %8s\n", "", "baseline", "dictionary", "speedup");
+
+    for (uint8_t index = 0; index < 4; index++) {
+        printf("%-16s %14.0f %14.0f %7.1fx\n", operations[index], baseline[index], current[index], (baseline[index] > 0 ? current[index] / baseline[index] : 0));
+    }
+
+    Core::Singleton::Dispose();
+
+    return (0);
+}
@@ -191,7 +191,11 @@ namespace Plugin {
         Geography _geo;
     };
 
-    static Core::ProxyPoolType<Web::Response> g_Factory(1);
+    static Core::ProxyPoolType<Web::Response> g_Factory(2);
+
+    // The head start of IPv6 before IPv4 joins the race, the "Connection Attempt Delay" of RFC 8305.
+    // While a probe is in progress its state is re-evaluated at this pace as well.
+    constexpr uint32_t ConnectionAttemptDelay = 250;
 
     static Core::NodeId FindLocalIPV6()
     {
@@ -238,12 +242,146 @@ namespace Plugin {
         return (index < (sizeof(g_domainFactory) / sizeof(DomainConstructor)) ? &(g_domainFactory[index]) : nullptr);
     }
 
+    LocationService::Connection::Connection(LocationService& parent, const Core::NodeId::enumType type)
+        : BaseClass(1, g_Factory, false, Core::NodeId(), Core::NodeId(), 256, 1024)
+        , _parent(parent)
+        , _type(type)
+        , _outcome(NOT_STARTED)
+        , _started(0)
+        , _time(0)
+        , _infoCarrier()
+        , _request(Core::ProxyType<Web::Request>::Create())
+        , _response()
+    {
+    }
+
+    /* virtual */ LocationService::Connection::~Connection()
+    {
+        Close(Core::infinite);
+    }
+
+    const IGeography& LocationService::Connection::Info() const
+    {
+        ASSERT(_infoCarrier.IsValid() == true);
+
+        return (*_infoCarrier);
+    }
+
+    bool LocationService::Connection::Start(const string& remoteId, const Web::Request& request, Factory factory)
+    {
+        Core::NodeId remote(remoteId.c_str(), _type);
+
+        _started = Core::Time::Now().Ticks();
+
+        if (remote.IsValid() == false) {
+            TRACE_L1("DNS resolving failed on %s.", (_type == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")));
+
+            Finished(UNREACHABLE);
+        } else {
+            _request->Host = request.Host;
+            _request->Verb = request.Verb;
+            _request->Path = request.Path;
+            _request->Query = request.Query;
+
+            _infoCarrier = factory();
+            _response = Core::proxy_cast<Web::IBody>(_infoCarrier);
+
+            Link().LocalNode(remote.AnyInterface());
+            Link().RemoteNode(remote);
+
+            _outcome = CONNECTING;
+
+            uint32_t status = Open(0);
+
+            if ((status == Core::ERROR_NONE) || (status == Core::ERROR_INPROGRESS)) {
+                TRACE_L1("Sending out a network package on %s.", (_type == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")));
+            } else {
+                TRACE_L1("Failed on network %s.", (_type == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")));
+
+                Close(0);
+                Finished(UNREACHABLE);
+            }
+        }
+
+        return (_outcome == CONNECTING);
+    }
+
+    void LocationService::Connection::Cancel()
+    {
+        if (_outcome == CONNECTING) {
+            Finished(CANCELLED);
+        }
+        if (IsClosed() == false) {
+            Close(0);
+        }
+
+        _response.Release();
+        _infoCarrier.Release();
+    }
+
+    void LocationService::Connection::Finished(const outcome result)
+    {
+        _outcome = result;
+        _time = static_cast<uint32_t>((Core::Time::Now().Ticks() - _started) / 1000);
+    }
+
+    // Methods to extract and insert data into the socket buffers
+    /* virtual */ void LocationService::Connection::LinkBody(Core::ProxyType<Web::Response>& element)
+    {
+        if ((element->ErrorCode == Web::STATUS_OK) && (_response.IsValid() == true)) {
+
+            element->Body<Web::IBody>(_response);
+            _response.Release();
+        }
+    }
+
+    /* virtual */ void LocationService::Connection::Received(Core::ProxyType<Web::Response>& element)
+    {
+        if (element->HasBody() == true) {
+
+            // ASSERT(element->Body<Web::JSONBodyType<IGeography> >() == _response);
+
+            _parent.Loaded(*this);
+        } else {
+            TRACE_L1("Got a response but had an empty body. %d", __LINE__);
+        }
+    }
+
+    /* virtual */ void LocationService::Connection::Send(const Core::ProxyType<Web::Request>& element)
+    {
+
+        // Not much to do, just so we know we are done...
+        ASSERT(element == _request);
+    }
+
+    // Signal a state change, Opened, Closed or Accepted
+    /* virtual */ void LocationService::Connection::StateChange()
+    {
+
+        if (Link().IsOpen() == true) {
+
+            if (_parent.Connected(*this) == true) {
+                // Send out a trigger to send the request
+                Submit(_request);
+            }
+        } else if (Link().HasError() == true) {
+            Close(0);
+
+            _parent._adminLock.Lock();
+
+            if (_outcome == CONNECTING) {
+                Finished(UNREACHABLE);
+            }
+
+            _parent._adminLock.Unlock();
+        }
+    }
+
 #ifdef __WIN32__
 #pragma warning(disable : 4355)
 #endif
     LocationService::LocationService(Core::IDispatchType<void>* callback)
-        : BaseClass(1, g_Factory, false, Core::NodeId(), Core::NodeId(), 256, 1024)
-        , _adminLock()
+        : _adminLock()
         , _state(IDLE)
         , _remoteId()
         , _sourceNode()
@@ -254,8 +392,13 @@ namespace Plugin {
         , _country()
         , _region()
         , _city()
+        , _factory(nullptr)
+        , _started(0)
+        , _wakeup(0)
+        , _winner(nullptr)
+        , _ipv6(*this, Core::NodeId::TYPE_IPV6)
+        , _ipv4(*this, Core::NodeId::TYPE_IPV4)
         , _request(Core::ProxyType<Web::Request>::Create())
-        , _response()
         , _activity(Core::ProxyType<Job>::Create(this))
     {
     }
@@ -267,8 +410,6 @@ namespace Plugin {
     {
 
         Stop();
-
-        Close(Core::infinite);
     }
 
     uint32_t LocationService::Probe(const string& remote, const uint32_t retries, const uint32_t retryTimeSpan)
@@ -279,9 +420,6 @@ namespace Plugin {
 
         if ((_state == IDLE) || (_state == FAILED) || (_state == LOADED)) {
 
-            ASSERT(_response.IsValid() == false);
-            ASSERT(_infoCarrier.IsValid() == false);
-
             result = Core::ERROR_GENERAL;
 
             // Determine the request
@@ -318,8 +456,8 @@ namespace Plugin {
                         _request->Query = info.Query().Value().Text();
                     }
 
-                    _infoCarrier = constructor->factory();
-                    _response = Core::proxy_cast<Web::IBody>(_infoCarrier);
+                    _factory = constructor->factory;
+                    _wakeup = 0;
 
                     PluginHost::WorkerPool::Instance().Submit(_activity);
 
@@ -342,9 +480,8 @@ namespace Plugin {
 
         if ((_state != IDLE) && (_state != FAILED) && (_state != LOADED)) {
 
-            if (IsClosed() == false) {
-                Close(0);
-            }
+            _ipv6.Cancel();
+            _ipv4.Cancel();
 
             _state = FAILED;
         }
@@ -352,33 +489,59 @@ namespace Plugin {
         _adminLock.Unlock();
     }
 
-    // Methods to extract and insert data into the socket buffers
-    /* virtual */ void LocationService::LinkBody(Core::ProxyType<Web::Response>& element)
+    LocationService::outcome LocationService::Connectivity(const Core::NodeId::enumType type, uint32_t& time) const
     {
-        if (element->ErrorCode == Web::STATUS_OK) {
+        const Connection& connection(type == Core::NodeId::TYPE_IPV6 ? _ipv6 : _ipv4);
 
-            ASSERT(_response.IsValid() == true);
+        _adminLock.Lock();
 
-            element->Body<Web::IBody>(_response);
-            _response.Release();
-        }
+        outcome result = connection.Outcome();
+        time = connection.Time();
+
+        _adminLock.Unlock();
+
+        return (result);
     }
 
-    /* virtual */ void LocationService::Received(Core::ProxyType<Web::Response>& element)
+    bool LocationService::Connected(Connection& connection)
     {
+        bool result = false;
 
-        if (element->HasBody() == true) {
+        _adminLock.Lock();
 
-            // ASSERT(element->Body<Web::JSONBodyType<IGeography> >() == _response);
+        if ((_state == INPROGRESS) && (_winner == nullptr) && (connection.Outcome() == CONNECTING)) {
+
+            result = true;
+            _winner = &connection;
+            _winner->Finished(CONNECTED);
 
-            _adminLock.Lock();
+            // The race is over, the other family is not needed anymore.
+            (&connection == &_ipv6 ? _ipv4 : _ipv6).Cancel();
+
+            TRACE(Trace::Information, (_T("LocationSync: Connected over %s in %d ms"), (connection.Type() == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")), connection.Time()));
+        } else {
+            connection.Cancel();
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    void LocationService::Loaded(Connection& connection)
+    {
+        _adminLock.Lock();
 
-            _timeZone = _infoCarrier->TimeZone();
-            _country = _infoCarrier->Country();
-            _region = _infoCarrier->Region();
-            _city = _infoCarrier->City();
+        if ((_state == INPROGRESS) && (_winner == &connection)) {
 
-            if (_state == IPV6_INPROGRESS) {
+            const IGeography& info(connection.Info());
+
+            _timeZone = info.TimeZone();
+            _country = info.Country();
+            _region = info.Region();
+            _city = info.City();
+
+            if (connection.Type() == Core::NodeId::TYPE_IPV6) {
 
                 // For now the source IPV6 is not returned but as IPV6 is not NAT'ed our IF Address should be
                 // the outside IP address as well.
@@ -388,7 +551,7 @@ namespace Plugin {
 
                 _publicIPAddress = localId.HostAddress();
             } else {
-                _publicIPAddress = _infoCarrier->IP();
+                _publicIPAddress = info.IP();
             }
             _state = LOADED;
 
@@ -398,7 +561,8 @@ namespace Plugin {
 
             if (node.IsValid() == true) {
 
-                if (node.Type() == Core::NodeId::TYPE_IPV4) {
+                // IPv4 may also win the race because IPv6 was just slower, only give up on IPv6 if it failed.
+                if ((node.Type() == Core::NodeId::TYPE_IPV4) && (_ipv6.Outcome() == UNREACHABLE)) {
                     Core::NodeId::ClearIPV6Enabled();
                 }
 
@@ -412,103 +576,113 @@ namespace Plugin {
                 _callback->Dispatch();
             }
 
-            _infoCarrier.Release();
-
-            _adminLock.Unlock();
-        } else {
-            TRACE_L1("Got a response but had an empty body. %d", __LINE__);
+            // We got what we needed, the connection can go.
+            _winner->Cancel();
+            _winner = nullptr;
         }
 
-        // Finish the cycle..
-        PluginHost::WorkerPool::Instance().Submit(_activity);
-    }
-
-    /* virtual */ void LocationService::Send(const Core::ProxyType<Web::Request>& element)
-    {
-
-        // Not much to do, just so we know we are done...
-        ASSERT(element == _request);
+        _adminLock.Unlock();
     }
 
-    // Signal a state change, Opened, Closed or Accepted
-    /* virtual */ void LocationService::StateChange()
+    // A probe is settled if a connection won the race but lost its connection before the answer came
+    // in, or if no connection can win anymore.
+    bool LocationService::IsSettled() const
     {
-
-        if (Link().IsOpen() == true) {
-
-            // Send out a trigger to send the request
-            Submit(_request);
-        } else if (Link().HasError() == true) {
-            Close(0);
-            PluginHost::WorkerPool::Instance().Submit(_activity);
-        }
+        return (_winner != nullptr ? _winner->IsClosed() : ((_ipv6.Outcome() != CONNECTING) && (_ipv4.Outcome() != NOT_STARTED) && (_ipv4.Outcome() != CONNECTING)));
     }
 
     // The network might be down, keep on trying until we have connectivity.
-    // We start using IPV6, preferred network...
+    // Both IPV6, the preferred network, and IPV4 are tried, IPV6 gets a head start.
     void LocationService::Dispatch()
     {
-
         uint32_t result = Core::infinite;
+        bool failed = false;
 
-        if ((IsClosed() == false) || (Close(100) != Core::ERROR_NONE)) {
+        _adminLock.Lock();
 
-            result = 500; // ms...Check again..
-        } else {
+        const uint64_t now = Core::Time::Now().Ticks();
 
-            _adminLock.Lock();
+        // If a probe was started while a check was still pending, the one scheduled last is the one
+        // that counts.
+        if (now >= _wakeup) {
 
-            if (_state == IPV4_INPROGRESS) {
-                _state = (_retries-- == 0 ? FAILED : ACTIVE);
-            }
+            if (_state == INPROGRESS) {
 
-            if ((_state != LOADED) && (_state != FAILED)) {
+                const uint64_t elapsed = (now - _started) / 1000; // Move from uS to mS
 
-                Core::NodeId remote(_remoteId.c_str(), ((_state == ACTIVE) && (Core::NodeId::IsIPV6Enabled()) ? Core::NodeId::TYPE_IPV6 : Core::NodeId::TYPE_IPV4));
+                if ((_winner == nullptr) && (_ipv4.Outcome() == NOT_STARTED) && ((_ipv6.Outcome() != CONNECTING) || (elapsed >= ConnectionAttemptDelay))) {
 
-                if (remote.IsValid() == false) {
+                    // IPV6 did not make it in time, let IPV4 join the race.
+                    _ipv4.Start(_remoteId, *_request, _factory);
+                }
 
-                    TRACE_L1("DNS resolving failed. Sleep for %d mS for attempt %d", _tryInterval, _retries);
+                if ((elapsed < _tryInterval) && (IsSettled() == false)) {
 
-                    // Name resolving does not even work. Retry this after a few seconds, if we still can..
-                    if (_retries-- == 0)
-                        _state = FAILED;
-                    else
-                        result = _tryInterval;
+                    // We need to get a response in the given time..
+                    result = std::min(ConnectionAttemptDelay, static_cast<uint32_t>(_tryInterval - elapsed));
                 } else {
-                    Link().LocalNode(remote.AnyInterface());
-                    Link().RemoteNode(remote);
+                    TRACE_L1("No network connectivity for attempt %d.", _retries);
+
+                    _ipv6.Cancel();
+                    _ipv4.Cancel();
+                    _winner = nullptr;
+
+                    if (_retries-- == 0) {
+                        _state = FAILED;
+                        failed = true;
+                    } else {
+                        // Retry this after a the remainder of the interval, if we still can..
+                        _state = ACTIVE;
+                        result = (elapsed < _tryInterval ? static_cast<uint32_t>(_tryInterval - elapsed) : 0);
+                    }
+                }
+            } else if (_state == ACTIVE) {
 
-                    _state = (remote.Type() == Core::NodeId::TYPE_IPV6 ? IPV6_INPROGRESS : IPV4_INPROGRESS);
+                if ((_ipv6.IsClosed() == false) || (_ipv4.IsClosed() == false)) {
 
-                    uint32_t status = Open(0);
+                    result = 100; // ms...Check again..
+                } else {
 
-                    if ((status == Core::ERROR_NONE) || (status == Core::ERROR_INPROGRESS)) {
+                    _started = now;
+                    _winner = nullptr;
+                    _ipv6.Reset();
+                    _ipv4.Reset();
 
-                        TRACE_L1("Sending out a network package on %s. Attempt: %d", (remote.Type() == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")), _retries);
+                    // Without IPV6, or if the name does not resolve on it, IPV4 starts right away.
+                    if (((Core::NodeId::IsIPV6Enabled() == true) && (_ipv6.Start(_remoteId, *_request, _factory) == true)) || (_ipv4.Start(_remoteId, *_request, _factory) == true)) {
 
-                        // We need to get a response in the given time..
-                        result = _tryInterval;
+                        _state = INPROGRESS;
+                        result = std::min(ConnectionAttemptDelay, _tryInterval);
                     } else {
-                        TRACE_L1("Failed on network %s. Reschedule for the next attempt: %d", (remote.Type() == Core::NodeId::TYPE_IPV6 ? _T("IPv6") : _T("IPv4")), _retries);
 
-                        // Seems we could not open this connection, move on to the next attempt.
-                        Close(0);
-                        result = 100;
+                        TRACE_L1("DNS resolving failed. Sleep for %d mS for attempt %d", _tryInterval, _retries);
+
+                        // Name resolving does not even work. Retry this after a few seconds, if we still can..
+                        if (_retries-- == 0) {
+                            _state = FAILED;
+                            failed = true;
+                        } else {
+                            result = _tryInterval;
+                        }
                     }
                 }
             }
-            _adminLock.Unlock();
+
+            // See if we need rescheduling
+            if (result != Core::infinite) {
+                _wakeup = now + (static_cast<uint64_t>(result) * 1000);
+            }
         }
 
-        if (_state == FAILED) {
+        _adminLock.Unlock();
+
+        if (failed == true) {
             Core::NodeId::ClearIPV6Enabled();
 
             TRACE(Trace::Information, (_T("LocationSync: Network connectivity could *NOT* be established. Falling back to IPv4. %d"), __LINE__));
             _callback->Dispatch();
         }
 
-        // See if we need rescheduling
         if (result != Core::infinite) {
             Core::Time timestamp(Core::Time::Now());
             timestamp.Add(result);
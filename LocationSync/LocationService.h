@@ -11,19 +11,88 @@ namespace Plugin {
 
     class EXTERNAL LocationService
         : public PluginHost::ISubSystem::ILocation,
-          public PluginHost::ISubSystem::IInternet,
-          public Web::WebLinkType<Core::SocketStream, Web::Response, Web::Request, Core::ProxyPoolType<Web::Response>&> {
+          public PluginHost::ISubSystem::IInternet {
+
+    public:
+        // The outcome of the connection attempt over an address family during the last probe.
+        enum outcome {
+            NOT_STARTED,
+            CONNECTING,
+            CONNECTED,
+            UNREACHABLE,
+            CANCELLED
+        };
 
     private:
         enum state {
             IDLE,
             ACTIVE,
-            IPV6_INPROGRESS,
-            IPV4_INPROGRESS,
+            INPROGRESS,
             LOADED,
             FAILED
         };
 
+        typedef Web::WebLinkType<Core::SocketStream, Web::Response, Web::Request, Core::ProxyPoolType<Web::Response>&> BaseClass;
+        typedef Core::ProxyType<IGeography> (*Factory)();
+
+        // The probe over a single address family. The families race each other as described by
+        // RFC 8305 ("Happy Eyeballs"), the first connection that is established sends the request,
+        // the other one is cancelled.
+        class Connection : public BaseClass {
+        private:
+            Connection() = delete;
+            Connection(const Connection&) = delete;
+            Connection& operator=(const Connection&) = delete;
+
+        public:
+            Connection(LocationService& parent, const Core::NodeId::enumType type);
+            virtual ~Connection();
+
+        public:
+            inline Core::NodeId::enumType Type() const
+            {
+                return (_type);
+            }
+            inline outcome Outcome() const
+            {
+                return (_outcome);
+            }
+            // Time in ms it took to establish the connection, or to give up on it.
+            inline uint32_t Time() const
+            {
+                return (_time);
+            }
+            const IGeography& Info() const;
+            inline void Reset()
+            {
+                _outcome = NOT_STARTED;
+                _time = 0;
+            }
+
+            bool Start(const string& remoteId, const Web::Request& request, Factory factory);
+            void Cancel();
+            void Finished(const outcome result);
+
+        private:
+            // Notification of a Partial Request received, time to attach a body..
+            virtual void LinkBody(Core::ProxyType<Web::Response>& element) override;
+            virtual void Received(Core::ProxyType<Web::Response>& element) override;
+            virtual void Send(const Core::ProxyType<Web::Request>& element) override;
+
+            // Signal a state change, Opened, Closed or Accepted
+            virtual void StateChange() override;
+
+        private:
+            LocationService& _parent;
+            const Core::NodeId::enumType _type;
+            outcome _outcome;
+            uint64_t _started;
+            uint32_t _time;
+            Core::ProxyType<IGeography> _infoCarrier;
+            Core::ProxyType<Web::Request> _request;
+            Core::ProxyType<Web::IBody> _response;
+        };
+
         class Job : public Core::IDispatchType<void> {
         private:
             Job() = delete;
@@ -55,8 +124,6 @@ namespace Plugin {
         LocationService(const LocationService&) = delete;
         LocationService& operator=(const LocationService&) = delete;
 
-        typedef Web::WebLinkType<Core::SocketStream, Web::Response, Web::Request, Core::ProxyPoolType<Web::Response>&> BaseClass;
-
     public:
         LocationService(Core::IDispatchType<void>* update);
         virtual ~LocationService();
@@ -73,6 +140,10 @@ namespace Plugin {
         uint32_t Probe(const string& remoteNode, const uint32_t retries, const uint32_t retryTimeSpan);
         void Stop();
 
+        // The outcome of the last probe over the given address family (TYPE_IPV6 or TYPE_IPV4) and
+        // the time in ms it took.
+        outcome Connectivity(const Core::NodeId::enumType type, uint32_t& time) const;
+
         /*
        * ------------------------------------------------------------------------------------------------------------
        * ISubSystem::INetwork methods
@@ -109,18 +180,15 @@ namespace Plugin {
         }
 
     private:
-        // Notification of a Partial Request received, time to attach a body..
-        virtual void LinkBody(Core::ProxyType<Web::Response>& element) override;
-        virtual void Received(Core::ProxyType<Web::Response>& element) override;
-        virtual void Send(const Core::ProxyType<Web::Request>& element) override;
-
-        // Signal a state change, Opened, Closed or Accepted
-        virtual void StateChange() override;
+        // Called by the connections, from the thread handling the sockets.
+        bool Connected(Connection& connection);
+        void Loaded(Connection& connection);
 
         void Dispatch();
+        bool IsSettled() const;
 
     private:
-        Core::CriticalSection _adminLock;
+        mutable Core::CriticalSection _adminLock;
         state _state;
         string _remoteId;
         Core::NodeId _sourceNode;
@@ -132,10 +200,14 @@ namespace Plugin {
         string _country;
         string _region;
         string _city;
-        Core::ProxyType<IGeography> _infoCarrier;
+        Factory _factory;
+        uint64_t _started;
+        uint64_t _wakeup;
+        Connection* _winner;
+        Connection _ipv6;
+        Connection _ipv4;
 
         Core::ProxyType<Web::Request> _request;
-        Core::ProxyType<Web::IBody> _response;
         Core::ProxyType<Core::IDispatch> _activity;
     };
 }
@@ -42,6 +42,53 @@ namespace Plugin {
             Core::JSON::String City;
         };
 
+        class ConnectivityData : public Core::JSON::Container {
+        public:
+            class FamilyData : public Core::JSON::Container {
+            public:
+                FamilyData(FamilyData const& other) = delete;
+                FamilyData& operator=(FamilyData const& other) = delete;
+
+                FamilyData()
+                    : Core::JSON::Container()
+                    , Outcome()
+                    , Time()
+                {
+                    Add(_T("outcome"), &Outcome);
+                    Add(_T("time"), &Time);
+                }
+
+                virtual ~FamilyData()
+                {
+                }
+
+            public:
+                Core::JSON::String Outcome;
+                Core::JSON::DecUInt32 Time;
+            };
+
+        public:
+            ConnectivityData(ConnectivityData const& other) = delete;
+            ConnectivityData& operator=(ConnectivityData const& other) = delete;
+
+            ConnectivityData()
+                : Core::JSON::Container()
+                , Ipv6()
+                , Ipv4()
+            {
+                Add(_T("ipv6"), &Ipv6);
+                Add(_T("ipv4"), &Ipv4);
+            }
+
+            virtual ~ConnectivityData()
+            {
+            }
+
+        public:
+            FamilyData Ipv6;
+            FamilyData Ipv4;
+        };
+
     private:
         class Notification : public Core::IDispatch {
         private:
@@ -99,6 +146,12 @@ namespace Plugin {
             {
                 return (_locator);
             }
+            inline const LocationService& Locator() const
+            {
+                ASSERT(_locator != nullptr);
+
+                return (*_locator);
+            }
 
         private:
             inline uint32_t Probe()
@@ -179,6 +232,7 @@ namespace Plugin {
         void UnregisterAll();
         uint32_t endpoint_sync();
         uint32_t get_location(JsonData::LocationSync::LocationData& response) const;
+        uint32_t get_connectivity(ConnectivityData& response) const;
 
         void SyncedLocation();
 
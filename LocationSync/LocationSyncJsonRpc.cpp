@@ -16,17 +16,44 @@ namespace Plugin {
     {
         Register<void,void>(_T("sync"), &LocationSync::endpoint_sync, this);
         Property<LocationData>(_T("location"), &LocationSync::get_location, nullptr, this);
+        Property<ConnectivityData>(_T("connectivity"), &LocationSync::get_connectivity, nullptr, this);
     }
 
     void LocationSync::UnregisterAll()
     {
         Unregister(_T("sync"));
         Unregister(_T("location"));
+        Unregister(_T("connectivity"));
     }
 
     // API implementation
     //
 
+    static void Connectivity(const LocationService& locator, const Core::NodeId::enumType type, LocationSync::ConnectivityData::FamilyData& response)
+    {
+        uint32_t time = 0;
+
+        switch (locator.Connectivity(type, time)) {
+        case LocationService::CONNECTING:
+            response.Outcome = _T("connecting");
+            break;
+        case LocationService::CONNECTED:
+            response.Outcome = _T("connected");
+            break;
+        case LocationService::UNREACHABLE:
+            response.Outcome = _T("unreachable");
+            break;
+        case LocationService::CANCELLED:
+            response.Outcome = _T("cancelled");
+            break;
+        default:
+            response.Outcome = _T("notstarted");
+            break;
+        }
+
+        response.Time = time;
+    }
+
     // Method: sync - Runs sync command
     // Return codes:
     //  - ERROR_NONE: Success
@@ -70,6 +97,17 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Property: connectivity - Outcome of the last probe per address family
+    // Return codes:
+    //  - ERROR_NONE: Success
+    uint32_t LocationSync::get_connectivity(ConnectivityData& response) const
+    {
+        Connectivity(_sink.Locator(), Core::NodeId::TYPE_IPV6, response.Ipv6);
+        Connectivity(_sink.Locator(), Core::NodeId::TYPE_IPV4, response.Ipv4);
+
+        return Core::ERROR_NONE;
+    }
+
 } // namespace Plugin
 
 }
@@ -19,7 +19,7 @@ namespace Plugin {
         Core::JSON::ArrayType<Config::Entry>::Iterator index(_config.Observables.Elements());
 
         // Create a list of plugins to monitor..
-        _monitor->Open(service, index);
+        _monitor->Open(service, index, _config.History.Value());
 
         // During the registartion, all Plugins, currently active are reported to the sink.
         service->Register(_monitor);
@@ -2,9 +2,11 @@
 #define __MONITOR_H
 
 #include "Module.h"
+#include "Sampler.h"
 #include <interfaces/IMemory.h>
 #include <interfaces/json/JsonData_Monitor.h>
 #include <limits>
+#include <set>
 #include <string>
 
 static uint32_t gcd(uint32_t a, uint32_t b)
@@ -100,6 +102,13 @@ namespace Plugin {
                 _shared.Set(memInterface->Shared());
                 _process.Set(memInterface->Processes());
             }
+            void Measure(const Sampler::Sample& sample)
+            {
+                _resident.Set(sample.Resident);
+                _allocated.Set(sample.Allocated);
+                _shared.Set(sample.Shared);
+                _process.Set(sample.Processes);
+            }
             void Operational(const bool operational)
             {
                 _operational = operational;
@@ -142,6 +151,86 @@ namespace Plugin {
             bool _operational;
         };
 
+        // Fixed size ring buffer with the last measurements of an observable. The storage is
+        // allocated once, on construction, adding samples never allocates.
+        class History {
+        public:
+            struct Sample {
+                uint64_t Time;
+                uint64_t Resident;
+                uint64_t Allocated;
+                uint64_t Shared;
+                uint8_t Processes;
+                bool Operational;
+                bool Measured; // The memory figures were taken in this sample, not carried over
+            };
+
+        public:
+            History() = delete;
+            History& operator=(const History&) = delete;
+
+            History(const uint16_t depth)
+                : _samples(depth)
+                , _head(0)
+                , _count(0)
+            {
+            }
+            History(const History& copy)
+                : _samples(copy._samples)
+                , _head(copy._head)
+                , _count(copy._count)
+            {
+            }
+            ~History()
+            {
+            }
+
+        public:
+            inline uint16_t Depth() const
+            {
+                return (static_cast<uint16_t>(_samples.size()));
+            }
+            inline uint16_t Count() const
+            {
+                return (_count);
+            }
+            void Add(const uint64_t time, const MetaData& data, const bool measured)
+            {
+                if (_samples.size() > 0) {
+                    Sample& entry(_samples[_head]);
+
+                    entry.Time = time;
+                    entry.Resident = data.Resident().Last();
+                    entry.Allocated = data.Allocated().Last();
+                    entry.Shared = data.Shared().Last();
+                    entry.Processes = data.Process().Last();
+                    entry.Operational = data.Operational();
+                    entry.Measured = measured;
+
+                    _head = static_cast<uint16_t>((_head + 1) % _samples.size());
+                    if (_count < _samples.size()) {
+                        _count++;
+                    }
+                }
+            }
+            // Index 0 is the oldest sample available.
+            inline const Sample& operator[](const uint16_t index) const
+            {
+                ASSERT(index < _count);
+                return (_samples[(_head + _samples.size() - _count + index) % _samples.size()]);
+            }
+            inline void Reset()
+            {
+                _head = 0;
+                _count = 0;
+            }
+
+        private:
+            std::vector<Sample> _samples;
+            uint16_t _head;
+            uint16_t _count;
+        };
+
         class Data : public Core::JSON::Container {
         public:
             class MetaData : public Core::JSON::Container {
@@ -378,6 +467,161 @@ namespace Plugin {
             RestartInfo Restart;
         };
 
+        class ProbeInfo : public Core::JSON::Container {
+        private:
+            ProbeInfo& operator=(const ProbeInfo&) = delete;
+
+        public:
+            ProbeInfo()
+                : Core::JSON::Container()
+                , Duration()
+                , Evaluated()
+                , Ticks()
+                , Scheduled()
+            {
+                Add(_T("duration"), &Duration);
+                Add(_T("evaluated"), &Evaluated);
+                Add(_T("ticks"), &Ticks);
+                Add(_T("scheduled"), &Scheduled);
+            }
+            ~ProbeInfo()
+            {
+            }
+
+        public:
+            Data::MetaData::Measurement Duration; // Time (us) spent per probe tick
+            Data::MetaData::Measurement Evaluated; // Number of observables evaluated per probe tick
+            Core::JSON::DecUInt32 Ticks;
+            Core::JSON::DecUInt32 Scheduled;
+        };
+
+        class HistoryParams : public Core::JSON::Container {
+        private:
+            HistoryParams& operator=(const HistoryParams&) = delete;
+
+        public:
+            HistoryParams()
+                : Core::JSON::Container()
+                , Callsign()
+                , Points()
+            {
+                Add(_T("callsign"), &Callsign);
+                Add(_T("points"), &Points);
+            }
+            ~HistoryParams()
+            {
+            }
+
+        public:
+            Core::JSON::String Callsign;
+            Core::JSON::DecUInt16 Points; // Maximum number of points in the returned series
+        };
+
+        class HistoryInfo : public Core::JSON::Container {
+        public:
+            class SampleInfo : public Core::JSON::Container {
+            public:
+                SampleInfo()
+                    : Core::JSON::Container()
+                {
+                    Init();
+                }
+                SampleInfo(const SampleInfo& copy)
+                    : Core::JSON::Container()
+                    , Timestamp(copy.Timestamp)
+                    , Resident(copy.Resident)
+                    , Allocated(copy.Allocated)
+                    , Shared(copy.Shared)
+                    , Process(copy.Process)
+                    , Operational(copy.Operational)
+                {
+                    Init();
+                }
+                ~SampleInfo()
+                {
+                }
+
+                SampleInfo& operator=(const SampleInfo& RHS)
+                {
+                    Timestamp = RHS.Timestamp;
+                    Resident = RHS.Resident;
+                    Allocated = RHS.Allocated;
+                    Shared = RHS.Shared;
+                    Process = RHS.Process;
+                    Operational = RHS.Operational;
+
+                    return (*this);
+                }
+
+            private:
+                void Init()
+                {
+                    Add(_T("timestamp"), &Timestamp);
+                    Add(_T("resident"), &Resident);
+                    Add(_T("allocated"), &Allocated);
+                    Add(_T("shared"), &Shared);
+                    Add(_T("process"), &Process);
+                    Add(_T("operational"), &Operational);
+                }
+
+            public:
+                Core::JSON::String Timestamp;
+                Core::JSON::DecUInt64 Resident;
+                Core::JSON::DecUInt64 Allocated;
+                Core::JSON::DecUInt64 Shared;
+                Core::JSON::DecUInt8 Process;
+                Core::JSON::Boolean Operational;
+            };
+
+            class PercentileInfo : public Core::JSON::Container {
+            private:
+                PercentileInfo& operator=(const PercentileInfo&) = delete;
+
+            public:
+                PercentileInfo()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("p50"), &P50);
+                    Add(_T("p95"), &P95);
+                    Add(_T("p99"), &P99);
+                }
+                ~PercentileInfo()
+                {
+                }
+
+            public:
+                Core::JSON::DecUInt64 P50;
+                Core::JSON::DecUInt64 P95;
+                Core::JSON::DecUInt64 P99;
+            };
+
+        private:
+            HistoryInfo& operator=(const HistoryInfo&) = delete;
+
+        public:
+            HistoryInfo()
+                : Core::JSON::Container()
+            {
+                Add(_T("depth"), &Depth);
+                Add(_T("count"), &Count);
+                Add(_T("samples"), &Samples);
+                Add(_T("resident"), &Resident);
+                Add(_T("allocated"), &Allocated);
+                Add(_T("shared"), &Shared);
+            }
+            ~HistoryInfo()
+            {
+            }
+
+        public:
+            Core::JSON::DecUInt16 Depth;
+            Core::JSON::DecUInt16 Count;
+            Core::JSON::ArrayType<SampleInfo> Samples;
+            PercentileInfo Resident;
+            PercentileInfo Allocated;
+            PercentileInfo Shared;
+        };
+
     private:
         Monitor(const Monitor&);
         Monitor& operator=(const Monitor&);
@@ -401,6 +645,7 @@ namespace Plugin {
                     Add(_T("memorylimit"), &MetaDataLimit);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
+                    Add(_T("history"), &History);
                 }
                 Entry(const Entry& copy)
                     : Core::JSON::Container()
@@ -409,12 +654,14 @@ namespace Plugin {
                     , MetaDataLimit(copy.MetaDataLimit)
                     , Operational(copy.Operational)
                     , Restart(copy.Restart)
+                    , History(copy.History)
                 {
                     Add(_T("callsign"), &Callsign);
                     Add(_T("memory"), &MetaData);
                     Add(_T("memorylimit"), &MetaDataLimit);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
+                    Add(_T("history"), &History);
                 }
                 ~Entry()
                 {
@@ -426,13 +673,16 @@ namespace Plugin {
                 Core::JSON::DecUInt32 MetaDataLimit;
                 Core::JSON::DecSInt32 Operational;
                 RestartInfo Restart;
+                Core::JSON::DecUInt16 History;
             };
 
         public:
             Config()
                 : Core::JSON::Container()
+                , History(120)
             {
                 Add(_T("observables"), &Observables);
+                Add(_T("history"), &History);
             }
             ~Config()
             {
@@ -440,6 +690,7 @@ namespace Plugin {
 
         public:
             Core::JSON::ArrayType<Entry> Observables;
+            Core::JSON::DecUInt16 History; // Default number of samples kept per observable
         };
 
         class MonitorObjects : public PluginHost::IPlugin::INotification {
@@ -455,8 +706,9 @@ namespace Plugin {
                 Job& operator=(const Job& RHS) = delete;
 
             public:
-                Job(MonitorObjects* parent)
+                Job(MonitorObjects* parent, const uint32_t generation)
                     : _parent(*parent)
+                    , _generation(generation)
                 {
                     ASSERT(parent != nullptr);
                 }
@@ -467,11 +719,12 @@ namespace Plugin {
             public:
                 virtual void Dispatch() override
                 {
-                    _parent.Probe();
+                    _parent.Probe(_generation);
                 }
 
             private:
                 MonitorObjects& _parent;
+                const uint32_t _generation;
             };
 
             class MonitorObject {
@@ -485,6 +738,11 @@ namespace Plugin {
                     EXCEEDED_MEMORY = 0x02
                 };
 
+                enum check {
+                    CHECK_OPERATIONAL = 0x01,
+                    CHECK_MEMORY = 0x02
+                };
+
                 typedef struct {
                     int32_t Limit;
                     int32_t WindowSeconds;
@@ -500,7 +758,8 @@ namespace Plugin {
                     const uint16_t operationalRestartWindow,
                     const uint8_t operationalRestartLimit,
                     const uint16_t memoryRestartWindow,
-                    const uint8_t memoryRestartLimit)
+                    const uint8_t memoryRestartLimit,
+                    const uint16_t historyDepth)
                     : _operationalInterval(operationalInterval)
                     , _memoryInterval(memoryInterval)
                     , _memoryThreshold(memoryThreshold * 1024)
@@ -516,6 +775,7 @@ namespace Plugin {
                     , _memoryRestartWindow(memoryRestartWindow)
                     , _memoryRestartLimit(memoryRestartLimit)
                     , _measurement()
+                    , _history(historyDepth)
                     , _operationalEvaluate(actOnOperational)
                     , _source(nullptr)
                 {
@@ -543,6 +803,7 @@ namespace Plugin {
                     , _memoryRestartWindow(copy._memoryRestartWindow)
                     , _memoryRestartLimit(copy._memoryRestartLimit)
                     , _measurement(copy._measurement)
+                    , _history(copy._history)
                     , _operationalEvaluate(copy._operationalEvaluate)
                     , _source(copy._source)
                     , _interval(copy._interval)
@@ -633,6 +894,10 @@ namespace Plugin {
                 {
                     return (_measurement);
                 }
+                inline const Monitor::History& Samples() const
+                {
+                    return (_history);
+                }
                 inline bool HasMeasurement() const
                 {
                     return (((_measurement.Allocated().Min() == Core::NumberType<uint64_t>::Max()) &&
@@ -645,13 +910,19 @@ namespace Plugin {
                 inline void Reset()
                 {
                     _measurement.Reset();
+                    _history.Reset();
                 }
                 inline void Retrigger(uint64_t currentSlot)
                 {
-                    while (_nextSlot < currentSlot) {
-                        _nextSlot += _interval;
+                    // Move to the first slot, on our own grid, that is strictly after the current slot.
+                    if (_nextSlot <= currentSlot) {
+                        _nextSlot += (((currentSlot - _nextSlot) / _interval) + 1) * _interval;
                     }
                 }
+                inline bool IsActive() const
+                {
+                    return (_source != nullptr);
+                }
                 inline void Set(Exchange::IMemory* memory)
                 {
                     if (_source != nullptr) {
@@ -666,32 +937,53 @@ namespace Plugin {
 
                     _measurement.Operational(_source != nullptr);
                 }
-                inline uint32_t Evaluate()
+                inline Exchange::IMemory* Source() const
                 {
-                    uint32_t status(SUCCESFULL);
+                    return (_source);
+                }
+                // Moves on to the next slot and returns the checks (see enum check) that are due in it.
+                inline uint8_t Due()
+                {
+                    uint8_t due(0);
                     if (_source != nullptr) {
                         _operationalSlots -= _interval;
                         _memorySlots -= _interval;
 
                         if ((_operationalInterval != 0) && (_operationalSlots == 0)) {
-                            bool operational = _source->IsOperational();
-                            _measurement.Operational(operational);
-                            if (operational == false) {
-                                status |= NOT_OPERATIONAL;
-                                TRACE_L1("Status not operational. %d", __LINE__);
-                            }
+                            due |= CHECK_OPERATIONAL;
                             _operationalSlots = _operationalInterval;
                         }
                         if ((_memoryInterval != 0) && (_memorySlots == 0)) {
-                            _measurement.Measure(_source);
-
-                            if ((_memoryThreshold != 0) && (_measurement.Resident().Last() > _memoryThreshold)) {
-                                status |= EXCEEDED_MEMORY;
-                                TRACE_L1("Status MetaData Exceeded. %d", __LINE__);
-                            }
+                            due |= CHECK_MEMORY;
                             _memorySlots = _memoryInterval;
                         }
                     }
+                    return (due);
+                }
+                // Takes in the outcome of the checks that were due, the checks themselves call into
+                // the plugin, so they are done by the caller without holding any lock.
+                inline uint32_t Evaluate(const uint8_t due, const bool operational, const Sampler::Sample& sample)
+                {
+                    uint32_t status(SUCCESFULL);
+
+                    if ((due & CHECK_OPERATIONAL) != 0) {
+                        _measurement.Operational(operational);
+                        if (operational == false) {
+                            status |= NOT_OPERATIONAL;
+                            TRACE_L1("Status not operational. %d", __LINE__);
+                        }
+                    }
+                    if ((due & CHECK_MEMORY) != 0) {
+                        _measurement.Measure(sample);
+
+                        if ((_memoryThreshold != 0) && (_measurement.Resident().Last() > _memoryThreshold)) {
+                            status |= EXCEEDED_MEMORY;
+                            TRACE_L1("Status MetaData Exceeded. %d", __LINE__);
+                        }
+                    }
+                    if (due != 0) {
+                        _history.Add(Core::Time::Now().Ticks(), _measurement, ((due & CHECK_MEMORY) != 0));
+                    }
                     return (status);
                 }
 
@@ -711,6 +1003,7 @@ namespace Plugin {
                 uint16_t _memoryRestartWindow;
                 uint8_t _memoryRestartLimit;
                 MetaData _measurement;
+                Monitor::History _history;
                 bool _operationalEvaluate;
                 Exchange::IMemory* _source;
                 uint32_t _interval; //!< The lowest possible interval to check both memory and processes.
@@ -723,7 +1016,14 @@ namespace Plugin {
             MonitorObjects(Monitor* parent)
                 : _adminLock()
                 , _monitor()
-                , _job(Core::ProxyType<Job>::Create(this))
+                , _schedule()
+                , _nextWakeup(NoWakeup)
+                , _generation(0)
+                , _wakeups()
+                , _stopping(false)
+                , _probeDuration()
+                , _probeEvaluated()
+                , _sampler()
                 , _service(nullptr)
                 , _parent(*parent)
             {
@@ -734,6 +1034,7 @@ namespace Plugin {
             virtual ~MonitorObjects()
             {
                 ASSERT(_monitor.size() == 0);
+                ASSERT(_schedule.size() == 0);
             }
 
         public:
@@ -758,17 +1059,20 @@ namespace Plugin {
                         memoryRestartInterval);
                 }
             }
-            inline void Open(PluginHost::IShell* service, Core::JSON::ArrayType<Config::Entry>::Iterator& index)
+            inline void Open(PluginHost::IShell* service, Core::JSON::ArrayType<Config::Entry>::Iterator& index, const uint16_t historyDepth)
             {
                 ASSERT((service != nullptr) && (_service == nullptr));
 
                 uint64_t baseTime = Core::Time::Now().Ticks();
+                uint32_t sampleInterval = static_cast<uint32_t>(~0);
 
                 _service = service;
                 _service->AddRef();
 
                 _adminLock.Lock();
 
+                _stopping = false;
+
                 while (index.Next() == true) {
                     Config::Entry& element(index.Current());
                     string callSign(element.Callsign.Value());
@@ -790,6 +1094,12 @@ namespace Plugin {
                         operationalLimit = element.Restart.Operational.Limit;
                     }
                     SYSLOG(Logging::Startup, (_T("Monitoring: %s (%d,%d).\n"), callSign.c_str(), (interval / 1000000), (memory / 1000000)));
+                    if (memory != 0) {
+                        _sampler.Observe(callSign);
+                        if ((memory / 1000) < sampleInterval) {
+                            sampleInterval = (memory / 1000);
+                        }
+                    }
                     if ((interval != 0) || (memory != 0)) {
                         _monitor.insert(
                             std::pair<string, MonitorObject>(callSign, MonitorObject(
@@ -801,22 +1111,44 @@ namespace Plugin {
 								operationalWindow, 
 								operationalLimit, 
 								memoryWindow, 
-								memoryLimit)));
+								memoryLimit,
+								(element.History.IsSet() == true ? element.History.Value() : historyDepth))));
                     }
                 }
 
                 _adminLock.Unlock();
 
-                PluginHost::WorkerPool::Instance().Submit(_job);
+                if (sampleInterval != static_cast<uint32_t>(~0)) {
+                    _sampler.Interval(sampleInterval);
+                    _sampler.Run();
+                }
+
+                // The probe job gets scheduled as soon as the first observed plugin reports
+                // itself as activated, see StateChange.
             }
             inline void Close()
             {
                 ASSERT(_service != nullptr);
 
-                PluginHost::WorkerPool::Instance().Revoke(_job);
+                // A probe that is running right now should not schedule a wakeup again.
+                _adminLock.Lock();
+                _stopping = true;
+                std::map<uint32_t, Core::ProxyType<Core::IDispatchType<void>>> wakeups(std::move(_wakeups));
+                _wakeups.clear();
+                _adminLock.Unlock();
+
+                for (std::pair<const uint32_t, Core::ProxyType<Core::IDispatchType<void>>>& wakeup : wakeups) {
+                    PluginHost::WorkerPool::Instance().Revoke(wakeup.second);
+                }
+
+                _sampler.Block();
+                _sampler.Wait(Core::Thread::BLOCKED | Core::Thread::STOPPED, Core::infinite);
+                _sampler.Clear();
 
                 _adminLock.Lock();
+                _schedule.clear();
                 _monitor.clear();
+                _nextWakeup = NoWakeup;
                 _adminLock.Unlock();
                 _service->Release();
                 _service = nullptr;
@@ -837,10 +1169,13 @@ namespace Plugin {
                         Exchange::IMemory* memory = service->QueryInterface<Exchange::IMemory>();
 
                         if (memory != nullptr) {
+                            Unschedule(index);
                             index->second.Set(memory);
                             memory->Release();
+                            Schedule(index, Core::Time::Now().Ticks());
                         }
                     } else if (currentState == PluginHost::IShell::DEACTIVATION) {
+                        Unschedule(index);
                         index->second.Set(nullptr);
                     } else if ((currentState == PluginHost::IShell::DEACTIVATED) && (index->second.HasRestartAllowed() == true) && ((service->Reason() == PluginHost::IShell::MEMORY_EXCEEDED) || (service->Reason() == PluginHost::IShell::FAILURE))) {
                         if (index->second.RegisterRestart(service->Reason()) == false) {
@@ -976,66 +1311,326 @@ namespace Plugin {
                 return (found);
             }
 
+            bool Samples(const string& callsign, const uint16_t points, Monitor::HistoryInfo& info) const
+            {
+                bool found = false;
+
+                _adminLock.Lock();
+
+                std::map<string, MonitorObject>::const_iterator index(_monitor.find(callsign));
+
+                if (index != _monitor.end()) {
+                    const Monitor::History& history(index->second.Samples());
+                    const uint16_t count(history.Count());
+
+                    info.Depth = history.Depth();
+                    info.Count = count;
+
+                    if (count > 0) {
+                        // Downsample by merging consecutive samples into buckets. The peak of the
+                        // bucket is reported, so a short spike does not get averaged away.
+                        const uint16_t buckets((points == 0) || (points > count) ? count : points);
+
+                        for (uint16_t bucket = 0; bucket < buckets; bucket++) {
+                            const uint16_t first(static_cast<uint16_t>((static_cast<uint32_t>(bucket) * count) / buckets));
+                            const uint16_t last(static_cast<uint16_t>((static_cast<uint32_t>(bucket + 1) * count) / buckets));
+                            Monitor::History::Sample peak(history[first]);
+
+                            for (uint16_t loop = first + 1; loop < last; loop++) {
+                                const Monitor::History::Sample& entry(history[loop]);
+
+                                if (entry.Measured == true) {
+                                    if (peak.Measured == false) {
+                                        peak.Resident = entry.Resident;
+                                        peak.Allocated = entry.Allocated;
+                                        peak.Shared = entry.Shared;
+                                        peak.Processes = entry.Processes;
+                                        peak.Measured = true;
+                                    } else {
+                                        peak.Resident = std::max(peak.Resident, entry.Resident);
+                                        peak.Allocated = std::max(peak.Allocated, entry.Allocated);
+                                        peak.Shared = std::max(peak.Shared, entry.Shared);
+                                        peak.Processes = std::max(peak.Processes, entry.Processes);
+                                    }
+                                }
+                                peak.Operational = peak.Operational && entry.Operational;
+                            }
+
+                            Monitor::HistoryInfo::SampleInfo& element(info.Samples.Add());
+                            element.Timestamp = Core::Time(peak.Time).ToISO8601();
+                            element.Operational = peak.Operational;
+
+                            // Buckets with operational checks only carry no memory figures.
+                            if (peak.Measured == true) {
+                                element.Resident = peak.Resident;
+                                element.Allocated = peak.Allocated;
+                                element.Shared = peak.Shared;
+                                element.Process = peak.Processes;
+                            }
+                        }
+
+                        std::vector<uint64_t> values;
+                        values.reserve(count);
+
+                        percentiles(history, values, &Monitor::History::Sample::Resident, info.Resident);
+                        percentiles(history, values, &Monitor::History::Sample::Allocated, info.Allocated);
+                        percentiles(history, values, &Monitor::History::Sample::Shared, info.Shared);
+                    }
+
+                    found = true;
+                }
+
+                _adminLock.Unlock();
+
+                return (found);
+            }
+
+            void Statistics(Monitor::ProbeInfo& info) const
+            {
+                _adminLock.Lock();
+
+                info.Duration = _probeDuration;
+                info.Evaluated = _probeEvaluated;
+                info.Ticks = _probeDuration.Measurements();
+                info.Scheduled = static_cast<uint32_t>(_schedule.size());
+
+                _adminLock.Unlock();
+            }
+
             BEGIN_INTERFACE_MAP(MonitorObjects)
             INTERFACE_ENTRY(PluginHost::IPlugin::INotification)
             END_INTERFACE_MAP
 
         private:
-            // Probe can be run in an unlocked state as the destruction of the observer list
-            // is always done if the thread that calls the Probe is blocked (paused)
-            void Probe()
+            static constexpr uint64_t NoWakeup = static_cast<uint64_t>(~0);
+
+            // An entry in the schedule. Entries are ordered on the time slot they are due, the
+            // object address is only used to make entries with an equal time slot unique.
+            class Slot {
+            public:
+                Slot() = delete;
+                Slot& operator=(const Slot&) = delete;
+
+                Slot(const uint64_t time, const std::map<string, MonitorObject>::iterator& entry)
+                    : _time(time)
+                    , _entry(entry)
+                {
+                }
+                Slot(const Slot& copy)
+                    : _time(copy._time)
+                    , _entry(copy._entry)
+                {
+                }
+                ~Slot()
+                {
+                }
+
+            public:
+                inline bool operator<(const Slot& RHS) const
+                {
+                    return ((_time < RHS._time) || ((_time == RHS._time) && (&(_entry->second) < &(RHS._entry->second))));
+                }
+                inline uint64_t Time() const
+                {
+                    return (_time);
+                }
+                inline std::map<string, MonitorObject>::iterator Entry() const
+                {
+                    return (_entry);
+                }
+
+            private:
+                const uint64_t _time;
+                const std::map<string, MonitorObject>::iterator _entry;
+            };
+
+            // The methods below should be called with the _adminLock taken.
+            void Schedule(const std::map<string, MonitorObject>::iterator& index, const uint64_t now)
             {
+                ASSERT(index->second.IsActive() == true);
+
+                index->second.Retrigger(now);
+
+                uint64_t slot(index->second.TimeSlot());
+
+                _schedule.insert(Slot(slot, index));
+
+                // If the current wakeup is later than this slot (or there is none), wake up
+                // earlier. The previously scheduled wakeup becomes stale, see Probe.
+                if ((slot < _nextWakeup) && (_stopping == false)) {
+                    Wakeup(slot + 1000 /* Add 1 ms */);
+                }
+            }
+            void Wakeup(const uint64_t time)
+            {
+                // Every wakeup gets its own generation, only the one scheduled last is current.
+                Core::ProxyType<Core::IDispatchType<void>> job(Core::ProxyType<Job>::Create(this, ++_generation));
+
+                _wakeups.emplace(_generation, job);
+                _nextWakeup = time;
+                PluginHost::WorkerPool::Instance().Schedule(_nextWakeup, job);
+            }
+            void Unschedule(const std::map<string, MonitorObject>::iterator& index)
+            {
+                if (index->second.IsActive() == true) {
+                    _schedule.erase(Slot(index->second.TimeSlot(), index));
+                }
+            }
+
+            // Only the entries that are due are touched, the schedule is ordered on the time slot
+            // of the entries, so the first entry in the schedule determines the next wakeup. The
+            // checks call into the observed plugins, possibly out of process, so they are done
+            // without holding the lock. Taking action on misbehaving plugins is done outside of the
+            // lock as well, as it calls into the framework.
+            void Probe(const uint32_t generation)
+            {
+                struct Check {
+                    string Callsign;
+                    Exchange::IMemory* Source;
+                    uint8_t Due;
+                    bool Operational;
+                    bool Sampled;
+                    Sampler::Sample Sample;
+                };
+
                 uint64_t scheduledTime(Core::Time::Now().Ticks());
-                uint64_t nextSlot(static_cast<uint64_t>(~0));
+                uint64_t evaluated(0);
+                std::list<Check> checks;
+                std::list<std::pair<string, uint32_t>> actions;
 
-                std::map<string, MonitorObject>::iterator index(_monitor.begin());
+                _adminLock.Lock();
+
+                // A wakeup that was superseded by a later Schedule is stale, the current one will
+                // evaluate the due entries and schedule the next wakeup.
+                if ((_stopping == true) || (generation != _generation)) {
+                    _wakeups.erase(generation);
+                    _adminLock.Unlock();
+                    return;
+                }
 
-                // Go through the list of pending observations...
-                while (index != _monitor.end()) {
+                while ((_schedule.empty() == false) && (_schedule.begin()->Time() <= scheduledTime)) {
+                    std::map<string, MonitorObject>::iterator index(_schedule.begin()->Entry());
                     MonitorObject& info(index->second);
 
-                    if (info.TimeSlot() <= scheduledTime) {
-                        uint32_t value(info.Evaluate());
+                    _schedule.erase(_schedule.begin());
 
-                        if ((value & (MonitorObject::NOT_OPERATIONAL | MonitorObject::EXCEEDED_MEMORY)) != 0) {
-                            PluginHost::IShell* plugin(_service->QueryInterfaceByCallsign<PluginHost::IShell>(index->first));
+                    uint8_t due(info.Due());
 
-                            if (plugin != nullptr) {
-                                Core::EnumerateType<PluginHost::IShell::reason> why(((value & MonitorObject::EXCEEDED_MEMORY) != 0) ? PluginHost::IShell::MEMORY_EXCEEDED : PluginHost::IShell::FAILURE);
+                    if (due != 0) {
+                        checks.push_back(Check());
 
-                                const string message("{\"callsign\": \"" + plugin->Callsign() + "\", \"action\": \"Deactivate\", \"reason\": \"" + why.Data() + "\" }");
-                                SYSLOG(Trace::Fatal, (_T("FORCED Shutdown: %s by reason: %s."), plugin->Callsign().c_str(), why.Data()));
+                        Check& check(checks.back());
+                        check.Callsign = index->first;
+                        check.Source = info.Source();
+                        check.Source->AddRef();
+                        check.Due = due;
+                        check.Operational = true;
+                        check.Sampled = (((due & MonitorObject::CHECK_MEMORY) != 0) && (_sampler.Get(index->first, check.Sample) == true));
+                    }
+
+                    info.Retrigger(scheduledTime);
+                    _schedule.insert(Slot(info.TimeSlot(), index));
+                    evaluated++;
+                }
 
-                                _service->Notify(message);
+                if (_schedule.empty() == true) {
+                    _nextWakeup = NoWakeup;
+                } else {
+                    Wakeup(_schedule.begin()->Time() + 1000 /* Add 1 ms */);
+                }
 
-                                _parent.event_action(plugin->Callsign(), "Deactivate", why.Data());
+                _adminLock.Unlock();
 
-                                PluginHost::WorkerPool::Instance().Submit(PluginHost::IShell::Job::Create(plugin, PluginHost::IShell::DEACTIVATED, why.Value()));
+                std::list<Check>::iterator check(checks.begin());
 
-                                plugin->Release();
-                            }
-                        }
-                        info.Retrigger(scheduledTime);
+                while (check != checks.end()) {
+                    if ((check->Due & MonitorObject::CHECK_OPERATIONAL) != 0) {
+                        check->Operational = check->Source->IsOperational();
                     }
+                    if (((check->Due & MonitorObject::CHECK_MEMORY) != 0) && (check->Sampled == false)) {
+                        check->Sample.Resident = check->Source->Resident();
+                        check->Sample.Allocated = check->Source->Allocated();
+                        check->Sample.Shared = check->Source->Shared();
+                        check->Sample.Processes = check->Source->Processes();
+                    }
+                    check++;
+                }
+
+                _adminLock.Lock();
+
+                for (check = checks.begin(); check != checks.end(); check++) {
+                    std::map<string, MonitorObject>::iterator index(_monitor.find(check->Callsign));
 
-                    if (info.TimeSlot() < nextSlot) {
-                        nextSlot = info.TimeSlot();
+                    // The plugin might have been deactivated while it was checked, the outcome is of no value then.
+                    if ((index != _monitor.end()) && (index->second.Source() == check->Source)) {
+                        uint32_t value(index->second.Evaluate(check->Due, check->Operational, check->Sample));
+
+                        if ((value & (MonitorObject::NOT_OPERATIONAL | MonitorObject::EXCEEDED_MEMORY)) != 0) {
+                            actions.push_back(std::pair<string, uint32_t>(check->Callsign, value));
+                        }
                     }
+                }
 
-                    index++;
+                _adminLock.Unlock();
+
+                for (check = checks.begin(); check != checks.end(); check++) {
+                    check->Source->Release();
                 }
 
-                if (nextSlot != static_cast<uint64_t>(~0)) {
-                    if (nextSlot < Core::Time::Now().Ticks()) {
-                        PluginHost::WorkerPool::Instance().Submit(_job);
-                    } else {
-                        nextSlot += 1000 /* Add 1 ms */;
-                        PluginHost::WorkerPool::Instance().Schedule(nextSlot, _job);
+                std::list<std::pair<string, uint32_t>>::const_iterator action(actions.begin());
+
+                while (action != actions.end()) {
+                    PluginHost::IShell* plugin(_service->QueryInterfaceByCallsign<PluginHost::IShell>(action->first));
+
+                    if (plugin != nullptr) {
+                        Core::EnumerateType<PluginHost::IShell::reason> why(((action->second & MonitorObject::EXCEEDED_MEMORY) != 0) ? PluginHost::IShell::MEMORY_EXCEEDED : PluginHost::IShell::FAILURE);
+
+                        const string message("{\"callsign\": \"" + plugin->Callsign() + "\", \"action\": \"Deactivate\", \"reason\": \"" + why.Data() + "\" }");
+                        SYSLOG(Trace::Fatal, (_T("FORCED Shutdown: %s by reason: %s."), plugin->Callsign().c_str(), why.Data()));
+
+                        _service->Notify(message);
+
+                        _parent.event_action(plugin->Callsign(), "Deactivate", why.Data());
+
+                        PluginHost::WorkerPool::Instance().Submit(PluginHost::IShell::Job::Create(plugin, PluginHost::IShell::DEACTIVATED, why.Value()));
+
+                        plugin->Release();
                     }
+
+                    action++;
                 }
+
+                // Only now the wakeup is done, until then Close has to wait for it.
+                _adminLock.Lock();
+                _probeDuration.Set(Core::Time::Now().Ticks() - scheduledTime);
+                _probeEvaluated.Set(evaluated);
+                _wakeups.erase(generation);
+                _adminLock.Unlock();
             }
 
         private:
+            // Nearest-rank percentiles over all memory measurements in the history.
+            static void percentiles(const Monitor::History& history, std::vector<uint64_t>& values, uint64_t Monitor::History::Sample::*field, Monitor::HistoryInfo::PercentileInfo& info)
+            {
+                values.clear();
+
+                for (uint16_t index = 0; index < history.Count(); index++) {
+                    if (history[index].Measured == true) {
+                        values.push_back(history[index].*field);
+                    }
+                }
+
+                if (values.empty() == false) {
+                    const uint32_t count(static_cast<uint32_t>(values.size()));
+
+                    std::sort(values.begin(), values.end());
+
+                    info.P50 = values[((count * 50) + 99) / 100 - 1];
+                    info.P95 = values[((count * 95) + 99) / 100 - 1];
+                    info.P99 = values[((count * 99) + 99) / 100 - 1];
+                }
+            }
+
             template <typename T>
             void translate(const Core::MeasurementType<T>& from, JsonData::Monitor::MeasurementInfo* to)
             {
@@ -1045,9 +1640,16 @@ namespace Plugin {
                 to->Last = from.Last();
             }
 
-            Core::CriticalSection _adminLock;
+            mutable Core::CriticalSection _adminLock;
             std::map<string, MonitorObject> _monitor;
-            Core::ProxyType<Core::IDispatchType<void>> _job;
+            std::set<Slot> _schedule;
+            uint64_t _nextWakeup;
+            uint32_t _generation;
+            std::map<uint32_t, Core::ProxyType<Core::IDispatchType<void>>> _wakeups;
+            bool _stopping;
+            Core::MeasurementType<uint64_t> _probeDuration;
+            Core::MeasurementType<uint64_t> _probeEvaluated;
+            Sampler _sampler;
             PluginHost::IShell* _service;
             Monitor& _parent;
         };
@@ -1120,6 +1722,8 @@ namespace Plugin {
         uint32_t endpoint_restartlimits(const JsonData::Monitor::RestartlimitsParamsData& params);
         uint32_t endpoint_resetstats(const JsonData::Monitor::ResetstatsParamsData& params, JsonData::Monitor::InfoInfo& response);
         uint32_t get_status(const string& index, Core::JSON::ArrayType<JsonData::Monitor::InfoInfo>& response) const;
+        uint32_t get_probestatistics(ProbeInfo& response) const;
+        uint32_t endpoint_history(const HistoryParams& params, HistoryInfo& response);
         void event_action(const string& callsign, const string& action, const string& reason);
     };
 }
@@ -15,14 +15,18 @@ namespace Plugin {
     {
         Register<RestartlimitsParamsData,void>(_T("restartlimits"), &Monitor::endpoint_restartlimits, this);
         Register<ResetstatsParamsData,InfoInfo>(_T("resetstats"), &Monitor::endpoint_resetstats, this);
+        Register<HistoryParams,HistoryInfo>(_T("history"), &Monitor::endpoint_history, this);
         Property<Core::JSON::ArrayType<InfoInfo>>(_T("status"), &Monitor::get_status, nullptr, this);
+        Property<ProbeInfo>(_T("probestatistics"), &Monitor::get_probestatistics, nullptr, this);
     }
 
     void Monitor::UnregisterAll()
     {
         Unregister(_T("resetstats"));
         Unregister(_T("restartlimits"));
+        Unregister(_T("history"));
         Unregister(_T("status"));
+        Unregister(_T("probestatistics"));
     }
 
     // API implementation
@@ -57,6 +61,21 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Method: history - Returns the (downsampled) recent measurements and their percentiles for a plugin watched by the Monitor
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The callsign is not watched by the Monitor
+    uint32_t Monitor::endpoint_history(const HistoryParams& params, HistoryInfo& response)
+    {
+        uint32_t result = Core::ERROR_UNKNOWN_KEY;
+
+        if (_monitor->Samples(params.Callsign.Value(), params.Points.Value(), response) == true) {
+            result = Core::ERROR_NONE;
+        }
+
+        return (result);
+    }
+
     // Property: status - The memory and process statistics either for a single plugin or all plugins watched by the Monitor
     // Return codes:
     //  - ERROR_NONE: Success
@@ -67,6 +86,15 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Property: probestatistics - The cost of the probe ticks evaluating the watched plugins
+    // Return codes:
+    //  - ERROR_NONE: Success
+    uint32_t Monitor::get_probestatistics(ProbeInfo& response) const
+    {
+        _monitor->Statistics(response);
+        return Core::ERROR_NONE;
+    }
+
     // Event: action - Signals action taken by the monitor
     void Monitor::event_action(const string& callsign, const string& action, const string& reason)
     {
@@ -0,0 +1,354 @@
+#ifndef __MONITOR_SAMPLER_H
+#define __MONITOR_SAMPLER_H
+
+#include "Module.h"
+
+#ifndef __WIN32__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // The Sampler collects the memory footprint of all observed plugins that run in a
+    // dedicated host process (WPEProcess, started with "-C <callsign>") in a single pass
+    // over /proc. The pass starts from the children of the framework process and only
+    // descends into the host processes of observed plugins, so only their memory figures
+    // are read. The children of a process are taken from /proc/<pid>/task/<tid>/children,
+    // if the kernel does not provide those, the parent of every process in the system is
+    // read instead (the stat file only). The results are cached until the next pass, so
+    // reading them does not require a (COM-RPC) call into the plugin. Plugins that run in
+    // the framework process itself are not sampled, for those the Exchange::IMemory
+    // interface remains the source.
+    class Sampler : public Core::Thread {
+    private:
+        Sampler(const Sampler&) = delete;
+        Sampler& operator=(const Sampler&) = delete;
+
+        static constexpr uint16_t MaxLineSize = 512;
+        static constexpr uint16_t MaxChildrenSize = 4096;
+
+    public:
+        struct Sample {
+            uint64_t Resident;
+            uint64_t Allocated;
+            uint64_t Shared;
+            uint8_t Processes;
+        };
+
+    public:
+        Sampler()
+            : Core::Thread(Core::Thread::DefaultStackSize(), _T("MonitorSampler"))
+            , _adminLock()
+            , _observables()
+            , _hosts()
+            , _snapshot()
+            , _children()
+            , _interval(1000)
+#ifndef __WIN32__
+            , _pageSize(static_cast<uint64_t>(::sysconf(_SC_PAGESIZE)))
+            , _parent(static_cast<uint32_t>(::getpid()))
+            , _perThread(HasChildren(_parent))
+#else
+            , _pageSize(0)
+            , _parent(0)
+            , _perThread(false)
+#endif
+        {
+        }
+        virtual ~Sampler()
+        {
+            Stop();
+            Wait(Thread::STOPPED | Thread::BLOCKED, Core::infinite);
+        }
+
+    public:
+        // Interval in milliseconds between two passes over /proc.
+        inline void Interval(const uint32_t interval)
+        {
+            ASSERT(interval != 0);
+            _interval = interval;
+        }
+        void Observe(const string& callsign)
+        {
+            _adminLock.Lock();
+            _observables.insert(callsign);
+            _adminLock.Unlock();
+        }
+        void Clear()
+        {
+            _adminLock.Lock();
+            _observables.clear();
+            _snapshot.clear();
+            _hosts.clear();
+            _adminLock.Unlock();
+        }
+        // Returns false if the callsign has no host process of its own (or it is not running),
+        // in which case the caller should fall back to the Exchange::IMemory interface.
+        bool Get(const string& callsign, Sample& sample) const
+        {
+            bool result = false;
+
+            _adminLock.Lock();
+
+            std::map<string, Sample>::const_iterator index(_snapshot.find(callsign));
+
+            if (index != _snapshot.end()) {
+                sample = index->second;
+                result = true;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+
+    private:
+        virtual uint32_t Worker() override
+        {
+            if (IsRunning() == true) {
+                Collect();
+            }
+
+            return (_interval);
+        }
+
+#ifdef __WIN32__
+        void Collect()
+        {
+        }
+#else
+        static uint32_t ReadFile(const char* path, char buffer[], const uint32_t length)
+        {
+            uint32_t result = 0;
+            int fd = ::open(path, O_RDONLY);
+
+            if (fd >= 0) {
+                ssize_t size = ::read(fd, buffer, length - 1);
+
+                if (size > 0) {
+                    result = static_cast<uint32_t>(size);
+                }
+                ::close(fd);
+            }
+            buffer[result] = '\0';
+
+            return (result);
+        }
+        static bool HasChildren(const uint32_t pid)
+        {
+            char path[48];
+
+            // The main thread has the id of the process.
+            ::snprintf(path, sizeof(path), "/proc/%u/task/%u/children", pid, pid);
+
+            return (::access(path, R_OK) == 0);
+        }
+        bool ReadParent(const uint32_t pid, uint32_t& parent) const
+        {
+            char path[32];
+            char buffer[MaxLineSize];
+            bool result = false;
+
+            // The command name in the stat file is enclosed in parentheses and may contain
+            // spaces and parentheses itself, so the fields of interest start after the last ')'.
+            ::snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+            if (ReadFile(path, buffer, sizeof(buffer)) > 0) {
+                const char* marker = ::strrchr(buffer, ')');
+                char state;
+                unsigned int value;
+
+                if ((marker != nullptr) && (::sscanf(marker + 1, " %c %u", &state, &value) == 2)) {
+                    parent = value;
+                    result = true;
+                }
+            }
+
+            return (result);
+        }
+        // Allocated is the data segment (heap and stacks), the total virtual size includes all
+        // mappings, like the shared libraries and reserved but unused address space.
+        bool ReadMemory(const uint32_t pid, Sample& sample) const
+        {
+            char path[32];
+            char buffer[MaxLineSize];
+            unsigned long long size, resident, shared, text, library, data;
+            bool result = false;
+
+            ::snprintf(path, sizeof(path), "/proc/%u/statm", pid);
+            if ((ReadFile(path, buffer, sizeof(buffer)) > 0) && (::sscanf(buffer, "%llu %llu %llu %llu %llu %llu", &size, &resident, &shared, &text, &library, &data) == 6)) {
+                sample.Resident += resident * _pageSize;
+                sample.Allocated += data * _pageSize;
+                sample.Shared += shared * _pageSize;
+                if (sample.Processes < static_cast<uint8_t>(~0)) {
+                    sample.Processes++;
+                }
+                result = true;
+            }
+
+            return (result);
+        }
+        void Children(const uint32_t pid, std::vector<uint32_t>& children) const
+        {
+            if (_perThread == false) {
+                std::pair<std::multimap<uint32_t, uint32_t>::const_iterator, std::multimap<uint32_t, uint32_t>::const_iterator> range(_children.equal_range(pid));
+
+                while (range.first != range.second) {
+                    children.push_back(range.first->second);
+                    range.first++;
+                }
+            } else {
+                char path[48];
+
+                // Every thread lists the children it started itself.
+                ::snprintf(path, sizeof(path), "/proc/%u/task", pid);
+
+                DIR* directory = ::opendir(path);
+
+                if (directory != nullptr) {
+                    char buffer[MaxChildrenSize];
+                    struct dirent* entry;
+
+                    while ((entry = ::readdir(directory)) != nullptr) {
+                        char* end;
+                        unsigned long thread = ::strtoul(entry->d_name, &end, 10);
+
+                        if ((*end == '\0') && (thread != 0)) {
+                            ::snprintf(path, sizeof(path), "/proc/%u/task/%lu/children", pid, thread);
+
+                            ReadFile(path, buffer, sizeof(buffer));
+
+                            const char* location = buffer;
+                            unsigned long child;
+
+                            while (((child = ::strtoul(location, &end, 10)) != 0) && (end != location)) {
+                                children.push_back(static_cast<uint32_t>(child));
+                                location = end;
+                            }
+                        }
+                    }
+
+                    ::closedir(directory);
+                }
+            }
+        }
+        // Host processes are started with "-C <callsign>" on their command line. The command
+        // line of a process does not change, so it is only inspected once per process.
+        string HostCallsign(const uint32_t pid) const
+        {
+            char path[32];
+            char buffer[MaxLineSize];
+            string result;
+
+            ::snprintf(path, sizeof(path), "/proc/%u/cmdline", pid);
+            uint32_t length = ReadFile(path, buffer, sizeof(buffer));
+            uint32_t offset = 0;
+
+            while ((offset < length) && (result.empty() == true)) {
+                const char* argument = &(buffer[offset]);
+                uint32_t size = static_cast<uint32_t>(::strlen(argument));
+
+                offset += size + 1;
+
+                if ((::strcmp(argument, "-C") == 0) && (offset < length)) {
+                    result = string(&(buffer[offset]));
+                }
+            }
+
+            return (result);
+        }
+        void Collect()
+        {
+            std::map<uint32_t, string> hosts;
+            std::map<string, Sample> snapshot;
+            std::vector<uint32_t> children;
+
+            _children.clear();
+
+            // Without the children lists of the kernel, find the parent of every process in the system once.
+            if (_perThread == false) {
+                DIR* directory = ::opendir("/proc");
+
+                if (directory != nullptr) {
+                    struct dirent* entry;
+
+                    while ((entry = ::readdir(directory)) != nullptr) {
+                        char* end;
+                        unsigned long pid = ::strtoul(entry->d_name, &end, 10);
+                        uint32_t parent;
+
+                        if ((*end == '\0') && (pid != 0) && (ReadParent(static_cast<uint32_t>(pid), parent) == true)) {
+                            _children.insert(std::pair<uint32_t, uint32_t>(parent, static_cast<uint32_t>(pid)));
+                        }
+                    }
+
+                    ::closedir(directory);
+                }
+            }
+
+            _adminLock.Lock();
+            std::set<string> observables(_observables);
+            std::map<uint32_t, string> known(_hosts);
+            _adminLock.Unlock();
+
+            // Find the host processes (direct children of the framework) of the observed plugins.
+            Children(_parent, children);
+
+            for (const uint32_t pid : children) {
+                std::map<uint32_t, string>::const_iterator host(known.find(pid));
+                string callsign(host != known.end() ? host->second : HostCallsign(pid));
+
+                hosts.insert(std::pair<uint32_t, string>(pid, callsign));
+
+                if (observables.find(callsign) != observables.end()) {
+                    Sample sample;
+                    sample.Resident = 0;
+                    sample.Allocated = 0;
+                    sample.Shared = 0;
+                    sample.Processes = 0;
+
+                    Accumulate(pid, sample);
+
+                    if (sample.Processes > 0) {
+                        snapshot[callsign] = sample;
+                    }
+                }
+            }
+
+            _adminLock.Lock();
+            _snapshot.swap(snapshot);
+            _hosts.swap(hosts);
+            _adminLock.Unlock();
+        }
+        // Sum the process and all its descendants.
+        void Accumulate(const uint32_t pid, Sample& sample) const
+        {
+            if (ReadMemory(pid, sample) == true) {
+                std::vector<uint32_t> children;
+
+                Children(pid, children);
+
+                for (const uint32_t child : children) {
+                    Accumulate(child, sample);
+                }
+            }
+        }
+#endif
+
+    private:
+        mutable Core::CriticalSection _adminLock;
+        std::set<string> _observables;
+        std::map<uint32_t, string> _hosts;
+        std::map<string, Sample> _snapshot;
+        std::multimap<uint32_t, uint32_t> _children;
+        uint32_t _interval;
+        const uint64_t _pageSize;
+        const uint32_t _parent;
+        const bool _perThread;
+    };
+}
+}
+
+#endif // __MONITOR_SAMPLER_H
@@ -12,6 +12,7 @@
 #include <interfaces/IContentDecryption.h>
 
 #include "CENCParser.h"
+#include "SampleBatch.h"
 
 #include <ocdm/open_cdm.h>
 
@@ -84,6 +85,232 @@ namespace Plugin {
             AccessorOCDM(const AccessorOCDM&) = delete;
             AccessorOCDM& operator=(const AccessorOCDM&) = delete;
 
+            class DataExchange : public ::OCDM::DataExchange, public Core::Thread {
+            private:
+                DataExchange() = delete;
+                DataExchange(const DataExchange&) = delete;
+                DataExchange& operator=(const DataExchange&) = delete;
+
+            public:
+                DataExchange(const string& name, const uint32_t index, const uint32_t defaultSize)
+                    : ::OCDM::DataExchange(name, defaultSize)
+                    , Core::Thread(Core::Thread::DefaultStackSize(), _T("DRMSessionThread"))
+                    , _adminLock()
+                    , _index(index)
+                    , _mediaKeys(nullptr)
+                    , _sessionKey(nullptr)
+                    , _sessionKeyLength(0)
+                    , _samples()
+                    , _exchanges(0)
+                    , _decrypted(0)
+                    , _bytes(0)
+                    , _duration(0)
+                    , _peak(0)
+                {
+                    Core::Thread::Run();
+                    TRACE_L1("Constructing buffer server side: %p - %s", this, name.c_str());
+                }
+                ~DataExchange()
+                {
+                    TRACE_L1("Destructing buffer server side: %p - %s", this, ::OCDM::DataExchange::Name().c_str());
+                    // Make sure the thread reaches a HALT.. We are done.
+                    Core::Thread::Stop();
+
+                    // If the thread is waiting for a semaphore, fake a signal :-)
+                    Produced();
+
+                    Core::Thread::Wait(Core::Thread::STOPPED, Core::infinite);
+                }
+
+            public:
+                inline uint32_t Index() const
+                {
+                    return (_index);
+                }
+                // A buffer, and its thread, outlive the session it is used for, so it can be handed to
+                // the next session without creating a new shared memory region and thread.
+                void Attach(CDMi::IMediaKeySession* mediaKeys)
+                {
+                    ASSERT(mediaKeys != nullptr);
+
+                    _adminLock.Lock();
+
+                    ASSERT(_mediaKeys == nullptr);
+
+                    _mediaKeys = mediaKeys;
+                    _exchanges = 0;
+                    _decrypted = 0;
+                    _bytes = 0;
+                    _duration = 0;
+                    _peak = 0;
+
+                    _adminLock.Unlock();
+                }
+                // Waits for a decrypt in progress to complete.
+                void Detach()
+                {
+                    _adminLock.Lock();
+
+                    if (_exchanges > 0) {
+                        TRACE(Trace::Information, (_T("Decrypt statistics %s: %u requests, %llu samples, %llu bytes, %llu us average, %llu us peak, %llu KB/s"),
+                            ::OCDM::DataExchange::Name().c_str(), _exchanges, static_cast<unsigned long long>(_decrypted), static_cast<unsigned long long>(_bytes),
+                            static_cast<unsigned long long>(_duration / _exchanges), static_cast<unsigned long long>(_peak),
+                            static_cast<unsigned long long>(_duration > 0 ? (_bytes * 1000000 / _duration) / 1024 : 0)));
+                    }
+
+                    _mediaKeys = nullptr;
+
+                    _adminLock.Unlock();
+                }
+
+            private:
+                virtual uint32_t Worker() override
+                {
+
+                    while (IsRunning() == true) {
+
+                        RequestConsume(Core::infinite);
+
+                        if (IsRunning() == true) {
+                            const uint64_t start = Core::Time::Now().Ticks();
+
+                            _adminLock.Lock();
+
+                            if (_mediaKeys == nullptr) {
+                                // The buffer is not (or no longer) used by a session.
+                                Status(static_cast<uint32_t>(~0));
+                            }
+                            // A batch holds several samples, each with its subsample map, which are all
+                            // decrypted before the client is released. Anything else is a single sample.
+                            else if (SampleBatch::Parse(Buffer(), BytesWritten(), _samples) == true) {
+                                DecryptBatch();
+                            } else {
+                                DecryptSample();
+                            }
+
+                            const uint64_t duration = Core::Time::Now().Ticks() - start;
+
+                            _exchanges++;
+                            _duration += duration;
+                            if (duration > _peak) {
+                                _peak = duration;
+                            }
+
+                            _adminLock.Unlock();
+
+                            // Whatever the result, we are done with the buffer..
+                            Consumed();
+                        }
+                    }
+
+                    return (Core::infinite);
+                }
+                void DecryptSample()
+                {
+                    uint32_t clearContentSize = 0;
+                    uint8_t* clearContent = nullptr;
+                    uint8_t keyIdLength = 0;
+                    const uint8_t* keyIdData = KeyId(keyIdLength);
+
+                    _bytes += BytesWritten();
+                    _decrypted++;
+
+                    int cr = _mediaKeys->Decrypt(
+                        _sessionKey,
+                        _sessionKeyLength,
+                        nullptr, //subsamples
+                        0, //number of subsamples
+                        IVKey(),
+                        IVKeyLength(),
+                        Buffer(),
+                        BytesWritten(),
+                        &clearContentSize,
+                        &clearContent,
+                        keyIdLength,
+                        keyIdData,
+                        InitWithLast15());
+                    if ((cr == 0) && (clearContentSize != 0)) {
+                        if (clearContentSize != BytesWritten()) {
+                            TRACE_L1("Returned clear sample size (%d) differs from encrypted buffer size (%d)", clearContentSize, BytesWritten());
+                            Size(clearContentSize);
+                        }
+
+                        // Adjust the buffer on our sied (this process) on what we will write back
+                        SetBuffer(0, clearContentSize, clearContent);
+                    }
+
+                    // Store the status we have for the other side.
+                    Status(static_cast<uint32_t>(cr));
+                }
+                void DecryptBatch()
+                {
+                    uint8_t keyIdLength = 0;
+                    const uint8_t* keyIdData = KeyId(keyIdLength);
+                    uint32_t result = 0;
+
+                    for (const SampleBatch::Sample& sample : _samples) {
+                        uint32_t clearContentSize = 0;
+                        uint8_t* clearContent = nullptr;
+                        uint8_t status[4];
+
+                        _bytes += sample.Length;
+                        _decrypted++;
+
+                        int cr = _mediaKeys->Decrypt(
+                            _sessionKey,
+                            _sessionKeyLength,
+                            (sample.Subsamples.empty() == true ? nullptr : sample.Subsamples.data()),
+                            static_cast<uint32_t>(sample.Subsamples.size()),
+                            sample.IV,
+                            sample.IVLength,
+                            &(Buffer()[sample.DataOffset]),
+                            sample.Length,
+                            &clearContentSize,
+                            &clearContent,
+                            keyIdLength,
+                            keyIdData,
+                            InitWithLast15());
+
+                        if ((cr == 0) && (clearContentSize != 0)) {
+                            if (clearContentSize != sample.Length) {
+                                // The samples are packed, so the clear data has to fit in the place of the encrypted data.
+                                TRACE_L1("Returned clear sample size (%d) differs from encrypted sample size (%d)", clearContentSize, sample.Length);
+                                cr = -1;
+                            } else {
+                                SetBuffer(sample.DataOffset, clearContentSize, clearContent);
+                            }
+                        }
+
+                        SampleBatch::Store(status, static_cast<uint32_t>(cr));
+                        SetBuffer(sample.StatusOffset, sizeof(status), status);
+
+                        if (result == 0) {
+                            result = static_cast<uint32_t>(cr);
+                        }
+                    }
+
+                    // The overall status is that of the first sample that failed.
+                    Status(result);
+                }
+
+            private:
+                Core::CriticalSection _adminLock;
+                const uint32_t _index;
+                CDMi::IMediaKeySession* _mediaKeys;
+                uint8_t* _sessionKey;
+                uint32_t _sessionKeyLength;
+                std::vector<SampleBatch::Sample> _samples;
+                uint32_t _exchanges;
+                uint64_t _decrypted;
+                uint64_t _bytes;
+                uint64_t _duration;
+                uint64_t _peak;
+            };
+
+            // Hands out the shared buffers for the sessions. The buffers are numbered, the lowest free
+            // number is used first, so the names of the shared memory files stay the same over time.
+            // Released buffers are kept (up to the configured number of spares) with their mapping and
+            // thread, so creating a session does not have to set those up again.
             class BufferAdministrator {
             private:
                 BufferAdministrator() = delete;
@@ -91,77 +318,90 @@ namespace Plugin {
                 BufferAdministrator& operator=(const BufferAdministrator&) = delete;
 
             public:
-                BufferAdministrator(const string pathName)
+                BufferAdministrator(const string pathName, const uint32_t defaultSize, const uint8_t spares)
                     : _adminLock()
                     , _basePath(Core::Directory::Normalize(pathName))
-                    , _occupation(0)
+                    , _defaultSize(defaultSize)
+                    , _spares(spares)
+                    , _occupation()
+                    , _available()
                 {
                 }
                 ~BufferAdministrator()
                 {
+                    for (DataExchange* buffer : _available) {
+                        delete buffer;
+                    }
                 }
 
             public:
-                bool AquireBuffer(string& locator)
+                DataExchange* AquireBuffer(CDMi::IMediaKeySession* mediaKeys)
                 {
-                    uint8_t index = 0;
-
-                    locator.clear();
+                    DataExchange* result = nullptr;
 
                     _adminLock.Lock();
 
-                    while ((index < (sizeof(_occupation) * 8)) && ((_occupation & (1 << index)) != 0)) {
-                        index++;
-                    }
+                    if (_available.empty() == false) {
+                        result = _available.back();
+                        _available.pop_back();
+
+                        // Give back the producer side claimed in ReleaseBuffer, so the new client can use it.
+                        result->Consumed();
+                    } else {
+                        uint32_t index = static_cast<uint32_t>(std::find(_occupation.begin(), _occupation.end(), false) - _occupation.begin());
 
-                    // We do not expect more that 4 buffers to be allocated concurrently,
-                    // so more than X would be dramatic
-                    ASSERT(index < (sizeof(_occupation) * 8));
+                        if (index == _occupation.size()) {
+                            _occupation.push_back(true);
+                        } else {
+                            _occupation[index] = true;
+                        }
 
-                    if (index < (sizeof(_occupation) * 8)) {
-                        _occupation |= (1 << index);
-                        locator = _basePath + BufferFileName + Core::NumberType<uint8_t>(index).Text();
+                        result = new DataExchange(_basePath + BufferFileName + Core::NumberType<uint32_t>(index).Text(), index, _defaultSize);
                     }
 
                     _adminLock.Unlock();
 
-                    return (locator.empty() == false);
+                    result->Attach(mediaKeys);
+
+                    return (result);
                 }
-                bool ReleaseBuffer(const string& locator)
+                // A spare buffer is only kept if no client is in the middle of an exchange on it. We claim
+                // the producer side of the buffer to find out: once claimed, a late request of the previous
+                // session can no longer get in, so the next session starts with the buffer in a known state.
+                // The claim is given back when the buffer is handed out again (see Attach).
+                void ReleaseBuffer(DataExchange* buffer)
                 {
+                    ASSERT(buffer != nullptr);
+
+                    buffer->Detach();
 
-                    bool released = false;
+                    const bool idle = (buffer->RequestProduce(0) == Core::ERROR_NONE);
 
-                    if (locator.compare(0, _basePath.length(), _basePath) == 0) {
-                        string actualFile(locator.substr(_basePath.length()));
-                        uint8_t baseLength((sizeof(BufferFileName) / sizeof(TCHAR)) - 1);
+                    _adminLock.Lock();
 
-                        if (actualFile.compare(0, baseLength, BufferFileName) == 0) {
-                            // Than the last part is the number..
-                            uint8_t number(Core::NumberType<uint8_t>(&(actualFile.c_str()[baseLength]), static_cast<uint32_t>(actualFile.length() - baseLength)).Value());
+                    ASSERT(buffer->Index() < _occupation.size());
 
-                            if (number <= (sizeof(_occupation) * 8)) {
-                                _adminLock.Lock();
+                    if ((idle == true) && (_available.size() < _spares)) {
+                        _available.push_back(buffer);
+                        buffer = nullptr;
+                    } else {
+                        _occupation[buffer->Index()] = false;
+                    }
 
-                                if ((_occupation & (1 << number)) != 0) {
-                                    _occupation ^= (1 << number);
-                                    released = true;
-                                } else {
-                                    // Freeing a buffer that is already free sounds dangerous !!!
-                                    ASSERT(false);
-                                }
+                    _adminLock.Unlock();
 
-                                _adminLock.Unlock();
-                            }
-                        }
+                    if (buffer != nullptr) {
+                        delete buffer;
                     }
-                    return (released);
                 }
 
             private:
                 Core::CriticalSection _adminLock;
                 string _basePath;
-                uint16_t _occupation;
+                const uint32_t _defaultSize;
+                const uint8_t _spares;
+                std::vector<bool> _occupation;
+                std::vector<DataExchange*> _available;
             };
 
             // IMediaKeys defines the MediaKeys interface.
@@ -171,93 +411,6 @@ namespace Plugin {
                 SessionImplementation(const SessionImplementation&) = delete;
                 SessionImplementation& operator=(const SessionImplementation&) = delete;
 
-                class DataExchange : public ::OCDM::DataExchange, public Core::Thread {
-                private:
-                    DataExchange() = delete;
-                    DataExchange(const DataExchange&) = delete;
-                    DataExchange& operator=(const DataExchange&) = delete;
-
-                public:
-                    DataExchange(CDMi::IMediaKeySession* mediaKeys, const string& name, const uint32_t defaultSize)
-                        : ::OCDM::DataExchange(name, defaultSize)
-                        , Core::Thread(Core::Thread::DefaultStackSize(), _T("DRMSessionThread"))
-                        , _mediaKeys(mediaKeys)
-                        , _mediaKeysExt(dynamic_cast<CDMi::IMediaKeySessionExt*>(mediaKeys))
-                        , _sessionKey(nullptr)
-                        , _sessionKeyLength(0)
-                    {
-                        Core::Thread::Run();
-                        TRACE_L1("Constructing buffer server side: %p - %s", this, name.c_str());
-                    }
-                    ~DataExchange()
-                    {
-                        TRACE_L1("Destructing buffer server side: %p - %s", this, ::OCDM::DataExchange::Name().c_str());
-                        // Make sure the thread reaches a HALT.. We are done.
-                        Core::Thread::Stop();
-
-                        // If the thread is waiting for a semaphore, fake a signal :-)
-                        Produced();
-
-                        Core::Thread::Wait(Core::Thread::STOPPED, Core::infinite);
-                    }
-
-                private:
-                    virtual uint32_t Worker() override
-                    {
-
-                        while (IsRunning() == true) {
-
-                            uint32_t clearContentSize = 0;
-                            uint8_t* clearContent = nullptr;
-
-                            RequestConsume(Core::infinite);
-
-                            if (IsRunning() == true) {
-                                uint8_t keyIdLength = 0;
-                                const uint8_t* keyIdData = KeyId(keyIdLength);
-
-                                int cr = _mediaKeys->Decrypt(
-                                    _sessionKey,
-                                    _sessionKeyLength,
-                                    nullptr, //subsamples
-                                    0, //number of subsamples
-                                    IVKey(),
-                                    IVKeyLength(),
-                                    Buffer(),
-                                    BytesWritten(),
-                                    &clearContentSize,
-                                    &clearContent,
-                                    keyIdLength,
-                                    keyIdData,
-                                    InitWithLast15());
-                                if ((cr == 0) && (clearContentSize != 0)) {
-                                    if (clearContentSize != BytesWritten()) {
-                                        TRACE_L1("Returned clear sample size (%d) differs from encrypted buffer size (%d)", clearContentSize, BytesWritten());
-                                        Size(clearContentSize);
-                                    }
-
-                                    // Adjust the buffer on our sied (this process) on what we will write back
-                                    SetBuffer(0, clearContentSize, clearContent);
-                                }
-
-                                // Store the status we have for the other side.
-                                Status(static_cast<uint32_t>(cr));
-
-                                // Whatever the result, we are done with the buffer..
-                                Consumed();
-                            }
-                        }
-
-                        return (Core::infinite);
-                    }
-
-                private:
-                    CDMi::IMediaKeySession* _mediaKeys;
-                    CDMi::IMediaKeySessionExt* _mediaKeysExt;
-                    uint8_t* _sessionKey;
-                    uint32_t _sessionKeyLength;
-                };
-
                 // IMediaKeys defines the MediaKeys interface.
                 class Sink : public CDMi::IMediaKeySessionCallback {
                 private:
@@ -357,8 +510,7 @@ namespace Plugin {
                     const std::string keySystem,
                     CDMi::IMediaKeySession* mediaKeySession,
                     ::OCDM::ISession::ICallback* callback,
-                    const string bufferName,
-                    const uint32_t defaultSize,
+                    DataExchange* buffer,
                     const CommonEncryptionData* sessionData)
                     : _parent(*parent)
                     , _refCount(1)
@@ -367,15 +519,16 @@ namespace Plugin {
                     , _mediaKeySession(mediaKeySession)
                     , _mediaKeySessionExt(nullptr)
                     , _sink(this, callback)
-                    , _buffer(new DataExchange(mediaKeySession, bufferName, defaultSize))
+                    , _buffer(buffer)
                     , _cencData(*sessionData)
                 {
                     ASSERT(parent != nullptr);
                     ASSERT(sessionData != nullptr);
                     ASSERT(_mediaKeySession != nullptr);
+                    ASSERT(_buffer != nullptr);
 
                     _mediaKeySession->Run(&_sink);
-                    TRACE(Trace::Information, ("Server::Session::Session(%s,%s,%s) => %p", _keySystem.c_str(), _sessionId.c_str(), bufferName.c_str(), this));
+                    TRACE(Trace::Information, ("Server::Session::Session(%s,%s,%s) => %p", _keySystem.c_str(), _sessionId.c_str(), _buffer->Name().c_str(), this));
                     TRACE_L1("Constructed the Session Server side: %p", this);
                 }
 
@@ -384,8 +537,7 @@ namespace Plugin {
                     const std::string keySystem,
                     CDMi::IMediaKeySessionExt* mediaKeySession,
                     ::OCDM::ISession::ICallback* callback,
-                    const string bufferName,
-                    const uint32_t defaultSize,
+                    DataExchange* buffer,
                     const CommonEncryptionData* sessionData)
                     : _parent(*parent)
                     , _refCount(1)
@@ -394,7 +546,7 @@ namespace Plugin {
                     , _mediaKeySession(dynamic_cast<CDMi::IMediaKeySession*>(mediaKeySession))
                     , _mediaKeySessionExt(mediaKeySession)
                     , _sink(this, callback)
-                    , _buffer(new DataExchange(dynamic_cast<CDMi::IMediaKeySession*>(mediaKeySession), bufferName, defaultSize))
+                    , _buffer(buffer)
                     , _cencData(*sessionData)
                 {
                     ASSERT(parent != nullptr);
@@ -417,8 +569,6 @@ namespace Plugin {
                     // the parent to lock handing out new entries before we clear.
                     _parent.Remove(this, _keySystem, _mediaKeySession);
 
-                    delete _buffer;
-
                     TRACE(Trace::Information, ("Server::Session::~Session(%s,%s) => %p", _keySystem.c_str(), _sessionId.c_str(), this));
                     TRACE_L1("Destructed the Session Server side: %p", this);
                 }
@@ -447,6 +597,11 @@ namespace Plugin {
                     return (_buffer->Name());
                 }
 
+                inline DataExchange* Buffer() const
+                {
+                    return (_buffer);
+                }
+
                 virtual std::string BufferIdExt() const override
                 {
                     return (_buffer->Name());
@@ -580,11 +735,10 @@ namespace Plugin {
             };
 
         public:
-            AccessorOCDM(OCDMImplementation* parent, const string& name, const uint32_t defaultSize)
+            AccessorOCDM(OCDMImplementation* parent, const string& name, const uint32_t defaultSize, const uint8_t spares)
                 : _parent(*parent)
                 , _adminLock()
-                , _administrator(name)
-                , _defaultSize(defaultSize)
+                , _administrator(name, defaultSize, spares)
                 , _sessionList()
                 , _observers()
             {
@@ -681,12 +835,12 @@ namespace Plugin {
 
                         if (sessionInterface != nullptr) {
 
-                            std::string bufferId;
+                            DataExchange* buffer = _administrator.AquireBuffer(sessionInterface);
 
                             // See if there is a buffer available we can use..
-                            if (_administrator.AquireBuffer(bufferId) == true) {
+                            if (buffer != nullptr) {
 
-                                SessionImplementation* newEntry = Core::Service<SessionImplementation>::Create<SessionImplementation>(this, keySystem, sessionInterface, callback, bufferId, _defaultSize, &keyIds);
+                                SessionImplementation* newEntry = Core::Service<SessionImplementation>::Create<SessionImplementation>(this, keySystem, sessionInterface, callback, buffer, &keyIds);
 
                                 session = newEntry;
                                 sessionId = newEntry->SessionId();
@@ -766,12 +920,12 @@ namespace Plugin {
 
                         if (sessionInterface != nullptr) {
 
-                            std::string bufferId;
+                            DataExchange* buffer = _administrator.AquireBuffer(dynamic_cast<CDMi::IMediaKeySession*>(sessionInterface));
 
                             // See if there is a buffer available we can use..
-                            if (_administrator.AquireBuffer(bufferId) == true) {
+                            if (buffer != nullptr) {
 
-                                SessionImplementation* newEntry = Core::Service<SessionImplementation>::Create<SessionImplementation>(this, keySystem, sessionInterface, callback, bufferId, _defaultSize, &keyIds);
+                                SessionImplementation* newEntry = Core::Service<SessionImplementation>::Create<SessionImplementation>(this, keySystem, sessionInterface, callback, buffer, &keyIds);
 
                                 session = newEntry;
 
@@ -1042,10 +1196,33 @@ namespace Plugin {
             }
             void Remove(SessionImplementation* session, const string& keySystem, CDMi::IMediaKeySession* mediaKeySession)
             {
+                ASSERT(session != nullptr);
+
+                bool found = false;
 
                 _adminLock.Lock();
 
-                ASSERT(session != nullptr);
+                if (session != nullptr) {
+
+                    std::list<SessionImplementation*>::iterator index(std::find(_sessionList.begin(), _sessionList.end(), session));
+
+                    ASSERT(index != _sessionList.end());
+
+                    if (index != _sessionList.end()) {
+                        _sessionList.erase(index);
+                        found = true;
+                    }
+                }
+
+                _adminLock.Unlock();
+
+                // Make sure the buffer is done with the session, before the session is destroyed. This
+                // waits for a decrypt in progress, so it is done without holding the lock.
+                if (session != nullptr) {
+                    _administrator.ReleaseBuffer(session->Buffer());
+                }
+
+                _adminLock.Lock();
 
                 if (mediaKeySession != nullptr) {
 
@@ -1068,24 +1245,8 @@ namespace Plugin {
                     }
                 }
 
-                if (session != nullptr) {
-
-                    _administrator.ReleaseBuffer(session->BufferId());
-
-                    std::list<SessionImplementation*>::iterator index(_sessionList.begin());
-
-                    while ((index != _sessionList.end()) && (session != (*index))) {
-                        index++;
-                    }
-
-                    ASSERT(index != _sessionList.end());
-
-                    if (index != _sessionList.end()) {
-                        const string sessionId(session->SessionId());
-                        // Before we remove it here, release it.
-                        _sessionList.erase(index);
-                        ReportDestroy(sessionId);
-                    }
+                if (found == true) {
+                    ReportDestroy(session->SessionId());
                 }
 
                 _adminLock.Unlock();
@@ -1095,7 +1256,6 @@ namespace Plugin {
             OCDMImplementation& _parent;
             mutable Core::CriticalSection _adminLock;
             BufferAdministrator _administrator;
-            uint32_t _defaultSize;
             std::list<SessionImplementation*> _sessionList;
             std::list<::OCDM::IAccessorOCDM::INotification*> _observers;
         };
@@ -1147,12 +1307,14 @@ namespace Plugin {
                 , Connector(_T("/tmp/ocdm"))
                 , SharePath(_T("/tmp"))
                 , ShareSize(8 * 1024)
+                , ShareSpares(4)
                 , KeySystems()
             {
                 Add(_T("location"), &Location);
                 Add(_T("connector"), &Connector);
                 Add(_T("sharepath"), &SharePath);
                 Add(_T("sharesize"), &ShareSize);
+                Add(_T("sharespares"), &ShareSpares);
                 Add(_T("systems"), &KeySystems);
             }
             ~Config()
@@ -1164,6 +1326,7 @@ namespace Plugin {
             Core::JSON::String Connector;
             Core::JSON::String SharePath;
             Core::JSON::DecUInt32 ShareSize;
+            Core::JSON::DecUInt8 ShareSpares; // Number of released buffers kept for new sessions
             Core::JSON::ArrayType<Systems> KeySystems;
         };
 
@@ -1269,7 +1432,7 @@ namespace Plugin {
                 SYSLOG(Logging::Startup, (_T("No DRM factories specified. OCDM can not service any DRM requests.")));
             }
 
-            _entryPoint = Core::Service<AccessorOCDM>::Create<::OCDM::IAccessorOCDM>(this, config.SharePath.Value(), config.ShareSize.Value());
+            _entryPoint = Core::Service<AccessorOCDM>::Create<::OCDM::IAccessorOCDM>(this, config.SharePath.Value(), config.ShareSize.Value(), config.ShareSpares.Value());
             Core::ProxyType<RPC::InvokeServer> server = Core::ProxyType<RPC::InvokeServer>::Create(&Core::WorkerPool::Instance());
             _service = new ExternalAccess(Core::NodeId(config.Connector.Value().c_str()), _entryPoint, server);
 
@@ -0,0 +1,133 @@
+#pragma once
+
+// Layout of a batch of samples in the shared buffer of a decrypt session. Instead of a single
+// sample, a client can put several samples, each with its own IV and subsample map, in the
+// buffer, so they are all decrypted with a single request to the server. The server recognizes
+// a batch by its header and only accepts it if the sample records exactly fill the buffer, any
+// other content is handled as a single sample, as before.
+// This header is meant to be shared with the client side and should not depend on the framework.
+//
+// The batch starts with a header: Magic (8 bytes) - Version (2) - Count (2). After that Count
+// samples follow. All values are stored little endian.
+//
+//   sample: status (4) - length (4) - IV length (1) - IV (16) - subsample count (2)
+//           - subsamples: { clear bytes (4) - encrypted bytes (4) } * subsample count
+//           - data (length)
+//
+// The status is filled in by the server with the result of decrypting the sample, the data is
+// replaced, in place, by the clear data. A sample without subsamples is fully encrypted.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+namespace SampleBatch {
+
+    static const char Magic[8] = { 'O', 'C', 'D', 'M', 'B', 'T', 'C', 'H' };
+    static const uint16_t Version = 1;
+    static const uint32_t HeaderSize = sizeof(Magic) + 2 + 2;
+    static const uint8_t MaxIVLength = 16;
+    static const uint32_t SampleHeaderSize = 4 + 4 + 1 + MaxIVLength + 2;
+
+    struct Sample {
+        uint32_t StatusOffset;
+        uint32_t DataOffset;
+        uint32_t Length;
+        const uint8_t* IV;
+        uint8_t IVLength;
+        // Pairs of clear and encrypted byte counts, in the form the CDMi Decrypt expects them.
+        std::vector<uint32_t> Subsamples;
+    };
+
+    inline uint8_t* Store(uint8_t* buffer, const uint16_t value)
+    {
+        buffer[0] = static_cast<uint8_t>(value & 0xFF);
+        buffer[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        return (buffer + 2);
+    }
+    inline uint8_t* Store(uint8_t* buffer, const uint32_t value)
+    {
+        Store(buffer, static_cast<uint16_t>(value & 0xFFFF));
+        Store(buffer + 2, static_cast<uint16_t>((value >> 16) & 0xFFFF));
+        return (buffer + 4);
+    }
+    inline const uint8_t* Load(const uint8_t* buffer, uint16_t& value)
+    {
+        value = static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+        return (buffer + 2);
+    }
+    inline const uint8_t* Load(const uint8_t* buffer, uint32_t& value)
+    {
+        uint16_t low, high;
+        Load(buffer, low);
+        Load(buffer + 2, high);
+        value = (static_cast<uint32_t>(high) << 16) | low;
+        return (buffer + 4);
+    }
+
+    // Returns false if the buffer does not hold a complete and consistent batch.
+    inline bool Parse(const uint8_t buffer[], const uint32_t length, std::vector<Sample>& samples)
+    {
+        uint16_t version, count;
+        bool result = (length >= HeaderSize) && (::memcmp(buffer, Magic, sizeof(Magic)) == 0);
+
+        samples.clear();
+
+        if (result == true) {
+            Load(Load(&(buffer[sizeof(Magic)]), version), count);
+
+            result = (version == Version) && (count > 0);
+        }
+
+        uint32_t offset = HeaderSize;
+
+        while ((result == true) && (samples.size() < count)) {
+            result = ((offset + SampleHeaderSize) <= length);
+
+            if (result == true) {
+                Sample sample;
+                uint16_t subsamples;
+
+                sample.StatusOffset = offset;
+                Load(&(buffer[offset + 4]), sample.Length);
+                sample.IVLength = buffer[offset + 8];
+                sample.IV = &(buffer[offset + 9]);
+                Load(&(buffer[offset + 9 + MaxIVLength]), subsamples);
+
+                offset += SampleHeaderSize;
+
+                result = (sample.IVLength <= MaxIVLength) && ((offset + (subsamples * 8)) <= length);
+
+                if (result == true) {
+                    uint64_t covered = 0;
+
+                    sample.Subsamples.resize(subsamples * 2);
+
+                    for (uint32_t index = 0; index < sample.Subsamples.size(); index++) {
+                        Load(&(buffer[offset]), sample.Subsamples[index]);
+                        covered += sample.Subsamples[index];
+                        offset += 4;
+                    }
+
+                    sample.DataOffset = offset;
+
+                    // The subsamples, if any, must describe exactly the data of the sample.
+                    result = ((static_cast<uint64_t>(offset) + sample.Length) <= length) && ((subsamples == 0) || (covered == sample.Length));
+
+                    offset += sample.Length;
+                }
+
+                if (result == true) {
+                    samples.push_back(std::move(sample));
+                }
+            }
+        }
+
+        return ((result == true) && (offset == length));
+    }
+}
+}
+}
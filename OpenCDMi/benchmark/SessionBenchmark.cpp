@@ -0,0 +1,204 @@
+// Measures how long creating and destroying a media key session takes at the OCDM plugin when
+// many sessions come and go at the same time, like multi-view and picture-in-picture with key
+// rotation. Each client thread repeatedly constructs a session, keeps it for a while and destructs
+// it again, through the same client library the players use.
+//
+//     SessionBenchmark [-s <server>] [-k <key system>] [-c <sessions>] [-r <rounds>] [-h <hold ms>]
+//
+// By default 64 sessions of org.w3.clearkey are cycled 20 times against the server at
+// 127.0.0.1:7912. Every session gets CENC init data with a key id of its own.
+
+#include <ocdm/open_cdm.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// A version 1 'pssh' box of the common system id, holding one key id.
+std::vector<uint8_t> InitData(const uint32_t session, const uint32_t round)
+{
+    static const uint8_t SystemId[] = { 0x10, 0x77, 0xef, 0xec, 0xc0, 0xb2, 0x4d, 0x02, 0xac, 0xe3, 0x3c, 0x1e, 0x52, 0xe2, 0xfb, 0x4b };
+
+    std::vector<uint8_t> box;
+    const uint32_t size = 4 + 4 + 4 + sizeof(SystemId) + 4 + 16 + 4;
+
+    box.push_back(static_cast<uint8_t>(size >> 24));
+    box.push_back(static_cast<uint8_t>(size >> 16));
+    box.push_back(static_cast<uint8_t>(size >> 8));
+    box.push_back(static_cast<uint8_t>(size));
+    box.insert(box.end(), { 'p', 's', 's', 'h', 0x01, 0x00, 0x00, 0x00 });
+    box.insert(box.end(), SystemId, SystemId + sizeof(SystemId));
+    box.insert(box.end(), { 0x00, 0x00, 0x00, 0x01 });
+
+    for (uint8_t index = 0; index < 16; index += 8) {
+        box.push_back(static_cast<uint8_t>(session >> 24));
+        box.push_back(static_cast<uint8_t>(session >> 16));
+        box.push_back(static_cast<uint8_t>(session >> 8));
+        box.push_back(static_cast<uint8_t>(session));
+        box.push_back(static_cast<uint8_t>(round >> 24));
+        box.push_back(static_cast<uint8_t>(round >> 16));
+        box.push_back(static_cast<uint8_t>(round >> 8));
+        box.push_back(static_cast<uint8_t>(round));
+    }
+
+    box.insert(box.end(), { 0x00, 0x00, 0x00, 0x00 });
+
+    return (box);
+}
+
+struct Measurements {
+    std::vector<double> Create; // ms
+    std::vector<double> Destroy; // ms
+    uint32_t Failures = 0;
+};
+
+void Client(OpenCDMAccessor* system, const std::string& keySystem, const uint32_t session, const uint32_t rounds, const uint32_t hold, std::atomic<bool>& start, Measurements& result)
+{
+    while (start.load() == false) {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        const std::vector<uint8_t> initData(InitData(session, round));
+        OpenCDMSession* media = nullptr;
+
+        Clock::time_point begin = Clock::now();
+
+        OpenCDMError error = opencdm_construct_session(system, keySystem.c_str(), Temporary, "cenc",
+            initData.data(), static_cast<uint16_t>(initData.size()), nullptr, 0, nullptr, nullptr, &media);
+
+        Clock::time_point end = Clock::now();
+
+        if ((error != ERROR_NONE) || (media == nullptr)) {
+            result.Failures++;
+        } else {
+            result.Create.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(hold));
+
+            begin = Clock::now();
+            opencdm_destruct_session(media);
+            end = Clock::now();
+
+            result.Destroy.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+    }
+}
+
+void Report(const char name[], std::vector<double>& samples)
+{
+    if (samples.empty() == true) {
+        printf("%-8s no samples\n", name);
+    } else {
+        std::sort(samples.begin(), samples.end());
+
+        double total = 0;
+        for (double sample : samples) {
+            total += sample;
+        }
+
+        printf("%-8s %8.3f %8.3f %8.3f %8.3f %8.3f ms (%u samples)\n", name,
+            samples.front(), total / samples.size(), samples[samples.size() / 2],
+            samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)], samples.back(),
+            static_cast<uint32_t>(samples.size()));
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string server("127.0.0.1:7912");
+    std::string keySystem("org.w3.clearkey");
+    uint32_t sessions = 64;
+    uint32_t rounds = 20;
+    uint32_t hold = 10;
+    int option;
+
+    while ((option = getopt(argc, argv, "s:k:c:r:h:")) != -1) {
+        switch (option) {
+        case 's':
+            server = optarg;
+            break;
+        case 'k':
+            keySystem = optarg;
+            break;
+        case 'c':
+            sessions = std::max(atoi(optarg), 1);
+            break;
+        case 'r':
+            rounds = std::max(atoi(optarg), 1);
+            break;
+        case 'h':
+            hold = std::max(atoi(optarg), 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s <server>] [-k <key system>] [-c <sessions>] [-r <rounds>] [-h <hold ms>]\n", argv[0]);
+            return (1);
+        }
+    }
+
+    setenv("OPEN_CDM_SERVER", server.c_str(), 1);
+
+    OpenCDMAccessor* system = opencdm_create_system();
+
+    if (system == nullptr) {
+        fprintf(stderr, "Could not connect to the OCDM server at %s\n", server.c_str());
+        return (1);
+    }
+
+    if (opencdm_is_type_supported(system, keySystem.c_str(), "") != ERROR_NONE) {
+        fprintf(stderr, "Key system %s is not supported\n", keySystem.c_str());
+        opencdm_destruct_system(system);
+        return (1);
+    }
+
+    std::vector<Measurements> measurements(sessions);
+    std::vector<std::thread> clients;
+    std::atomic<bool> start(false);
+
+    for (uint32_t index = 0; index < sessions; index++) {
+        clients.emplace_back(Client, system, std::cref(keySystem), index, rounds, hold, std::ref(start), std::ref(measurements[index]));
+    }
+
+    Clock::time_point begin = Clock::now();
+    start = true;
+
+    for (std::thread& client : clients) {
+        client.join();
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    Measurements total;
+
+    for (Measurements& entry : measurements) {
+        total.Create.insert(total.Create.end(), entry.Create.begin(), entry.Create.end());
+        total.Destroy.insert(total.Destroy.end(), entry.Destroy.begin(), entry.Destroy.end());
+        total.Failures += entry.Failures;
+    }
+
+    printf("%u concurrent sessions of %s, %u rounds, held for %u ms, in %.2f s\n\n", sessions, keySystem.c_str(), rounds, hold, elapsed);
+    printf("%-8s %8s %8s %8s %8s %8s\n", "", "min", "mean", "median", "p99", "max");
+    Report("create", total.Create);
+    Report("destroy", total.Destroy);
+
+    if (total.Failures != 0) {
+        printf("\n%u session(s) could not be created\n", total.Failures);
+    }
+
+    opencdm_destruct_system(system);
+
+    return (total.Failures == 0 ? 0 : 1);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Module.h"
+
+#include <atomic>
+
+namespace WPEFramework {
+namespace Remotes {
+
+    // Queue of elements for exactly one producer thread and one consumer thread. The producer only
+    // moves the head, the consumer only moves the tail, so neither side needs a lock. The elements
+    // are filled and read in place: a slot handed out by Reserve() belongs to the producer until it
+    // is committed, a slot handed out by Front() belongs to the consumer until it is popped. Both
+    // positions run freely and are masked on access, which requires the size to be a power of two.
+    template <typename ELEMENT, const uint32_t SIZE>
+    class EventQueue {
+    private:
+        EventQueue(const EventQueue<ELEMENT, SIZE>&) = delete;
+        EventQueue<ELEMENT, SIZE>& operator=(const EventQueue<ELEMENT, SIZE>&) = delete;
+
+        static_assert((SIZE != 0) && ((SIZE & (SIZE - 1)) == 0), "The size of an EventQueue must be a power of two");
+
+    public:
+        EventQueue()
+            : _head(0)
+            , _tail(0)
+        {
+        }
+        ~EventQueue()
+        {
+        }
+
+    public:
+        inline bool IsEmpty() const
+        {
+            return (_head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire));
+        }
+        // Producer side, returns nullptr if the queue is full.
+        ELEMENT* Reserve()
+        {
+            const uint32_t head = _head.load(std::memory_order_relaxed);
+
+            return ((head - _tail.load(std::memory_order_acquire)) < SIZE ? &(_elements[head & (SIZE - 1)]) : nullptr);
+        }
+        void Commit()
+        {
+            _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        // Consumer side, returns the element at the given distance from the tail, or nullptr if the
+        // queue holds fewer elements.
+        ELEMENT* Front(const uint32_t offset = 0)
+        {
+            const uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+            return ((_head.load(std::memory_order_acquire) - tail) > offset ? &(_elements[(tail + offset) & (SIZE - 1)]) : nullptr);
+        }
+        void Pop()
+        {
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<uint32_t> _head;
+        std::atomic<uint32_t> _tail;
+        ELEMENT _elements[SIZE];
+    };
+}
+}
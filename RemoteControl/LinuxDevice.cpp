@@ -4,6 +4,13 @@
 #include <libudev.h>
 #include <linux/uinput.h>
 
+// Kernel headers before 4.16 do not offer these yet, they are the only option for 32 bit
+// builds with a 64 bit time_t.
+#ifndef input_event_sec
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
 namespace WPEFramework {
 namespace Plugin {
 
@@ -638,13 +645,17 @@ namespace Plugin {
         }
         bool HandleInput(const int fd)
         {
-            input_event entry[16];
+            input_event entry[64];
             int index = 0;
             int result = ::read(fd, entry, sizeof(entry));
 
             if (result > 0) {
                 while (result >= static_cast<int>(sizeof(input_event))) {
                     ASSERT(index < static_cast<int>((sizeof(entry) / sizeof(input_event))));
+
+                    // The kernel stamps the events with the realtime clock, so they can be compared to our ticks.
+                    Remotes::RemoteAdministrator::Origin((static_cast<uint64_t>(entry[index].input_event_sec) * 1000000) + entry[index].input_event_usec);
+
                     for (auto& device : _inputDevices) {
                         if (device->HandleInput(entry[index].code,  entry[index].type, entry[index].value) == true) {
                             break;
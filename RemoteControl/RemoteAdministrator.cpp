@@ -3,6 +3,8 @@
 namespace WPEFramework {
 namespace Remotes {
 
+    /* static */ thread_local uint64_t RemoteAdministrator::_origin = 0;
+
     /* static */ RemoteAdministrator& RemoteAdministrator::Instance()
     {
         static RemoteAdministrator singleton;
@@ -1,17 +1,277 @@
 #pragma once
 
 #include "Module.h"
+#include "EventQueue.h"
 #include <interfaces/IKeyHandler.h>
 
 namespace WPEFramework {
 namespace Remotes {
 
+    // The producers do not call the handlers directly. Every producer gets a channel of its own, and
+    // as a producer reports from a single thread, the channel is a lock free queue with one producer
+    // and one consumer. A single dispatcher thread drains the channels, in the order in which the
+    // events were queued over all channels, and hands them to the handlers. So a producer is never
+    // held up by whatever holds a lock in the handlers, e.g. a JSON-RPC call or a pairing. Series of
+    // pointer motion or wheel events that are waiting are merged into one event. The time from the
+    // origin of an event till its dispatch is kept in a histogram per kind of event.
     class RemoteAdministrator {
+    public:
+        enum kind : uint8_t {
+            KEY,
+            WHEEL,
+            POINTER,
+            TOUCH
+        };
+
+        // The first bucket holds the events dispatched within 250us, every next bucket holds the events
+        // that took up to twice as long as the previous one, the last bucket holds all the rest.
+        static constexpr uint8_t Buckets = 10;
+        static constexpr uint32_t FirstBucket = 250;
+
+        struct Statistics {
+            uint32_t Events;
+            uint32_t Coalesced;
+            uint32_t Dropped;
+            uint32_t Maximum;
+            uint32_t Histogram[Buckets];
+        };
+
     private:
         RemoteAdministrator(const RemoteAdministrator&);
         RemoteAdministrator& operator=(const RemoteAdministrator&);
+
+        static constexpr uint32_t QueueSize = 64;
+
+        struct Event {
+            enum type : uint8_t {
+                KEY,
+                AXIS,
+                BUTTON,
+                MOTION,
+                TOUCH
+            };
+
+            type Type;
+            bool Pressed;
+            uint8_t Index;
+            Exchange::ITouchHandler::touchstate State;
+            uint32_t Code;
+            int32_t X;
+            int32_t Y;
+            uint32_t Sequence;
+            uint64_t Origin;
+            string MapName;
+        };
+
+        class Channel : public Exchange::IKeyHandler, public Exchange::IWheelHandler,
+                        public Exchange::IPointerHandler, public Exchange::ITouchHandler {
+        public:
+            Channel() = delete;
+            Channel(const Channel&) = delete;
+            Channel& operator=(const Channel&) = delete;
+
+            Channel(RemoteAdministrator* parent, const void* source)
+                : _parent(*parent)
+                , _source(source)
+                , _queue()
+            {
+                ASSERT(parent != nullptr);
+            }
+            virtual ~Channel()
+            {
+            }
+
+        public:
+            inline const void* Source() const
+            {
+                return (_source);
+            }
+            inline EventQueue<Event, QueueSize>& Queue()
+            {
+                return (_queue);
+            }
+
+            uint32_t KeyEvent(const bool pressed, const uint32_t code, const string& mapName) override
+            {
+                uint32_t result = Core::ERROR_UNAVAILABLE;
+                Event* slot = Reserve(RemoteAdministrator::KEY, true);
+
+                if (slot != nullptr) {
+                    slot->Type = Event::KEY;
+                    slot->Pressed = pressed;
+                    slot->Code = code;
+                    slot->MapName = mapName;
+                    result = Commit(slot);
+                }
+
+                return (result);
+            }
+            uint32_t AxisEvent(const int16_t x, const int16_t y) override
+            {
+                return (Motion(Event::AXIS, RemoteAdministrator::WHEEL, x, y));
+            }
+            uint32_t PointerButtonEvent(const bool pressed, const uint8_t button) override
+            {
+                uint32_t result = Core::ERROR_UNAVAILABLE;
+                Event* slot = Reserve(RemoteAdministrator::POINTER, true);
+
+                if (slot != nullptr) {
+                    slot->Type = Event::BUTTON;
+                    slot->Pressed = pressed;
+                    slot->Index = button;
+                    result = Commit(slot);
+                }
+
+                return (result);
+            }
+            uint32_t PointerMotionEvent(const int16_t x, const int16_t y) override
+            {
+                return (Motion(Event::MOTION, RemoteAdministrator::POINTER, x, y));
+            }
+            uint32_t TouchEvent(const uint8_t index, const touchstate state, const uint16_t x, const uint16_t y) override
+            {
+                uint32_t result = Core::ERROR_UNAVAILABLE;
+                Event* slot = Reserve(RemoteAdministrator::TOUCH, true);
+
+                if (slot != nullptr) {
+                    slot->Type = Event::TOUCH;
+                    slot->Index = index;
+                    slot->State = state;
+                    slot->X = x;
+                    slot->Y = y;
+                    result = Commit(slot);
+                }
+
+                return (result);
+            }
+            Exchange::IKeyProducer* Producer(const string& name) override
+            {
+                return (_parent._keyCallback != nullptr ? _parent._keyCallback->Producer(name) : nullptr);
+            }
+            Exchange::IWheelProducer* WheelProducer(const string& name) override
+            {
+                return (_parent._wheelCallback != nullptr ? _parent._wheelCallback->WheelProducer(name) : nullptr);
+            }
+            Exchange::IPointerProducer* PointerProducer(const string& name) override
+            {
+                return (_parent._pointerCallback != nullptr ? _parent._pointerCallback->PointerProducer(name) : nullptr);
+            }
+            Exchange::ITouchProducer* TouchProducer(const string& name) override
+            {
+                return (_parent._touchCallback != nullptr ? _parent._touchCallback->TouchProducer(name) : nullptr);
+            }
+
+            BEGIN_INTERFACE_MAP(Channel)
+            INTERFACE_ENTRY(Exchange::IKeyHandler)
+            INTERFACE_ENTRY(Exchange::IWheelHandler)
+            INTERFACE_ENTRY(Exchange::IPointerHandler)
+            INTERFACE_ENTRY(Exchange::ITouchHandler)
+            END_INTERFACE_MAP
+
+        private:
+            // Events that can be merged are dropped if the dispatcher falls behind, all others wait for
+            // a free slot, as long as there is a dispatcher to free one.
+            Event* Reserve(const kind which, const bool wait)
+            {
+                Event* slot;
+
+                while (((slot = _queue.Reserve()) == nullptr) && (wait == true) && (_parent._dispatcher.IsRunning() == true)) {
+                    SleepMs(1);
+                }
+
+                if (slot == nullptr) {
+                    _parent._dropped[which].fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    slot->Origin = (RemoteAdministrator::_origin != 0 ? RemoteAdministrator::_origin : Core::Time::Now().Ticks());
+                }
+
+                return (slot);
+            }
+            uint32_t Commit(Event* slot)
+            {
+                slot->Sequence = _parent._sequence.fetch_add(1, std::memory_order_relaxed);
+                _queue.Commit();
+                _parent._dispatcher.Wake();
+
+                return (Core::ERROR_NONE);
+            }
+            uint32_t Motion(const Event::type type, const kind which, const int16_t x, const int16_t y)
+            {
+                uint32_t result = Core::ERROR_UNAVAILABLE;
+                Event* slot = Reserve(which, false);
+
+                if (slot != nullptr) {
+                    slot->Type = type;
+                    slot->X = x;
+                    slot->Y = y;
+
+                    result = Commit(slot);
+                }
+
+                return (result);
+            }
+
+        private:
+            RemoteAdministrator& _parent;
+            const void* _source;
+            EventQueue<Event, QueueSize> _queue;
+        };
+
+        class Dispatcher : public Core::Thread {
+        private:
+            Dispatcher() = delete;
+            Dispatcher(const Dispatcher&) = delete;
+            Dispatcher& operator=(const Dispatcher&) = delete;
+
+        public:
+            Dispatcher(RemoteAdministrator* parent)
+                : Core::Thread(Core::Thread::DefaultStackSize(), _T("RemoteDispatcher"))
+                , _parent(*parent)
+                , _signal(false, true)
+            {
+                ASSERT(parent != nullptr);
+            }
+            virtual ~Dispatcher()
+            {
+                Core::Thread::Stop();
+                _signal.SetEvent();
+                Wait(Core::Thread::STOPPED, Core::infinite);
+            }
+
+        public:
+            inline void Wake()
+            {
+                _signal.SetEvent();
+            }
+            void Halt()
+            {
+                Core::Thread::Block();
+                _signal.SetEvent();
+                Wait(Core::Thread::INITIALIZED | Core::Thread::BLOCKED | Core::Thread::STOPPED, Core::infinite);
+            }
+
+        private:
+            virtual uint32_t Worker() override
+            {
+                _signal.Lock(Core::infinite);
+                _signal.ResetEvent();
+
+                if (IsRunning() == true) {
+                    _parent.Dispatch();
+                }
+
+                return (0);
+            }
+
+        private:
+            RemoteAdministrator& _parent;
+            Core::Event _signal;
+        };
+
         RemoteAdministrator()
             : _adminLock()
+            , _dispatchLock()
+            , _callbackLock()
             , _keyCallback(nullptr)
             , _wheelCallback(nullptr)
             , _pointerCallback(nullptr)
@@ -20,7 +280,14 @@ namespace Remotes {
             , _wheels()
             , _pointers()
             , _touchpanels()
+            , _channels()
+            , _sequence(0)
+            , _statistics()
+            , _dispatcher(this)
         {
+            for (std::atomic<uint32_t>& dropped : _dropped) {
+                dropped.store(0, std::memory_order_relaxed);
+            }
         }
 
     public:
@@ -33,6 +300,19 @@ namespace Remotes {
         static RemoteAdministrator& Instance();
         ~RemoteAdministrator()
         {
+            _dispatcher.Halt();
+
+            for (Channel* channel : _channels) {
+                static_cast<Exchange::IKeyHandler*>(channel)->Release();
+            }
+        }
+
+        // A producer that knows when an event originated, e.g. from the timestamp of the kernel, reports
+        // it before handing over the event, in ticks. It holds for all events reported by the calling
+        // thread from then on.
+        static void Origin(const uint64_t ticks)
+        {
+            _origin = ticks;
         }
 
     public:
@@ -219,8 +499,10 @@ namespace Remotes {
             if (index == _remotes.end()) {
                 _remotes.push_back(&remoteControl);
 
+                Channel* channel = Open(&remoteControl);
+
                 if (_keyCallback != nullptr) {
-                    remoteControl.Callback(_keyCallback);
+                    remoteControl.Callback(static_cast<Exchange::IKeyHandler*>(channel));
                 }
             }
 
@@ -236,8 +518,10 @@ namespace Remotes {
             if (index == _wheels.end()) {
                 _wheels.push_back(&wheel);
 
+                Channel* channel = Open(&wheel);
+
                 if (_wheelCallback != nullptr) {
-                    wheel.Callback(_wheelCallback);
+                    wheel.Callback(static_cast<Exchange::IWheelHandler*>(channel));
                 }
             }
 
@@ -253,8 +537,10 @@ namespace Remotes {
             if (index == _pointers.end()) {
                 _pointers.push_back(&pointer);
 
+                Channel* channel = Open(&pointer);
+
                 if (_pointerCallback != nullptr) {
-                    pointer.Callback(_pointerCallback);
+                    pointer.Callback(static_cast<Exchange::IPointerHandler*>(channel));
                 }
             }
 
@@ -270,8 +556,10 @@ namespace Remotes {
             if (index == _touchpanels.end()) {
                 _touchpanels.push_back(&touchPanel);
 
+                Channel* channel = Open(&touchPanel);
+
                 if (_touchCallback != nullptr) {
-                    touchPanel.Callback(_touchCallback);
+                    touchPanel.Callback(static_cast<Exchange::ITouchHandler*>(channel));
                 }
             }
 
@@ -292,6 +580,8 @@ namespace Remotes {
                 if (_keyCallback != nullptr) {
                     remoteControl.Callback(nullptr);
                 }
+
+                Close(&remoteControl);
             }
 
             _adminLock.Unlock();
@@ -309,6 +599,8 @@ namespace Remotes {
                 if (_wheelCallback != nullptr) {
                     wheel.Callback(nullptr);
                 }
+
+                Close(&wheel);
             }
 
             _adminLock.Unlock();
@@ -326,6 +618,8 @@ namespace Remotes {
                 if (_pointerCallback != nullptr) {
                     pointer.Callback(nullptr);
                 }
+
+                Close(&pointer);
             }
 
             _adminLock.Unlock();
@@ -343,6 +637,8 @@ namespace Remotes {
                 if (_touchCallback != nullptr) {
                     touchpanel.Callback(nullptr);
                 }
+
+                Close(&touchpanel);
             }
 
             _adminLock.Unlock();
@@ -357,6 +653,7 @@ namespace Remotes {
                     if (_keyCallback != nullptr) {
                         (*index)->Callback(nullptr);
                     }
+                    Close(*index);
                     index++;
                 }
                 _remotes.clear();
@@ -368,6 +665,7 @@ namespace Remotes {
                     if (_wheelCallback != nullptr) {
                         (*index)->Callback(nullptr);
                     }
+                    Close(*index);
                     index++;
                 }
                 _wheels.clear();
@@ -379,6 +677,7 @@ namespace Remotes {
                     if (_pointerCallback != nullptr) {
                         (*index)->Callback(nullptr);
                     }
+                    Close(*index);
                     index++;
                 }
                 _pointers.clear();
@@ -390,6 +689,7 @@ namespace Remotes {
                     if (_touchCallback != nullptr) {
                         (*index)->Callback(nullptr);
                     }
+                    Close(*index);
                     index++;
                 }
                 _touchpanels.clear();
@@ -404,10 +704,15 @@ namespace Remotes {
             ASSERT((_keyCallback == nullptr) ^ (callback == nullptr));
 
             auto index(_remotes.begin());
+
+            // Once the handler is gone, the dispatcher should not hand it any more events. Taking the
+            // lock waits for an event that is being handed to the previous handler right now.
+            _callbackLock.Lock();
             _keyCallback = callback;
+            _callbackLock.Unlock();
 
             while (index != _remotes.end()) {
-                uint32_t result = (*index)->Callback(callback);
+                uint32_t result = (*index)->Callback(callback != nullptr ? static_cast<Exchange::IKeyHandler*>(Find(*index)) : nullptr);
 
                 if (result != Core::ERROR_NONE) {
                     if (callback == nullptr) {
@@ -420,6 +725,8 @@ namespace Remotes {
                 index++;
             }
 
+            Activity();
+
             _adminLock.Unlock();
         }
         void Callback(Exchange::IWheelHandler* callback)
@@ -429,10 +736,15 @@ namespace Remotes {
             ASSERT((_wheelCallback == nullptr) ^ (callback == nullptr));
 
             auto index(_wheels.begin());
+
+            // Once the handler is gone, the dispatcher should not hand it any more events. Taking the
+            // lock waits for an event that is being handed to the previous handler right now.
+            _callbackLock.Lock();
             _wheelCallback = callback;
+            _callbackLock.Unlock();
 
             while (index != _wheels.end()) {
-                uint32_t result = (*index)->Callback(callback);
+                uint32_t result = (*index)->Callback(callback != nullptr ? static_cast<Exchange::IWheelHandler*>(Find(*index)) : nullptr);
 
                 if (result != Core::ERROR_NONE) {
                     if (callback == nullptr) {
@@ -445,6 +757,8 @@ namespace Remotes {
                 index++;
             }
 
+            Activity();
+
             _adminLock.Unlock();
         }
         void Callback(Exchange::IPointerHandler* callback)
@@ -454,10 +768,15 @@ namespace Remotes {
             ASSERT((_pointerCallback == nullptr) ^ (callback == nullptr));
 
             auto index(_pointers.begin());
+
+            // Once the handler is gone, the dispatcher should not hand it any more events. Taking the
+            // lock waits for an event that is being handed to the previous handler right now.
+            _callbackLock.Lock();
             _pointerCallback = callback;
+            _callbackLock.Unlock();
 
             while (index != _pointers.end()) {
-                uint32_t result = (*index)->Callback(callback);
+                uint32_t result = (*index)->Callback(callback != nullptr ? static_cast<Exchange::IPointerHandler*>(Find(*index)) : nullptr);
 
                 if (result != Core::ERROR_NONE) {
                     if (callback == nullptr) {
@@ -470,6 +789,8 @@ namespace Remotes {
                 index++;
             }
 
+            Activity();
+
             _adminLock.Unlock();
         }
         void Callback(Exchange::ITouchHandler* callback)
@@ -479,10 +800,15 @@ namespace Remotes {
             ASSERT((_touchCallback == nullptr) ^ (callback == nullptr));
 
             auto index(_touchpanels.begin());
+
+            // Once the handler is gone, the dispatcher should not hand it any more events. Taking the
+            // lock waits for an event that is being handed to the previous handler right now.
+            _callbackLock.Lock();
             _touchCallback = callback;
+            _callbackLock.Unlock();
 
             while (index != _touchpanels.end()) {
-                uint32_t result = (*index)->Callback(callback);
+                uint32_t result = (*index)->Callback(callback != nullptr ? static_cast<Exchange::ITouchHandler*>(Find(*index)) : nullptr);
 
                 if (result != Core::ERROR_NONE) {
                     if (callback == nullptr) {
@@ -495,11 +821,223 @@ namespace Remotes {
                 index++;
             }
 
+            Activity();
+
             _adminLock.Unlock();
         }
+        Statistics Latency(const kind which) const
+        {
+            _dispatchLock.Lock();
+            Statistics result(_statistics[which]);
+            _dispatchLock.Unlock();
+
+            result.Dropped = _dropped[which].load(std::memory_order_relaxed);
+
+            return (result);
+        }
+
+    private:
+        // The methods below, up to Dispatch(), should be called with the _adminLock taken.
+        Channel* Open(const void* source)
+        {
+            Channel* channel = Core::Service<Channel>::Create<Channel>(this, source);
+
+            _dispatchLock.Lock();
+            _channels.push_back(channel);
+            _dispatchLock.Unlock();
+
+            return (channel);
+        }
+        void Close(const void* source)
+        {
+            Channel* channel = nullptr;
+
+            _dispatchLock.Lock();
+
+            std::list<Channel*>::iterator index(_channels.begin());
+
+            while ((index != _channels.end()) && ((*index)->Source() != source)) {
+                index++;
+            }
+
+            if (index != _channels.end()) {
+                channel = *index;
+                _channels.erase(index);
+            }
+
+            _dispatchLock.Unlock();
+
+            if (channel != nullptr) {
+                static_cast<Exchange::IKeyHandler*>(channel)->Release();
+            }
+        }
+        Channel* Find(const void* source) const
+        {
+            std::list<Channel*>::const_iterator index(_channels.begin());
+
+            while ((index != _channels.end()) && ((*index)->Source() != source)) {
+                index++;
+            }
+
+            ASSERT(index != _channels.end());
+
+            return (index != _channels.end() ? *index : nullptr);
+        }
+        // The dispatcher only needs to run as long as there is someone to hand the events to.
+        void Activity()
+        {
+            if ((_keyCallback != nullptr) || (_wheelCallback != nullptr) || (_pointerCallback != nullptr) || (_touchCallback != nullptr)) {
+                _dispatcher.Run();
+            } else {
+                _dispatcher.Halt();
+            }
+        }
+
+        // Runs on the dispatcher thread. The events are taken from the queues with the _dispatchLock
+        // taken, the handlers are called without it, so neither the producers nor Latency() have to
+        // wait for a handler. The _callbackLock makes sure a handler that is being removed does not
+        // get called any more.
+        void Dispatch()
+        {
+            Channel* channel;
+
+            _dispatchLock.Lock();
+
+            while ((channel = Next(nullptr)) != nullptr) {
+                Event event(*(channel->Queue().Front()));
+                kind which = Kind(event.Type);
+
+                if ((event.Type == Event::AXIS) || (event.Type == Event::MOTION)) {
+                    Coalesce(*channel, event.X, event.Y, which);
+                }
+
+                channel->Queue().Pop();
+
+                _dispatchLock.Unlock();
+
+                _callbackLock.Lock();
+                const uint64_t now = Core::Time::Now().Ticks();
+                const bool handled = Handle(event);
+                _callbackLock.Unlock();
+
+                _dispatchLock.Lock();
+
+                if (handled == true) {
+                    Measure(which, event.Origin, now);
+                }
+            }
+
+            _dispatchLock.Unlock();
+        }
+        static kind Kind(const Event::type type)
+        {
+            return (type == Event::KEY ? KEY : (type == Event::AXIS ? WHEEL : (type == Event::TOUCH ? TOUCH : POINTER)));
+        }
+        // Returns the channel holding the event that was queued first, of all events at the front of
+        // the channels, other than the given one.
+        Channel* Next(const Channel* skip) const
+        {
+            Channel* result = nullptr;
+            uint32_t sequence = 0;
+
+            for (Channel* channel : _channels) {
+                const Event* event = channel->Queue().Front();
+
+                if ((channel != skip) && (event != nullptr) && ((result == nullptr) || (static_cast<int32_t>(event->Sequence - sequence) < 0))) {
+                    result = channel;
+                    sequence = event->Sequence;
+                }
+            }
+
+            return (result);
+        }
+        // Merges the motion events following the one at the front of the channel into it, as long as
+        // no event of another channel was queued in between. The last one of them is left at the front.
+        void Coalesce(Channel& channel, int32_t& x, int32_t& y, const kind which)
+        {
+            const Event::type type = channel.Queue().Front()->Type;
+            const Event* next;
+
+            while (((next = channel.Queue().Front(1)) != nullptr) && (next->Type == type)) {
+                Channel* other = Next(&channel);
+
+                if ((other != nullptr) && (static_cast<int32_t>(other->Queue().Front()->Sequence - next->Sequence) < 0)) {
+                    break;
+                }
+
+                x += next->X;
+                y += next->Y;
+                channel.Queue().Pop();
+                _statistics[which].Coalesced++;
+            }
+        }
+        // Should be called with the _callbackLock taken, returns false if there is no one to hand the event to.
+        bool Handle(const Event& event)
+        {
+            bool handled = false;
+
+            switch (event.Type) {
+            case Event::KEY:
+                if (_keyCallback != nullptr) {
+                    _keyCallback->KeyEvent(event.Pressed, event.Code, event.MapName);
+                    handled = true;
+                }
+                break;
+            case Event::AXIS:
+                if (_wheelCallback != nullptr) {
+                    _wheelCallback->AxisEvent(Clip(event.X), Clip(event.Y));
+                    handled = true;
+                }
+                break;
+            case Event::BUTTON:
+                if (_pointerCallback != nullptr) {
+                    _pointerCallback->PointerButtonEvent(event.Pressed, event.Index);
+                    handled = true;
+                }
+                break;
+            case Event::MOTION:
+                if (_pointerCallback != nullptr) {
+                    _pointerCallback->PointerMotionEvent(Clip(event.X), Clip(event.Y));
+                    handled = true;
+                }
+                break;
+            case Event::TOUCH:
+                if (_touchCallback != nullptr) {
+                    _touchCallback->TouchEvent(event.Index, event.State, static_cast<uint16_t>(event.X), static_cast<uint16_t>(event.Y));
+                    handled = true;
+                }
+                break;
+            }
+
+            return (handled);
+        }
+        // The delay is measured up to the moment the event was handed to the handler.
+        void Measure(const kind which, const uint64_t origin, const uint64_t now)
+        {
+            const uint32_t delay = (now > origin ? static_cast<uint32_t>(std::min(now - origin, static_cast<uint64_t>(~0u))) : 0);
+            Statistics& statistics(_statistics[which]);
+            uint8_t bucket = 0;
+
+            while ((bucket < (Buckets - 1)) && (delay >= (FirstBucket << bucket))) {
+                bucket++;
+            }
+
+            statistics.Events++;
+            statistics.Histogram[bucket]++;
+
+            if (delay > statistics.Maximum) {
+                statistics.Maximum = delay;
+            }
+        }
+        static int16_t Clip(const int32_t value)
+        {
+            return (static_cast<int16_t>(std::max(std::min(value, static_cast<int32_t>(Core::NumberType<int16_t>::Max())), static_cast<int32_t>(Core::NumberType<int16_t>::Min()))));
+        }
 
     private:
         Core::CriticalSection _adminLock;
+        mutable Core::CriticalSection _dispatchLock;
+        Core::CriticalSection _callbackLock;
         Exchange::IKeyHandler* _keyCallback;
         Exchange::IWheelHandler* _wheelCallback;
         Exchange::IPointerHandler* _pointerCallback;
@@ -508,6 +1046,13 @@ namespace Remotes {
         std::list<Exchange::IWheelProducer*> _wheels;
         std::list<Exchange::IPointerProducer*> _pointers;
         std::list<Exchange::ITouchProducer*> _touchpanels;
+        std::list<Channel*> _channels;
+        std::atomic<uint32_t> _sequence;
+        std::atomic<uint32_t> _dropped[4];
+        Statistics _statistics[4];
+        Dispatcher _dispatcher;
+
+        static thread_local uint64_t _origin;
     };
 }
 }
@@ -118,6 +118,7 @@ namespace Plugin {
         , _mouseHandler(PluginHost::InputHandler::MouseHandler())
         , _touchHandler(PluginHost::InputHandler::TouchHandler())
         , _persistentPath()
+        , _dispatching(false)
     {
         ASSERT(_keyHandler != nullptr);
         ASSERT(_mouseHandler != nullptr);
@@ -254,6 +255,7 @@ namespace Plugin {
             admin.Callback(static_cast<IWheelHandler*>(this));
             admin.Callback(static_cast<IPointerHandler*>(this));
             admin.Callback(static_cast<ITouchHandler*>(this));
+            _dispatching = true;
         }
 
         // On succes return nullptr, to indicate there is no error text.
@@ -281,7 +283,17 @@ namespace Plugin {
         // CLear the virtual devices.
         _virtualDevices.clear();
 
-        Remotes::RemoteAdministrator::Instance().RevokeAll();
+        // Stop the dispatching of input events to us, before the producers are dropped. If the
+        // initialization failed, we never got to receive them.
+        if (_dispatching == true) {
+            admin.Callback(static_cast<IKeyHandler*>(nullptr));
+            admin.Callback(static_cast<IWheelHandler*>(nullptr));
+            admin.Callback(static_cast<IPointerHandler*>(nullptr));
+            admin.Callback(static_cast<ITouchHandler*>(nullptr));
+            _dispatching = false;
+        }
+
+        admin.RevokeAll();
     }
 
     /* virtual */ string RemoteControl::Information() const
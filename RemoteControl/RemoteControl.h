@@ -144,6 +144,97 @@ namespace Plugin {
             Core::JSON::ArrayType<Core::JSON::String> Devices;
         };
 
+        // The time from the origin of the input events till their dispatch, per kind of event. The
+        // histogram has a bucket per doubling of the latency, starting at 250us.
+        class Latency : public Core::JSON::Container {
+        public:
+            class Histogram : public Core::JSON::Container {
+            private:
+                Histogram& operator=(const Histogram&) = delete;
+
+            public:
+                Histogram()
+                    : Core::JSON::Container()
+                    , Events()
+                    , Coalesced()
+                    , Dropped()
+                    , Maximum()
+                    , Buckets()
+                {
+                    Add(_T("events"), &Events);
+                    Add(_T("coalesced"), &Coalesced);
+                    Add(_T("dropped"), &Dropped);
+                    Add(_T("maximum"), &Maximum);
+                    Add(_T("buckets"), &Buckets);
+                }
+                Histogram(const Histogram& copy)
+                    : Core::JSON::Container()
+                    , Events(copy.Events)
+                    , Coalesced(copy.Coalesced)
+                    , Dropped(copy.Dropped)
+                    , Maximum(copy.Maximum)
+                    , Buckets(copy.Buckets)
+                {
+                    Add(_T("events"), &Events);
+                    Add(_T("coalesced"), &Coalesced);
+                    Add(_T("dropped"), &Dropped);
+                    Add(_T("maximum"), &Maximum);
+                    Add(_T("buckets"), &Buckets);
+                }
+                ~Histogram()
+                {
+                }
+
+            public:
+                void Set(const Remotes::RemoteAdministrator::Statistics& statistics)
+                {
+                    Events = statistics.Events;
+                    Coalesced = statistics.Coalesced;
+                    Dropped = statistics.Dropped;
+                    Maximum = statistics.Maximum;
+                    Buckets.Clear();
+
+                    for (uint8_t index = 0; index < Remotes::RemoteAdministrator::Buckets; index++) {
+                        Buckets.Add(Core::JSON::DecUInt32(statistics.Histogram[index]));
+                    }
+                }
+
+            public:
+                Core::JSON::DecUInt32 Events;
+                Core::JSON::DecUInt32 Coalesced;
+                Core::JSON::DecUInt32 Dropped;
+                Core::JSON::DecUInt32 Maximum; // us
+                Core::JSON::ArrayType<Core::JSON::DecUInt32> Buckets;
+            };
+
+        private:
+            Latency(const Latency&) = delete;
+            Latency& operator=(const Latency&) = delete;
+
+        public:
+            Latency()
+                : Core::JSON::Container()
+                , Key()
+                , Wheel()
+                , Pointer()
+                , Touch()
+            {
+                Add(_T("key"), &Key);
+                Add(_T("wheel"), &Wheel);
+                Add(_T("pointer"), &Pointer);
+                Add(_T("touch"), &Touch);
+            }
+            ~Latency()
+            {
+            }
+
+        public:
+            Histogram Key;
+            Histogram Wheel;
+            Histogram Pointer;
+            Histogram Touch;
+        };
+
     public:
         RemoteControl();
         virtual ~RemoteControl();
@@ -318,6 +409,7 @@ namespace Plugin {
         uint32_t endpoint_unpair(const JsonData::RemoteControl::UnpairParamsData& params);
         uint32_t get_devices(Core::JSON::ArrayType<Core::JSON::String>& response) const;
         uint32_t get_device(const string& index, JsonData::RemoteControl::DeviceData& response) const;
+        uint32_t get_latency(Latency& response) const;
 
     private:
         uint32_t _skipURL;
@@ -326,6 +418,7 @@ namespace Plugin {
         PluginHost::VirtualInput* _mouseHandler;
         PluginHost::VirtualInput* _touchHandler;
         string _persistentPath;
+        bool _dispatching;
     };
 }
 }
@@ -28,6 +28,7 @@ namespace Plugin {
         Register<UnpairParamsData,void>(_T("unpair"), &RemoteControl::endpoint_unpair, this);
         Property<Core::JSON::ArrayType<Core::JSON::String>>(_T("devices"), &RemoteControl::get_devices, nullptr, this);
         Property<DeviceData>(_T("device"), &RemoteControl::get_device, nullptr, this);
+        Property<Latency>(_T("latency"), &RemoteControl::get_latency, nullptr, this);
     }
 
     void RemoteControl::UnregisterAll()
@@ -43,6 +44,7 @@ namespace Plugin {
         Unregister(_T("press"));
         Unregister(_T("send"));
         Unregister(_T("key"));
+        Unregister(_T("latency"));
         Unregister(_T("device"));
         Unregister(_T("devices"));
     }
@@ -167,6 +169,18 @@ namespace Plugin {
        return result;
    }
 
+   uint32_t RemoteControl::get_latency(Latency& response) const
+   {
+       Remotes::RemoteAdministrator& admin(Remotes::RemoteAdministrator::Instance());
+
+       response.Key.Set(admin.Latency(Remotes::RemoteAdministrator::KEY));
+       response.Wheel.Set(admin.Latency(Remotes::RemoteAdministrator::WHEEL));
+       response.Pointer.Set(admin.Latency(Remotes::RemoteAdministrator::POINTER));
+       response.Touch.Set(admin.Latency(Remotes::RemoteAdministrator::TOUCH));
+
+       return Core::ERROR_NONE;
+   }
+
     uint32_t RemoteControl::endpoint_key(const KeyobjInfo& params, KeyResultData& response)
     {
         uint32_t result = Core::ERROR_NONE;
@@ -3,6 +3,8 @@
 #include "Module.h"
 
 #include <regex>
+#include <set>
+#include <unordered_set>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -143,20 +145,70 @@ namespace Plugin {
 
     public:
         class Filter {
+        private:
+            // The methods in the lists are prefixes: an entry matches all methods starting with it. They
+            // are kept in a hash set together with the distinct lengths that occur, so a lookup only
+            // needs one probe per length instead of a compare against every entry.
+            class Prefixes {
+            public:
+                Prefixes(const Prefixes&) = delete;
+                Prefixes& operator=(const Prefixes&) = delete;
+
+                Prefixes()
+                    : _entries()
+                    , _lengths()
+                {
+                }
+                ~Prefixes()
+                {
+                }
+
+            public:
+                inline bool IsEmpty() const
+                {
+                    return (_entries.empty());
+                }
+                void Add(const string& entry)
+                {
+                    if (_entries.insert(entry).second == true) {
+                        _lengths.insert(entry.length());
+                    }
+                }
+                bool Matches(const string& method) const
+                {
+                    bool result = false;
+                    std::set<uint32_t>::const_iterator index(_lengths.begin());
+
+                    while ((index != _lengths.end()) && (*index <= method.length()) && (result == false)) {
+                        result = (_entries.find(method.substr(0, *index)) != _entries.end());
+                        index++;
+                    }
+
+                    return (result);
+                }
+
+            private:
+                std::unordered_set<string> _entries;
+                std::set<uint32_t> _lengths;
+            };
+
         public:
             Filter() = delete;
             Filter(const Filter&) = delete;
             Filter& operator=(const Filter&) = delete;
 
             Filter(const JSONACL::Config& filter)
+                : _allowSet(filter.Allow.IsSet())
+                , _allow()
+                , _block()
             {
                 Core::JSON::ArrayType<Core::JSON::String>::ConstIterator index(filter.Allow.Elements());
                 while (index.Next() == true) {
-                    _allow.emplace_back(index.Current().Value());
+                    _allow.Add(index.Current().Value());
                 }
                 index = (filter.Block.Elements());
                 while (index.Next() == true) {
-                    _block.emplace_back(index.Current().Value());
+                    _block.Add(index.Current().Value());
                 }
             }
             ~Filter()
@@ -166,31 +218,85 @@ namespace Plugin {
         public:
             bool Allowed(const string& method) const
             {
-                bool allowed = false;
-                if (_allowSet) {
-                    std::list<string>::const_iterator index(_allow.begin());
-                    while ((index != _allow.end()) && (allowed == false)) {
-                        allowed = strncmp(index->c_str(), method.c_str(), index->length()) == 0;
-                        index++;
+                return (_allowSet ? _allow.Matches(method) : (_block.Matches(method) == false));
+            }
+
+        private:
+            bool _allowSet;
+            Prefixes _allow;
+            Prefixes _block;
+        };
+
+        // A URL pattern of the groups, compiled once when the list is loaded. Patterns without any
+        // special characters are matched as plain text, which is by far the most common case.
+        class Pattern {
+        public:
+            Pattern() = delete;
+            Pattern(const Pattern&) = delete;
+            Pattern& operator=(const Pattern&) = delete;
+
+            Pattern(const string& pattern, const Filter& filter)
+                : _pattern(pattern)
+                , _literal(pattern.find_first_of(_T("\\^$.|?*+()[]{}")) == string::npos)
+                , _expression()
+                , _filter(filter)
+            {
+                if (_literal == false) {
+                    try {
+                        _expression = std::regex(_pattern, std::regex::ECMAScript | std::regex::optimize);
+                    } catch (const std::regex_error&) {
+                        // Not a valid expression, the ACL files typically use wildcards, like *://localhost:*
+                        _expression = std::regex(Wildcard(_pattern), std::regex::ECMAScript | std::regex::optimize);
                     }
-                } else {
-                    allowed = true;
-                    std::list<string>::const_iterator index(_block.begin());
-                    while ((index != _block.end()) && (allowed == true)) {
-                        allowed = strncmp(index->c_str(), method.c_str(), index->length()) != 0;
-                        index++;
+                }
+            }
+            ~Pattern()
+            {
+            }
+
+        public:
+            inline const string& Text() const
+            {
+                return (_pattern);
+            }
+            inline const Filter& Selected() const
+            {
+                return (_filter);
+            }
+            inline bool Matches(const string& URL) const
+            {
+                return (_literal ? (URL.find(_pattern) != string::npos) : std::regex_search(URL, _expression));
+            }
+
+        private:
+            static string Wildcard(const string& pattern)
+            {
+                string result;
+
+                for (const TCHAR character : pattern) {
+                    if (character == '*') {
+                        result += _T(".*");
+                    } else if (character == '?') {
+                        result += '.';
+                    } else {
+                        if (strchr(_T("\\^$.|+()[]{}"), character) != nullptr) {
+                            result += '\\';
+                        }
+                        result += character;
                     }
                 }
-                return (allowed);
+
+                return (result);
             }
 
         private:
-            bool _allowSet;
-            std::list<string> _allow;
-            std::list<string> _block;
+            const string _pattern;
+            const bool _literal;
+            std::regex _expression;
+            const Filter& _filter;
         };
 
-        using URLList = std::list<std::pair<string, Filter&>>;
+        using URLList = std::list<Pattern>;
         using Iterator = Core::IteratorType<const std::list<string>, const string&, std::list<string>::const_iterator>;
 
     public:
@@ -227,17 +333,12 @@ namespace Plugin {
         const Filter* FilterMapFromURL(const string& URL) const
         {
             const Filter* result = nullptr;
-            std::smatch matchList;
             URLList::const_iterator index = _urlMap.begin();
 
+            // The patterns are evaluated in the order of the ACL file, the first match wins.
             while ((index != _urlMap.end()) && (result == nullptr)) {
-                // regex_search() for searching the regex pattern
-                // 'r' in the string 's'. 'm' is flag for determining
-                // matching behavior.
-                std::regex expression(index->first.c_str());
-
-                if (std::regex_search(URL, matchList, expression) == true) {
-                    result = &(index->second);
+                if (index->Matches(URL) == true) {
+                    result = &(index->Selected());
                 }
                 index++;
             }
@@ -280,8 +381,7 @@ namespace Plugin {
                 } else {
                     Filter& entry(selectedFilter->second);
 
-                    _urlMap.emplace_back(std::pair<string, Filter&>(
-                        index.Current().URL.Value(), entry));
+                    _urlMap.emplace_back(index.Current().URL.Value(), entry);
 
                     std::list<string>::iterator found = std::find(_unusedRoles.begin(), _unusedRoles.end(), role);
 
@@ -56,6 +56,11 @@ namespace Plugin {
         string version = service->Version();
 
         _skipURL = static_cast<uint8_t>(service->WebPrefix().length());
+        _tokens.Configure(config.TokenCache.Value(), config.TokenLifetime.Value());
+
+        // The cached contexts point into the access control list, so they are invalid once it is loaded.
+        _tokens.Clear();
+
         Core::File aclFile(service->PersistentPath() + config.ACL.Value(), true);
 
         if (aclFile.Exists() == false) {
@@ -105,13 +110,26 @@ namespace Plugin {
             subSystem->Set(PluginHost::ISubSystem::NOT_SECURITY, nullptr);
             subSystem->Release();
         }
+        _tokens.Clear();
         _acl.Clear();
     }
 
     /* virtual */ string SecurityAgent::Information() const
     {
-        // No additional info to report.
-        return (string());
+        Metrics metrics;
+        string result;
+
+        const uint32_t lookups = _tokens.Hits() + _tokens.Misses();
+
+        metrics.Tokens = _tokens.Size();
+        metrics.Hits = _tokens.Hits();
+        metrics.Misses = _tokens.Misses();
+        metrics.Evictions = _tokens.Evictions();
+        metrics.HitRate = static_cast<uint8_t>(lookups > 0 ? (static_cast<uint64_t>(_tokens.Hits()) * 100) / lookups : 0);
+
+        metrics.ToString(result);
+
+        return (result);
     }
 
     /* virtual */ uint32_t SecurityAgent::CreateToken(const uint16_t length, const uint8_t buffer[], string& token)
@@ -124,24 +142,7 @@ namespace Plugin {
 
     /* virtual */ PluginHost::ISecurity* SecurityAgent::Officer(const string& token)
     {
-        PluginHost::ISecurity* result = nullptr;
-
-        Web::JSONWebToken webToken(Web::JSONWebToken::SHA256, sizeof(_secretKey), _secretKey);
-        uint16_t load = webToken.PayloadLength(token);
-
-        // Validate the token
-        if (load != static_cast<uint16_t>(~0)) {
-            // It is potentially a valid token, extract the payload.
-            uint8_t* payload = reinterpret_cast<uint8_t*>(ALLOCA(load));
-
-            load = webToken.Decode(token, load, payload);
-
-            if (load != static_cast<uint16_t>(~0)) {
-                // Seems like we extracted a valid payload, time to create an security context
-                result = Core::Service<SecurityContext>::Create<SecurityContext>(&_acl, load, payload);
-            }
-        }
-        return (result);
+        return (Context(token));
     }
 
     /* virtual */ void SecurityAgent::Inbound(Web::Request& request)
@@ -183,32 +184,50 @@ namespace Plugin {
                 result->Message = _T("Missing token");
 
                 if (request.WebToken.IsSet()) {
-                    Web::JSONWebToken webToken(Web::JSONWebToken::SHA256, sizeof(_secretKey), _secretKey);
-                    const string& token = request.WebToken.Value().Token();
-                    uint16_t load = webToken.PayloadLength(token);
-
-                    // Validate the token
-                    if (load != static_cast<uint16_t>(~0)) {
-                        // It is potentially a valid token, extract the payload.
-                        uint8_t* payload = reinterpret_cast<uint8_t*>(ALLOCA(load));
-
-                        load = webToken.Decode(token, load, payload);
-
-                        if (load == static_cast<uint16_t>(~0)) {
-                            result->ErrorCode = Web::STATUS_FORBIDDEN;
-                            result->Message = _T("Invalid token");
-                        } else {
-                            result->ErrorCode = Web::STATUS_OK;
-                            result->Message = _T("Valid token");
-                            TRACE(Trace::Information, (_T("Token contents: %s"), reinterpret_cast<const TCHAR*>(payload)));
-                        }
+                    SecurityContext* context = Context(request.WebToken.Value().Token());
+
+                    if (context == nullptr) {
+                        result->ErrorCode = Web::STATUS_FORBIDDEN;
+                        result->Message = _T("Invalid token");
+                    } else {
+                        result->ErrorCode = Web::STATUS_OK;
+                        result->Message = _T("Valid token");
+                        TRACE(Trace::Information, (_T("Token contents: %s"), context->Payload().c_str()));
+
+                        context->Release();
                     }
-                
-				}
+                }
             }
         }
 		return (result);
     }
 
+    SecurityContext* SecurityAgent::Context(const string& token)
+    {
+        SecurityContext* result = _tokens.Find(token);
+
+        if (result == nullptr) {
+            Web::JSONWebToken webToken(Web::JSONWebToken::SHA256, sizeof(_secretKey), _secretKey);
+            uint16_t load = webToken.PayloadLength(token);
+
+            // Validate the token
+            if (load != static_cast<uint16_t>(~0)) {
+                // It is potentially a valid token, extract the payload.
+                uint8_t* payload = reinterpret_cast<uint8_t*>(ALLOCA(load));
+
+                load = webToken.Decode(token, load, payload);
+
+                if (load != static_cast<uint16_t>(~0)) {
+                    // Seems like we extracted a valid payload, time to create an security context
+                    result = Core::Service<SecurityContext>::Create<SecurityContext>(&_acl, load, payload);
+
+                    _tokens.Insert(token, result);
+                }
+            }
+        }
+
+        return (result);
+    }
+
 } // namespace Plugin
 } // namespace WPEFramework
@@ -2,6 +2,7 @@
 
 #include "AccessControlList.h"
 #include "Module.h"
+#include "TokenCache.h"
 
 namespace WPEFramework {
 namespace Plugin {
@@ -20,9 +21,12 @@ namespace Plugin {
             Config()
                 : Core::JSON::Container()
                 , ACL(_T("acl.json"))
-
+                , TokenCache(64)
+                , TokenLifetime(3600)
             {
                 Add(_T("acl"), &ACL);
+                Add(_T("tokencache"), &TokenCache);
+                Add(_T("tokenlifetime"), &TokenLifetime);
             }
             ~Config()
             {
@@ -30,6 +34,35 @@ namespace Plugin {
 
         public:
             Core::JSON::String ACL;
+            Core::JSON::DecUInt16 TokenCache; // Number of validated tokens to remember, 0 disables the cache
+            Core::JSON::DecUInt32 TokenLifetime; // Seconds a validated token is remembered at most
+        };
+
+        class Metrics : public Core::JSON::Container {
+        private:
+            Metrics(const Metrics&) = delete;
+            Metrics& operator=(const Metrics&) = delete;
+
+        public:
+            Metrics()
+                : Core::JSON::Container()
+            {
+                Add(_T("tokens"), &Tokens);
+                Add(_T("hits"), &Hits);
+                Add(_T("misses"), &Misses);
+                Add(_T("evictions"), &Evictions);
+                Add(_T("hitrate"), &HitRate);
+            }
+            ~Metrics()
+            {
+            }
+
+        public:
+            Core::JSON::DecUInt32 Tokens; // Number of tokens currently in the cache
+            Core::JSON::DecUInt32 Hits;
+            Core::JSON::DecUInt32 Misses;
+            Core::JSON::DecUInt32 Evictions;
+            Core::JSON::DecUInt8 HitRate; // Percentage of the lookups served from the cache
         };
 
     public:
@@ -75,9 +108,13 @@ namespace Plugin {
         //! @}
         virtual Core::ProxyType<Web::Response> Process(const Web::Request& request);
 
+    private:
+        SecurityContext* Context(const string& token);
+
     private:
         uint8_t _secretKey[Crypto::SHA256::Length];
         AccessControlList _acl;
+        TokenCache _tokens;
         uint8_t _skipURL;
     };
 
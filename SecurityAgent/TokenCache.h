@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Module.h"
+#include "SecurityContext.h"
+
+#include <unordered_map>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Keeps the security contexts of recently validated tokens, so a token that is presented over and
+    // over again does not need its signature to be verified and its payload to be decoded every time.
+    // The entries are looked up by the token itself: the hash table only uses a digest of it to find
+    // the bucket, the complete token is compared before an entry is used. The least recently used
+    // entry is dropped when the cache is full, an entry is never used beyond its lifetime, or beyond
+    // the expiry time carried by the token.
+    class TokenCache {
+    private:
+        TokenCache(const TokenCache&) = delete;
+        TokenCache& operator=(const TokenCache&) = delete;
+
+        struct Entry {
+            SecurityContext* Context;
+            uint64_t Expiry;
+            std::list<string>::iterator Usage;
+        };
+
+        using EntryMap = std::unordered_map<string, Entry>;
+
+    public:
+        TokenCache()
+            : _adminLock()
+            , _entries()
+            , _usage()
+            , _maxEntries(0)
+            , _lifetime(0)
+            , _hits(0)
+            , _misses(0)
+            , _evictions(0)
+        {
+        }
+        ~TokenCache()
+        {
+            Clear();
+        }
+
+    public:
+        // The lifetime is in seconds.
+        void Configure(const uint16_t maxEntries, const uint32_t lifetime)
+        {
+            _adminLock.Lock();
+
+            _maxEntries = maxEntries;
+            _lifetime = static_cast<uint64_t>(lifetime) * 1000000; // Move from seconds to ticks (microseconds)
+
+            while (_entries.size() > _maxEntries) {
+                Evict();
+            }
+
+            _adminLock.Unlock();
+        }
+        // Returns the context of the token with a reference for the caller, or nullptr if the token
+        // is not in the cache.
+        SecurityContext* Find(const string& token)
+        {
+            SecurityContext* result = nullptr;
+
+            _adminLock.Lock();
+
+            EntryMap::iterator index(_entries.find(token));
+
+            if (index != _entries.end()) {
+                if (index->second.Expiry > Core::Time::Now().Ticks()) {
+                    _usage.splice(_usage.begin(), _usage, index->second.Usage);
+                    result = index->second.Context;
+                    result->AddRef();
+                } else {
+                    Remove(index);
+                }
+            }
+
+            if (result != nullptr) {
+                _hits++;
+            } else {
+                _misses++;
+            }
+
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        void Insert(const string& token, SecurityContext* context)
+        {
+            ASSERT(context != nullptr);
+
+            _adminLock.Lock();
+
+            if ((_maxEntries > 0) && (_entries.find(token) == _entries.end())) {
+                uint64_t expiry = Core::Time::Now().Ticks() + _lifetime;
+
+                if ((context->Expiry() != 0) && (context->Expiry() < expiry)) {
+                    expiry = context->Expiry();
+                }
+
+                if (_entries.size() >= _maxEntries) {
+                    Evict();
+                }
+
+                _usage.push_front(token);
+
+                Entry& entry(_entries[token]);
+                entry.Context = context;
+                entry.Expiry = expiry;
+                entry.Usage = _usage.begin();
+
+                context->AddRef();
+            }
+
+            _adminLock.Unlock();
+        }
+        // The contexts refer to the filters of the access control list, so all entries have to go
+        // whenever the list is (re)loaded.
+        void Clear()
+        {
+            _adminLock.Lock();
+
+            for (std::pair<const string, Entry>& entry : _entries) {
+                entry.second.Context->Release();
+            }
+            _entries.clear();
+            _usage.clear();
+
+            _adminLock.Unlock();
+        }
+
+        inline uint32_t Size() const
+        {
+            return (static_cast<uint32_t>(_entries.size()));
+        }
+        inline uint32_t Hits() const
+        {
+            return (_hits);
+        }
+        inline uint32_t Misses() const
+        {
+            return (_misses);
+        }
+        inline uint32_t Evictions() const
+        {
+            return (_evictions);
+        }
+
+    private:
+        void Evict()
+        {
+            ASSERT(_usage.empty() == false);
+
+            Remove(_entries.find(_usage.back()));
+            _evictions++;
+        }
+        void Remove(EntryMap::iterator index)
+        {
+            ASSERT(index != _entries.end());
+
+            index->second.Context->Release();
+            _usage.erase(index->second.Usage);
+            _entries.erase(index);
+        }
+
+    private:
+        Core::CriticalSection _adminLock;
+        EntryMap _entries;
+        std::list<string> _usage;
+        uint16_t _maxEntries;
+        uint64_t _lifetime;
+        uint32_t _hits;
+        uint32_t _misses;
+        uint32_t _evictions;
+    };
+}
+}
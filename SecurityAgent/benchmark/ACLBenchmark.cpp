@@ -0,0 +1,267 @@
+// Measures the lookups per second of the access control list of the SecurityAgent: the role of a
+// URL and whether that role may call a method, as done for every request carrying a token.
+//
+//     ACLBenchmark [rules] [roles]
+//
+// By default an ACL of 500 URL rules over 50 roles, each with 20 method prefixes, is generated. It is
+// run through the list as it was before the patterns were compiled at load time (a std::regex built
+// for every rule on every lookup, linearly searched method lists), through the current list with the
+// same rules as regular expressions, and through the current list with the rules as wildcards, the
+// way the ACL files write them. The first two must agree on every lookup.
+
+#include "AccessControlList.h"
+
+#include <chrono>
+#include <functional>
+#include <random>
+
+using namespace WPEFramework;
+
+namespace {
+
+// The lookup as it was before the patterns were compiled once.
+class Baseline {
+public:
+    struct Rule {
+        string Pattern;
+        uint32_t Role;
+    };
+    struct Role {
+        bool AllowSet;
+        std::list<string> Allow;
+        std::list<string> Block;
+    };
+
+public:
+    Baseline(const std::vector<Rule>& rules, const std::vector<Role>& roles)
+        : _rules(rules)
+        , _roles(roles)
+    {
+    }
+
+public:
+    const Role* FilterMapFromURL(const string& URL) const
+    {
+        const Role* result = nullptr;
+        std::smatch matchList;
+        std::vector<Rule>::const_iterator index = _rules.begin();
+
+        while ((index != _rules.end()) && (result == nullptr)) {
+            std::regex expression(index->Pattern.c_str());
+
+            if (std::regex_search(URL, matchList, expression) == true) {
+                result = &(_roles[index->Role]);
+            }
+            index++;
+        }
+
+        return (result);
+    }
+    static bool Allowed(const Role& role, const string& method)
+    {
+        bool allowed = false;
+        if (role.AllowSet) {
+            std::list<string>::const_iterator index(role.Allow.begin());
+            while ((index != role.Allow.end()) && (allowed == false)) {
+                allowed = strncmp(index->c_str(), method.c_str(), index->length()) == 0;
+                index++;
+            }
+        } else {
+            allowed = true;
+            std::list<string>::const_iterator index(role.Block.begin());
+            while ((index != role.Block.end()) && (allowed == true)) {
+                allowed = strncmp(index->c_str(), method.c_str(), index->length()) != 0;
+                index++;
+            }
+        }
+        return (allowed);
+    }
+
+private:
+    const std::vector<Rule>& _rules;
+    const std::vector<Role>& _roles;
+};
+
+struct Lookup {
+    string URL;
+    string Method;
+};
+
+// Result of a lookup: 0 no role, 1 blocked, 2 allowed.
+typedef std::function<uint8_t(const Lookup&)> Evaluate;
+
+// Runs the lookups for at least a second, returns the number of lookups per second.
+double Measure(const std::vector<Lookup>& lookups, const Evaluate& evaluate)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start = Clock::now();
+    uint64_t count = 0;
+    double elapsed = 0;
+    volatile uint32_t checksum = 0; // Keeps the lookups from being optimized away
+
+    do {
+        for (const Lookup& lookup : lookups) {
+            checksum += evaluate(lookup);
+            count++;
+
+            if ((count % 64) == 0) {
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                if (elapsed >= 1.0) {
+                    break;
+                }
+            }
+        }
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < 1.0);
+
+    return (count / elapsed);
+}
+
+string Number(const uint32_t value)
+{
+    return (Core::NumberType<uint32_t>(value).Text());
+}
+
+bool Write(const string& fileName, const std::vector<Baseline::Rule>& rules, const std::vector<Baseline::Role>& roles, const bool wildcards)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+
+    if (file != nullptr) {
+        fprintf(file, "{\n  \"assign\": [\n");
+
+        for (uint32_t index = 0; index < rules.size(); index++) {
+            const string pattern(wildcards ? (_T("*://app") + Number(index) + _T(".example.com:*")) : rules[index].Pattern);
+            string escaped;
+
+            for (const TCHAR character : pattern) {
+                if (character == '\\') {
+                    escaped += '\\';
+                }
+                escaped += character;
+            }
+
+            fprintf(file, "    { \"url\": \"%s\", \"role\": \"role%u\" }%s\n", escaped.c_str(), rules[index].Role, (index + 1 < rules.size() ? "," : ""));
+        }
+
+        fprintf(file, "  ],\n  \"roles\": {\n");
+
+        for (uint32_t index = 0; index < roles.size(); index++) {
+            const std::list<string>& methods(roles[index].AllowSet ? roles[index].Allow : roles[index].Block);
+
+            fprintf(file, "    \"role%u\": { \"thunder\": { \"%s\": [", index, (roles[index].AllowSet ? "allow" : "block"));
+
+            for (std::list<string>::const_iterator method(methods.begin()); method != methods.end(); method++) {
+                fprintf(file, "%s\"%s\"", (method == methods.begin() ? "" : ", "), method->c_str());
+            }
+
+            fprintf(file, "] } }%s\n", (index + 1 < roles.size() ? "," : ""));
+        }
+
+        fprintf(file, "  }\n}\n");
+        fclose(file);
+    }
+
+    return (file != nullptr);
+}
+
+bool Load(const string& fileName, Plugin::AccessControlList& acl)
+{
+    Core::File file(fileName, true);
+    bool result = (file.Open(true) == true);
+
+    if (result == true) {
+        result = (acl.Load(file) == Core::ERROR_NONE);
+        file.Close();
+    }
+
+    return (result);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t ruleCount = std::max((argc > 1 ? atoi(argv[1]) : 500), 1);
+    const uint32_t roleCount = std::min(std::max((argc > 2 ? atoi(argv[2]) : 50), 1), static_cast<int>(ruleCount));
+    const uint32_t services = roleCount * 20;
+
+    std::vector<Baseline::Rule> rules;
+    std::vector<Baseline::Role> roles(roleCount);
+    std::vector<Lookup> lookups;
+    std::mt19937 random(1);
+
+    // Every role allows or blocks the methods of 20 services of its own, a method name is prefixed
+    // with its service, like Controller.1.activate.
+    for (uint32_t index = 0; index < roleCount; index++) {
+        roles[index].AllowSet = ((index % 2) == 0);
+
+        for (uint32_t service = 0; service < 20; service++) {
+            (roles[index].AllowSet ? roles[index].Allow : roles[index].Block).push_back(_T("Service") + Number((index * 20) + service) + _T("."));
+        }
+    }
+    for (uint32_t index = 0; index < ruleCount; index++) {
+        rules.push_back({ _T("^[a-z]+://app") + Number(index) + _T("\\.example\\.com(:[0-9]+)?$"), index % roleCount });
+    }
+    // One in ten URLs has no rule, the rest is spread evenly over the rules.
+    for (uint32_t index = 0; index < 1000; index++) {
+        const uint32_t rule = random() % ruleCount;
+        const string host((index % 10) == 0 ? (_T("unknown") + Number(index) + _T(".example.org")) : (_T("app") + Number(rule) + _T(".example.com")));
+
+        lookups.push_back({ _T("http://") + host + _T(":8080"), _T("Service") + Number(random() % services) + _T(".1.method") });
+    }
+
+    const string expressions(_T("/tmp/acl-expressions.json"));
+    const string wildcards(_T("/tmp/acl-wildcards.json"));
+    Plugin::AccessControlList compiled;
+    Plugin::AccessControlList wildcarded;
+
+    if ((Write(expressions, rules, roles, false) == false) || (Write(wildcards, rules, roles, true) == false) || (Load(expressions, compiled) == false) || (Load(wildcards, wildcarded) == false)) {
+        fprintf(stderr, "Could not generate the ACL files\n");
+        return (1);
+    }
+
+    Baseline baseline(rules, roles);
+
+    const Evaluate before = [&baseline](const Lookup& lookup) -> uint8_t {
+        const Baseline::Role* role = baseline.FilterMapFromURL(lookup.URL);
+        return (role == nullptr ? 0 : (Baseline::Allowed(*role, lookup.Method) ? 2 : 1));
+    };
+    const Evaluate after = [&compiled](const Lookup& lookup) -> uint8_t {
+        const Plugin::AccessControlList::Filter* filter = compiled.FilterMapFromURL(lookup.URL);
+        return (filter == nullptr ? 0 : (filter->Allowed(lookup.Method) ? 2 : 1));
+    };
+    const Evaluate afterWildcards = [&wildcarded](const Lookup& lookup) -> uint8_t {
+        const Plugin::AccessControlList::Filter* filter = wildcarded.FilterMapFromURL(lookup.URL);
+        return (filter == nullptr ? 0 : (filter->Allowed(lookup.Method) ? 2 : 1));
+    };
+
+    uint32_t mismatches = 0;
+    uint32_t allowed = 0;
+
+    for (const Lookup& lookup : lookups) {
+        const uint8_t expected = before(lookup);
+
+        mismatches += ((after(lookup) != expected) || (afterWildcards(lookup) != expected) ? 1 : 0);
+        allowed += (expected == 2 ? 1 : 0);
+    }
+
+    printf("%u rules over %u roles, %u of %u sample lookups allowed\n\n", ruleCount, roleCount, allowed, static_cast<uint32_t>(lookups.size()));
+
+    const double rates[] = { Measure(lookups, before), Measure(lookups, after), Measure(lookups, afterWildcards) };
+
+    printf("%-28s %14.0f lookups/s\n", "regex per lookup (before)", rates[0]);
+    printf("%-28s %14.0f lookups/s %8.1fx\n", "compiled expressions", rates[1], rates[1] / rates[0]);
+    printf("%-28s %14.0f lookups/s %8.1fx\n", "compiled wildcards", rates[2], rates[2] / rates[0]);
+
+    if (mismatches != 0) {
+        printf("\n%u lookup(s) differ from the list before the change\n", mismatches);
+    }
+
+    Core::File(expressions).Destroy();
+    Core::File(wildcards).Destroy();
+
+    Core::Singleton::Dispose();
+
+    return (mismatches == 0 ? 0 : 1);
+}
@@ -0,0 +1,179 @@
+#include "Discipline.h"
+
+#ifndef __WIN32__
+#include <sys/timex.h>
+#endif
+
+#include <cmath>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Offsets beyond this (in seconds) are stepped, they would take too long to slew (STEPT).
+    constexpr double StepThreshold = 0.128;
+
+    // The largest frequency error the kernel accepts, 500 ppm (MAXFREQ).
+    constexpr double MaximumFrequency = 0.0005;
+
+    // Offsets within this many times the jitter count as stable (PGATE in RFC 5905).
+    constexpr double PollGate = 4.0;
+
+    // The weight of a new frequency estimate against the estimates before it.
+    constexpr double FrequencyGain = 0.25;
+
+    // The kernel expresses frequencies in ppm with a 16 bit fraction.
+    constexpr double KernelFrequency = 65536.0 * 1000 * 1000;
+
+    // Polling a server more often than this is considered abuse.
+    constexpr uint16_t MinimumPoll = 16;
+
+    Discipline::Discipline()
+        : _minimumPoll(64)
+        , _maximumPoll(1024)
+        , _poll(64)
+        , _active(false)
+        , _permitted(true)
+        , _frequency(0)
+        , _adjusted(0)
+    {
+    }
+
+    Discipline::~Discipline()
+    {
+    }
+
+    void Discipline::Configure(const uint16_t minimumPoll, const uint16_t maximumPoll)
+    {
+        _minimumPoll = std::max(minimumPoll, MinimumPoll);
+        _maximumPoll = std::max(maximumPoll, _minimumPoll);
+
+        Reset();
+    }
+
+    void Discipline::Reset()
+    {
+        _poll = _minimumPoll;
+        _active = false;
+        _adjusted = 0;
+    }
+
+    bool Discipline::Adjust(const double offset, const double jitter)
+    {
+        bool slewed = false;
+        const uint64_t now = Now();
+
+        if ((_active == true) && (_permitted == true) && (std::fabs(offset) < StepThreshold)) {
+            double pending;
+            double frequency;
+
+            if (State(pending, frequency) == true) {
+                const double interval = static_cast<double>(now - _adjusted) / (1000 * 1000);
+
+                // What is left of the previous slew is still part of the offset, the rest of it built
+                // up since the previous correction because the oscillator runs too fast or too slow.
+                if (interval > 0) {
+                    frequency = _frequency + (FrequencyGain * ((offset - pending) / interval));
+                    frequency = std::max(-MaximumFrequency, std::min(MaximumFrequency, frequency));
+                }
+
+                if ((Tune(frequency) == true) && (Slew(offset) == true)) {
+                    _frequency = frequency;
+                    slewed = true;
+                }
+            }
+
+            if (slewed == false) {
+                TRACE(Trace::Information, (_T("TimeSync: Not permitted to slew the clock, stepping it instead")));
+                _permitted = false;
+            }
+        } else if (_permitted == true) {
+            double pending;
+
+            // The clock will be stepped, drop what is left of a previous slew and start from the
+            // frequency correction the kernel applies right now.
+            if (State(pending, _frequency) == true) {
+                Slew(0);
+            }
+        }
+
+        if ((_active == true) && (std::fabs(offset) < StepThreshold)) {
+            if (std::fabs(offset) < (PollGate * jitter)) {
+                _poll = static_cast<uint16_t>(std::min(static_cast<uint32_t>(_poll) * 2, static_cast<uint32_t>(_maximumPoll)));
+            } else {
+                _poll = std::max(static_cast<uint16_t>(_poll / 2), _minimumPoll);
+            }
+        } else {
+            _poll = _minimumPoll;
+        }
+
+        TRACE(Trace::Information, (_T("TimeSync: Offset %lf s, frequency %lf ppm, next synchronization in %d s"), offset, _frequency * 1000 * 1000, _poll));
+
+        _active = true;
+        _adjusted = now;
+
+        return (slewed);
+    }
+
+    void Discipline::Missed()
+    {
+        _poll = std::max(static_cast<uint16_t>(_poll / 2), _minimumPoll);
+    }
+
+    uint64_t Discipline::Now() const
+    {
+        return (Core::Time::Now().Ticks());
+    }
+
+    bool Discipline::State(double& pending, double& frequency) const
+    {
+#ifdef __WIN32__
+        return (false);
+#else
+        struct timex adjustment;
+
+        memset(&adjustment, 0, sizeof(adjustment));
+        adjustment.modes = ADJ_OFFSET_SS_READ;
+
+        bool result = (::adjtimex(&adjustment) != -1);
+
+        if (result == true) {
+            pending = static_cast<double>(adjustment.offset) / (1000 * 1000);
+            frequency = static_cast<double>(adjustment.freq) / KernelFrequency;
+        }
+
+        return (result);
+#endif
+    }
+
+    bool Discipline::Slew(const double offset)
+    {
+#ifdef __WIN32__
+        return (false);
+#else
+        struct timex adjustment;
+
+        memset(&adjustment, 0, sizeof(adjustment));
+        adjustment.modes = ADJ_OFFSET_SINGLESHOT;
+        adjustment.offset = static_cast<long>(offset * 1000 * 1000);
+
+        return (::adjtimex(&adjustment) != -1);
+#endif
+    }
+
+    bool Discipline::Tune(const double frequency)
+    {
+#ifdef __WIN32__
+        return (false);
+#else
+        struct timex adjustment;
+
+        memset(&adjustment, 0, sizeof(adjustment));
+        adjustment.modes = ADJ_FREQUENCY;
+        adjustment.freq = static_cast<long>(frequency * KernelFrequency);
+
+        return (::adjtimex(&adjustment) != -1);
+#endif
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
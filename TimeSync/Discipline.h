@@ -0,0 +1,70 @@
+#ifndef TIMESYNC_DISCIPLINE_H
+#define TIMESYNC_DISCIPLINE_H
+
+#include "Module.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Keeps the system clock in step with the NTP servers between synchronizations, loosely following
+    // the clock discipline of RFC 5905 (section 11.3). Small offsets are slewed away, the offset that
+    // built up since the previous correction is taken as the frequency error of the local oscillator,
+    // which is corrected as well. The interval to the next synchronization grows as long as the
+    // offsets stay within the jitter, and shrinks when they do not.
+    class Discipline {
+    private:
+        Discipline(const Discipline&) = delete;
+        Discipline& operator=(const Discipline&) = delete;
+
+    public:
+        Discipline();
+        virtual ~Discipline();
+
+    public:
+        // The bounds, in seconds, of the interval between two synchronizations.
+        void Configure(const uint16_t minimumPoll, const uint16_t maximumPoll);
+
+        // Start over, the next offset is stepped.
+        void Reset();
+
+        // Returns true if the offset (in seconds) was slewed, false if the clock should be stepped.
+        bool Adjust(const double offset, const double jitter);
+
+        // Called when a synchronization did not result in an offset.
+        void Missed();
+
+        inline bool IsActive() const
+        {
+            return (_active);
+        }
+        inline uint16_t Poll() const
+        {
+            return (_poll);
+        }
+        inline double Frequency() const
+        {
+            return (_frequency);
+        }
+
+    protected:
+        // The clock of the kernel, a test can stand in for it (see test/DisciplineTest.cpp).
+        virtual uint64_t Now() const;
+        // The part of the previous slew that is not applied yet and the frequency correction of the kernel.
+        virtual bool State(double& pending, double& frequency) const;
+        virtual bool Slew(const double offset);
+        virtual bool Tune(const double frequency);
+
+    private:
+        uint16_t _minimumPoll;
+        uint16_t _maximumPoll;
+        uint16_t _poll;
+        bool _active;
+        bool _permitted;
+        double _frequency;
+        uint64_t _adjusted;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
+
+#endif // TIMESYNC_DISCIPLINE_H
@@ -1,10 +1,91 @@
 #include "NTPClient.h"
 
+#include <cmath>
+
 namespace WPEFramework {
 namespace Plugin {
 
     constexpr uint32_t WaitForResponse = 2000;
 
+    // Every server is asked for a sample this many times, with the given interval in between, to
+    // feed the clock filter.
+    constexpr uint8_t SamplesPerServer = 4;
+    constexpr uint32_t SampleInterval = 250;
+
+    // Lower bound of the root distance in seconds (MINDISP in RFC 5905), it keeps a single server
+    // with a very short delay from outweighing all others.
+    constexpr double MinimumDistance = 0.005;
+
+    // Root delay and root dispersion are sent as 16.16 fixed point numbers.
+    constexpr double Fraction_16_16 = 65536.0;
+
+    double NTPClient::Peer::Distance() const
+    {
+        return (std::max(MinimumDistance, ((_rootDelay + _delay) / 2) + _rootDispersion + _jitter));
+    }
+
+    bool NTPClient::Peer::Resolve()
+    {
+        _node = Core::NodeId(_name.c_str(), Core::NodeId::TYPE_IPV4);
+
+        // Samples of a previous synchronization are outdated by now.
+        _count = 0;
+        _next = 0;
+        _sent = 0;
+        _received = 0;
+        _selected = false;
+
+        return (_node.IsValid());
+    }
+
+    void NTPClient::Peer::Add(const double offset, const double delay, const uint8_t stratum, const double rootDelay, const double rootDispersion)
+    {
+        _samples[_next].Offset = offset;
+        _samples[_next].Delay = delay;
+        _next = (_next + 1) % FilterSize;
+
+        if (_count < FilterSize) {
+            _count++;
+        }
+
+        _received++;
+        _stratum = stratum;
+        _rootDelay = rootDelay;
+        _rootDispersion = rootDispersion;
+
+        uint8_t best = 0;
+
+        for (uint8_t index = 1; index < _count; index++) {
+            if (_samples[index].Delay < _samples[best].Delay) {
+                best = index;
+            }
+        }
+
+        _offset = _samples[best].Offset;
+        _delay = _samples[best].Delay;
+
+        double sum = 0;
+
+        for (uint8_t index = 0; index < _count; index++) {
+            double difference = _samples[index].Offset - _offset;
+            sum += (difference * difference);
+        }
+
+        _jitter = (_count > 1 ? std::sqrt(sum / (_count - 1)) : 0);
+    }
+
+    void NTPClient::Peer::Get(Server& server) const
+    {
+        server.Name = _name;
+        server.Stratum = _stratum;
+        server.Sent = _sent;
+        server.Received = _received;
+        server.Offset = static_cast<int64_t>(_offset * MicroSeconds);
+        server.Delay = static_cast<uint32_t>(_delay * MicroSeconds);
+        server.Jitter = static_cast<uint32_t>(_jitter * MicroSeconds);
+        server.Selected = _selected;
+    }
+
 #ifdef __WIN32__
 #pragma warning(disable : 4355)
 #endif
@@ -13,10 +94,17 @@ namespace Plugin {
         , _adminLock()
         , _packet()
         , _syncedTimestamp()
+        , _offset(0)
+        , _jitter(0)
         , _state(INITIAL)
-        , _fired(true)
+        , _round(0)
+        , _sequence(0)
         , _WaitForNetwork(5000) // Wait for 5 Seconds for a new attempt
         , _retryAttempts(5)
+        , _peers()
+        , _pending()
+        , _outstanding()
+        , _source()
         , _activity(Core::ProxyType<Activity>::Create(this))
         , _clients()
     {
@@ -45,7 +133,7 @@ namespace Plugin {
     {
         _retryAttempts = retries;
         _WaitForNetwork = delay;
-        _servers.clear();
+        _peers.clear();
 
         while (sources.Next() == true) {
             Core::URL url(sources.Current().Value());
@@ -59,11 +147,9 @@ namespace Plugin {
                     hostname += ':' + Core::NumberType<uint16_t>(url.Port().Value()).Text();
                 }
 
-                _servers.push_back(hostname);
+                _peers.emplace_back(hostname);
             }
         }
-
-        _serverIndex = ServerIterator(_servers);
     }
 
     /* virtual */ uint32_t NTPClient::Synchronize()
@@ -74,7 +160,7 @@ namespace Plugin {
 
         _adminLock.Lock();
 
-        if ((_state == INITIAL) || (_state == SUCCESS) || ((_state == FAILED) && (_serverIndex.IsValid() == false))) {
+        if ((_state == INITIAL) || (_state == SUCCESS) || (_state == FAILED)) {
             result = Core::ERROR_NONE;
             _state = SENDREQUEST;
             PluginHost::WorkerPool::Instance().Submit(_activity);
@@ -113,7 +199,19 @@ namespace Plugin {
 
     /* virtual */ string NTPClient::Source() const
     {
-        return (_serverIndex.IsValid() == true ? string(_T("NTP://")) + (*_serverIndex) + '/' : _T("NTP:///"));
+        return (_source.empty() == false ? string(_T("NTP://")) + _source + '/' : _T("NTP:///"));
+    }
+
+    void NTPClient::Servers(std::list<Server>& servers)
+    {
+        _adminLock.Lock();
+
+        for (const Peer& peer : _peers) {
+            servers.emplace_back();
+            peer.Get(servers.back());
+        }
+
+        _adminLock.Unlock();
     }
 
     /* virtual */ void NTPClient::Register(Exchange::ITimeSync::INotification* notification)
@@ -151,17 +249,35 @@ namespace Plugin {
 
         _adminLock.Lock();
 
-        if (_fired == false) {
+        if (_pending.empty() == false) {
 
-            _fired = true;
+            const uint16_t index = _pending.front();
+            Peer& peer(_peers[index]);
+
+            _pending.pop_front();
+
+            // The nanoseconds below the resolution of the clock are used to tell the requests of
+            // this round apart, whatever the servers they are sent to.
+            uint64_t now = Core::Time::Now().Ticks();
+            timespec transmit;
+            transmit.tv_sec = static_cast<time_t>(now / MicroSeconds);
+            transmit.tv_nsec = static_cast<long>(((now % MicroSeconds) * (NanoSeconds / MicroSeconds)) + (_sequence++ % (NanoSeconds / MicroSeconds)));
+
+            NTPPacket::Timestamp timestamp(transmit);
 
             DataFrame newFrame(dataFrame, maxSendSize);
             DataFrame::Writer writer(newFrame, 0);
-            _packet.TransmitTimestamp(NTPPacket::Timestamp(Core::Time::Now()));
+            _packet.TransmitTimestamp(timestamp);
             _packet.Serialize(writer);
 
+            _outstanding.push_back({ timestamp.Seconds(), timestamp.Fraction(), index });
+            peer.Sent();
+
+            // The socket is not bound to a single server, the datagram goes to the one set here.
+            RemoteNode(peer.Node());
+
             result = newFrame.Size();
-            TRACE_L1("Timesync: Send data: %d bytes", result);
+            TRACE_L1("Timesync: Send data: %d bytes to %s", result, peer.Name().c_str());
         }
 
         _adminLock.Unlock();
@@ -169,14 +285,9 @@ namespace Plugin {
         return result;
     }
 
-    inline static uint64_t SecondsToTicks(double seconds)
-    {
-        return static_cast<uint64_t>(seconds * NTPClient::MicroSeconds);
-    }
-
     /* virtual */ uint16_t NTPClient::ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize)
     {
-        double received = static_cast<double>(Core::Time::Now().Ticks() / MicroSeconds);
+        double received = NTPPacket::Timestamp(Core::Time::Now()).TimeSeconds();
 
         TRACE_L1("Timesync: Received data: %d bytes", receivedSize);
 
@@ -192,49 +303,49 @@ namespace Plugin {
 // packet.DisplayPacket();
 #endif
 
-            double receivedServerTS = packet.ReceiveTimestamp().TimeSeconds();
-            double sentServerTS = packet.TransmitTimestamp().TimeSeconds();
-            double sentTS = packet.OriginalTimestamp().TimeSeconds();
+            const NTPPacket::Timestamp original(packet.OriginalTimestamp());
+            std::list<Request>::iterator index(_outstanding.begin());
 
-            double diffRequest = receivedServerTS - sentTS;
-            double diffResponse = sentServerTS - received;
-            double offset = (diffRequest + diffResponse) / 2;
+            while ((index != _outstanding.end()) && ((index->Seconds != original.Seconds()) || (index->Fraction != original.Fraction()))) {
+                index++;
+            }
 
-#ifdef __DEBUG__
-            double elapsedServer = sentServerTS - receivedServerTS;
-            double elapsedTotal = received - sentTS;
-            double roundTrip = elapsedTotal - elapsedServer;
-#endif
+            if (index == _outstanding.end()) {
+                TRACE_L1("TimeSync: %s", "Dropped a response that does not answer any of our requests");
+            } else {
+                Peer& peer(_peers[index->Peer]);
 
-            TRACE_L1("Request time diff  = %lf", diffRequest);
-            TRACE_L1("Response time diff = %lf", diffResponse);
-            TRACE_L1("Offset time        = %lf", offset);
+                _outstanding.erase(index);
 
-#ifdef __DEBUG__
-            TRACE_L1("Server elapsed time = %lf", elapsedServer);
-            TRACE_L1("Total elapsed time  = %lf", elapsedTotal);
-            TRACE_L1("Round trip time     = %lf", roundTrip);
-#endif
-            TRACE(Trace::Information, (_T("TimeSync: Request time diff   = %lf s"), diffRequest));
-            TRACE(Trace::Information, (_T("TimeSync: Response time diff  = %lf s"), diffResponse));
-            TRACE(Trace::Information, (_T("TimeSync: Offset time         = %lf s"), offset));
+                if ((packet.LeapIndicator() == 0x03) || (packet.Stratum() == 0) || (packet.Stratum() >= 16) || (packet.NTPMode() != 0x04)) {
+                    TRACE(Trace::Information, (_T("TimeSync: %s is not synchronized, response ignored"), peer.Name().c_str()));
+                } else {
+                    double receivedServerTS = packet.ReceiveTimestamp().TimeSeconds();
+                    double sentServerTS = packet.TransmitTimestamp().TimeSeconds();
+                    double sentTS = original.TimeSeconds();
 
-            uint64_t receivedTicks = SecondsToTicks(received);
-            TRACE(Trace::Information, (_T("TimeSync: Current time: %s"), Core::Time(receivedTicks).ToRFC1123(false).c_str()));
-            _syncedTimestamp = Core::Time(receivedTicks + SecondsToTicks(offset));
-            TRACE(Trace::Information, (_T("TimeSync: New time:     %s"), _syncedTimestamp.ToRFC1123(false).c_str()));
+                    double diffRequest = receivedServerTS - sentTS;
+                    double diffResponse = sentServerTS - received;
+                    double offset = (diffRequest + diffResponse) / 2;
+                    double roundTrip = std::max(0.0, (received - sentTS) - (sentServerTS - receivedServerTS));
 
-            _state = SUCCESS;
+                    TRACE_L1("Offset time        = %lf", offset);
+                    TRACE_L1("Round trip time    = %lf", roundTrip);
 
-            // We don't need the socket anymore, so close it
-            TRACE_L1("TimeSync: %s", "Closing socket, no longer needed");
-            Close(0);
+                    peer.Add(offset, roundTrip, packet.Stratum(), packet.RootDelay() / Fraction_16_16, packet.RootDispersion() / Fraction_16_16);
 
-            // Lets remove the watchdog subject, we do not want to wait anymore, we got an answer.
-            PluginHost::WorkerPool::Instance().Revoke(_activity);
+                    TRACE(Trace::Information, (_T("TimeSync: %s offset = %lf s, delay = %lf s, jitter = %lf s"), peer.Name().c_str(), peer.Offset(), peer.Delay(), peer.Jitter()));
+                }
 
-            // Schedule it again to broadcast the successfull update of the time.
-            PluginHost::WorkerPool::Instance().Submit(_activity);
+                if ((_state == INPROGRESS) && (_round == SamplesPerServer) && (_pending.empty() == true) && (_outstanding.empty() == true)) {
+
+                    // Lets remove the watchdog subject, we do not want to wait anymore, all answers are in.
+                    PluginHost::WorkerPool::Instance().Revoke(_activity);
+
+                    // Schedule it again to select the offset and broadcast the update of the time.
+                    PluginHost::WorkerPool::Instance().Submit(_activity);
+                }
+            }
         }
 
         _adminLock.Unlock();
@@ -247,14 +358,19 @@ namespace Plugin {
     {
         if (HasError() == true) {
             Close(0);
+
+            _adminLock.Lock();
+            _pending.clear();
+            _round = SamplesPerServer;
+            _adminLock.Unlock();
+
             PluginHost::WorkerPool::Instance().Revoke(_activity);
             PluginHost::WorkerPool::Instance().Submit(_activity);
         }
     }
 
-    bool NTPClient::FireRequest()
+    bool NTPClient::Resolve()
     {
-
         bool activated = false;
 
         // Make sure socket is closed otherwise an assert will fire.
@@ -263,31 +379,150 @@ namespace Plugin {
             Close(1000);
         }
 
+        _pending.clear();
+        _outstanding.clear();
+
         if (true == IsClosed()) {
-            while ((activated == false) && (_serverIndex.Next() == true)) {
+            const Peer* first = nullptr;
 
-                // Set the socket to send to the remote
-                Core::NodeId remote((*_serverIndex).c_str(), Core::NodeId::TYPE_IPV4);
+            for (Peer& peer : _peers) {
+                if ((peer.Resolve() == true) && (first == nullptr)) {
+                    first = &peer;
+                }
+            }
 
-                if (remote.IsValid() == true) {
-                    // Set the remote endpoint for the socket to the selected NTP server
-                    RemoteNode(remote);
-                    LocalNode(remote.AnyInterface());
+            if (first != nullptr) {
+                // One socket serves all servers, the remote is set per request.
+                LocalNode(first->Node().AnyInterface());
 
-                    // UDP should open by definition directly...
-                    uint32_t status = Open(100);
+                // UDP should open by definition directly...
+                uint32_t status = Open(100);
 
-                    if ((status == Core::ERROR_NONE) || (status == Core::ERROR_INPROGRESS)) {
+                activated = ((status == Core::ERROR_NONE) || (status == Core::ERROR_INPROGRESS));
+            }
+        }
+
+        return (activated);
+    }
+
+    void NTPClient::Sample()
+    {
+        for (uint16_t index = 0; index < _peers.size(); index++) {
+            if (_peers[index].IsResolved() == true) {
+                _pending.push_back(index);
+            }
+        }
+
+        _round++;
+
+        Trigger();
+    }
+
+    // The selection of RFC 5905 (section 11.2.1): every peer claims the true offset lies within its
+    // offset plus or minus its root distance. The peers whose claims overlap in the interval shared
+    // by the largest majority are the truechimers, the others are falsetickers and are discarded.
+    // The offset is the average of the truechimers weighted by their root distance, the source is
+    // the truechimer with the smallest root distance. The jitter combines that of the source with
+    // the spread of the truechimers around the offset.
+    bool NTPClient::Select(double& offset, double& jitter)
+    {
+        std::vector<std::pair<double, int8_t>> edges;
+        uint16_t candidates = 0;
+
+        for (Peer& peer : _peers) {
+            peer.Selected(false);
+
+            if (peer.IsValid() == true) {
+                const double distance = peer.Distance();
+
+                edges.emplace_back(peer.Offset() - distance, -1);
+                edges.emplace_back(peer.Offset() + distance, +1);
+                candidates++;
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+
+        double low = 0;
+        double high = 0;
+        bool found = false;
+
+        for (uint16_t falsetickers = 0; (found == false) && ((2 * falsetickers) < candidates); falsetickers++) {
+            int16_t chime = 0;
+
+            for (auto index = edges.cbegin(); index != edges.cend(); index++) {
+                chime -= index->second;
+                if (chime >= (candidates - falsetickers)) {
+                    low = index->first;
+                    break;
+                }
+            }
+
+            chime = 0;
+
+            for (auto index = edges.crbegin(); index != edges.crend(); index++) {
+                chime += index->second;
+                if (chime >= (candidates - falsetickers)) {
+                    high = index->first;
+                    break;
+                }
+            }
+
+            found = (low <= high);
+        }
+
+        Peer* source = nullptr;
+        double weights = 0;
+
+        offset = 0;
+
+        for (Peer& peer : _peers) {
+            if (peer.IsValid() == true) {
+                const double distance = peer.Distance();
 
-                        activated = true;
-                        _fired = false;
-                        Trigger();
+                if ((found == false) || (((peer.Offset() - distance) <= high) && ((peer.Offset() + distance) >= low))) {
+
+                    if ((source == nullptr) || (distance < source->Distance())) {
+                        source = &peer;
+                    }
+                    if (found == true) {
+                        peer.Selected(true);
+                        offset += (peer.Offset() / distance);
+                        weights += (1 / distance);
                     }
                 }
             }
         }
 
-        return (activated);
+        if (source != nullptr) {
+            if (found == false) {
+                // No majority agrees, rather than leaving the time unsynchronized go with the server
+                // that claims the smallest error.
+                TRACE(Trace::Information, (_T("TimeSync: The servers do not agree, using %s"), source->Name().c_str()));
+
+                source->Selected(true);
+                offset = source->Offset();
+            } else {
+                offset /= weights;
+            }
+
+            double sum = 0;
+            uint16_t selected = 0;
+
+            for (const Peer& peer : _peers) {
+                if (peer.Selected() == true) {
+                    double difference = peer.Offset() - offset;
+                    sum += (difference * difference);
+                    selected++;
+                }
+            }
+
+            jitter = std::sqrt((source->Jitter() * source->Jitter()) + (selected > 1 ? sum / (selected - 1) : 0));
+
+            _source = source->Name();
+        }
+
+        return (source != nullptr);
     }
 
     void NTPClient::Update()
@@ -311,34 +546,65 @@ namespace Plugin {
 
         _adminLock.Lock();
 
-        state oldState = _state;
-
         switch (_state) {
         case SENDREQUEST: {
-            // This case means that nothing has started yet, let reset the list of servers and start at the beginning...
-            _serverIndex.Reset(0);
-            _state = INPROGRESS;
-        }
-        case INPROGRESS: {
-            // If we end up here in this state, it means that the package was send but no response was received,
-            // or a response was received but is was not properly formatted...
-            // Lets move to the next server in the list, see if that one responds correctly
-            if (FireRequest() == true) {
-                result = WaitForResponse;
+            // This case means that nothing has started yet, resolve all servers and open the socket to reach them.
+            if (Resolve() == true) {
+                _round = 0;
+                _state = INPROGRESS;
             } else {
-                if ((oldState == SENDREQUEST) && (_retryAttempts-- != 0)) {
+                if (_retryAttempts-- != 0) {
 
                     // Looks like there is no network connectivity, Just sleep and retry later
                     result = _WaitForNetwork;
                 } else {
 
-                    // Looks like there is no valid server anymore that we could use. There where servers
-                    // that did resolve correctly, so it is not a network connectivity problem.
                     _state = FAILED;
 
                     // Report the failure. Always report back when we are finished.
                     Update();
                 }
+                break;
+            }
+        }
+        case INPROGRESS: {
+            if (_round < SamplesPerServer) {
+                // Ask every server for another sample, after the last round give the stragglers
+                // some time to respond.
+                Sample();
+                result = (_round < SamplesPerServer ? SampleInterval : WaitForResponse);
+            } else {
+                double offset;
+                double jitter;
+
+                // We don't need the socket anymore, so close it
+                TRACE_L1("TimeSync: %s", "Closing socket, no longer needed");
+                Close(0);
+
+                _pending.clear();
+                _outstanding.clear();
+
+                if (Select(offset, jitter) == true) {
+                    uint64_t now = Core::Time::Now().Ticks();
+
+                    TRACE(Trace::Information, (_T("TimeSync: Offset time         = %lf s from %s"), offset, _source.c_str()));
+                    TRACE(Trace::Information, (_T("TimeSync: Current time: %s"), Core::Time(now).ToRFC1123(false).c_str()));
+                    _syncedTimestamp = Core::Time(now + static_cast<int64_t>(offset * MicroSeconds));
+                    TRACE(Trace::Information, (_T("TimeSync: New time:     %s"), _syncedTimestamp.ToRFC1123(false).c_str()));
+
+                    _offset = offset;
+                    _jitter = jitter;
+
+                    _state = SUCCESS;
+                } else {
+
+                    // None of the servers that did resolve gave a valid response, so it is not a network
+                    // connectivity problem.
+                    _state = FAILED;
+                }
+
+                // Report back, always when we are finished.
+                Update();
             }
             break;
         }
@@ -15,18 +15,29 @@ namespace Plugin {
 
         using SourceIterator = Core::JSON::ArrayType<Core::JSON::String>::Iterator;
 
+        // The state of a server as seen during the last synchronization. The offset, delay and jitter
+        // are expressed in microseconds.
+        struct Server {
+            string Name;
+            uint8_t Stratum;
+            uint16_t Sent;
+            uint16_t Received;
+            int64_t Offset;
+            uint32_t Delay;
+            uint32_t Jitter;
+            bool Selected;
+        };
+
     private:
-        using ServerList = std::vector<string>;
-        using ServerIterator = Core::IteratorType<const ServerList, const string&, ServerList::const_iterator>;
         using DataFrame = Core::FrameType<0>;
 
         // This enum tracks the state for actions begin performed. As the Worker() method is re-entered,
         // we need to keep track of state.
         enum state {
             INITIAL, // Initial state
-            SENDREQUEST, // Let send out an NTP request to a legitimate server.
-            INPROGRESS, // A request has been sent to a NTP server, waiting for a response
-            SUCCESS, // Action succeeded, we received a valid response from an NTP server
+            SENDREQUEST, // Let send out NTP requests to all legitimate servers.
+            INPROGRESS, // Requests have been sent to the NTP servers, collecting the responses
+            SUCCESS, // Action succeeded, the responses agreed on the offset of the local clock
             FAILED // Action failed, we did not receive any valid response from any of the NTP servers
         };
         // As this forms the exact package to be sent for NTP, we need to make sure all members are byte
@@ -309,6 +320,118 @@ namespace Plugin {
                 // bit (NTP time)
         };
 
+        // A server together with the samples it returned. The clock filter of RFC 5905 (section 10)
+        // trusts the sample with the lowest round trip delay, as it suffered the least from queueing
+        // in the network, and takes the spread of the other samples around it as the jitter.
+        class Peer {
+        public:
+            static constexpr uint8_t FilterSize = 8;
+
+        private:
+            struct Sample {
+                double Offset;
+                double Delay;
+            };
+
+        public:
+            Peer() = delete;
+
+            Peer(const string& name)
+                : _name(name)
+                , _node()
+                , _samples()
+                , _count(0)
+                , _next(0)
+                , _sent(0)
+                , _received(0)
+                , _stratum(0)
+                , _rootDelay(0)
+                , _rootDispersion(0)
+                , _offset(0)
+                , _delay(0)
+                , _jitter(0)
+                , _selected(false)
+            {
+            }
+            ~Peer()
+            {
+            }
+
+        public:
+            inline const string& Name() const
+            {
+                return (_name);
+            }
+            inline const Core::NodeId& Node() const
+            {
+                return (_node);
+            }
+            inline bool IsResolved() const
+            {
+                return (_node.IsValid());
+            }
+            // A peer is a candidate for the selection as soon as it returned a valid sample.
+            inline bool IsValid() const
+            {
+                return (_count != 0);
+            }
+            inline double Offset() const
+            {
+                return (_offset);
+            }
+            inline double Delay() const
+            {
+                return (_delay);
+            }
+            inline double Jitter() const
+            {
+                return (_jitter);
+            }
+            inline bool Selected() const
+            {
+                return (_selected);
+            }
+            inline void Selected(const bool selected)
+            {
+                _selected = selected;
+            }
+            inline void Sent()
+            {
+                _sent++;
+            }
+            // The root distance, the maximum error of the offset of this peer relative to the primary
+            // reference it is synchronized to.
+            double Distance() const;
+
+            bool Resolve();
+            void Add(const double offset, const double delay, const uint8_t stratum, const double rootDelay, const double rootDispersion);
+            void Get(Server& server) const;
+
+        private:
+            string _name;
+            Core::NodeId _node;
+            Sample _samples[FilterSize];
+            uint8_t _count;
+            uint8_t _next;
+            uint16_t _sent;
+            uint16_t _received;
+            uint8_t _stratum;
+            double _rootDelay;
+            double _rootDispersion;
+            double _offset;
+            double _delay;
+            double _jitter;
+            bool _selected;
+        };
+
+        // A request that is sent but not answered yet. The transmit timestamp of a request is unique
+        // and returned by the server as the originate timestamp of its reply.
+        struct Request {
+            uint32_t Seconds;
+            uint32_t Fraction;
+            uint16_t Peer;
+        };
+
         class Activity : public Core::IDispatchType<void> {
         private:
             Activity() = delete;
@@ -353,6 +476,18 @@ namespace Plugin {
         virtual string Source() const override;
         virtual uint64_t SyncTime() const override;
 
+        void Servers(std::list<Server>& servers);
+
+        // Offset of the local clock and its jitter (in seconds) found by the last successful synchronization.
+        inline double Offset() const
+        {
+            return (_offset);
+        }
+        inline double Jitter() const
+        {
+            return (_jitter);
+        }
+
         // ITime methods
         virtual uint64_t TimeSync() const override
         {
@@ -374,18 +509,25 @@ namespace Plugin {
 
         void Update();
         void Dispatch();
-        bool FireRequest();
+        bool Resolve();
+        void Sample();
+        bool Select(double& offset, double& jitter);
 
     private:
         Core::CriticalSection _adminLock;
         NTPPacket _packet;
         Core::Time _syncedTimestamp;
+        double _offset;
+        double _jitter;
         state _state;
-        bool _fired;
+        uint8_t _round;
+        uint32_t _sequence;
         uint32_t _WaitForNetwork;
         uint32_t _retryAttempts;
-        ServerList _servers;
-        ServerIterator _serverIndex;
+        std::vector<Peer> _peers;
+        std::list<uint16_t> _pending;
+        std::list<Request> _outstanding;
+        string _source;
         Core::ProxyType<Core::IDispatchType<void>> _activity;
         std::list<Exchange::ITimeSync::INotification*> _clients;
     };
@@ -18,6 +18,9 @@ namespace Plugin {
     TimeSync::TimeSync()
         : _skipURL(0)
         , _periodicity(0)
+        , _disciplined(false)
+        , _syncedTime(0)
+        , _discipline()
         , _client(Core::Service<NTPClient>::Create<Exchange::ITimeSync>())
         , _activity(Core::ProxyType<PeriodicSync>::Create(_client))
         , _sink(this)
@@ -42,6 +45,8 @@ namespace Plugin {
         string version = service->Version();
         _skipURL = static_cast<uint16_t>(service->WebPrefix().length());
         _periodicity = config.Periodicity.Value() * 60 /* minutes */ * 60 /* seconds */ * 1000 /* milliSeconds */;
+        _disciplined = config.Discipline.Value();
+        _discipline.Configure(config.MinimumPoll.Value(), config.MaximumPoll.Value());
         bool start = (((config.Deferred.IsSet() == true) && (config.Deferred.Value() == true)) == false);
 
         NTPClient::SourceIterator index(config.Sources.Elements());
@@ -137,6 +142,7 @@ namespace Plugin {
                         // Stop automatic synchronisation
                         _client->Cancel();
                         PluginHost::WorkerPool::Instance().Revoke(_activity);
+                        _discipline.Reset();
 
                         if (newTime.IsValid()) {
                             Core::SystemInfo::Instance().SetTime(newTime);
@@ -153,16 +159,42 @@ namespace Plugin {
 
     void TimeSync::SyncedTime(const uint64_t time)
     {
-        Core::Time newTime(time);
+        uint32_t interval = (time != 0 ? _periodicity : 0);
 
-        TRACE(Trace::Information, (_T("Syncing time to %s."), newTime.ToRFC1123(false).c_str()));
+        if ((time != 0) && (time != _syncedTime)) {
+            Core::Time newTime(time);
+            const NTPClient* client = static_cast<const NTPClient*>(_client);
 
-        Core::SystemInfo::Instance().SetTime(newTime);
+            _syncedTime = time;
 
-        if (_periodicity != 0) {
+            if ((_disciplined == true) && (_discipline.Adjust(client->Offset(), client->Jitter()) == true)) {
+                TRACE(Trace::Information, (_T("Slewing time to %s."), newTime.ToRFC1123(false).c_str()));
+            } else {
+                TRACE(Trace::Information, (_T("Syncing time to %s."), newTime.ToRFC1123(false).c_str()));
+
+                Core::SystemInfo::Instance().SetTime(newTime);
+            }
+
+            EnsureSubsystemIsActive();
+
+            if (_disciplined == true) {
+                interval = _discipline.Poll() * 1000 /* milliSeconds */;
+            }
+        } else if (_disciplined == true) {
+            // The synchronization failed or was cancelled. Unless the time was set by hand in the
+            // mean time, try again sooner.
+            interval = 0;
+
+            if (_discipline.IsActive() == true) {
+                _discipline.Missed();
+                interval = _discipline.Poll() * 1000 /* milliSeconds */;
+            }
+        }
+
+        if (interval != 0) {
             Core::Time newSyncTime(Core::Time::Now());
 
-            newSyncTime.Add(_periodicity);
+            newSyncTime.Add(interval);
 
             // Seems we are synchronised with the time. Schedule the next timesync.
             TRACE_L1("Waking up again at %s.", newSyncTime.ToRFC1123(false).c_str());
@@ -2,6 +2,7 @@
 #define TIMESYNC_H
 
 #include "Module.h"
+#include "Discipline.h"
 #include <interfaces/ITimeSync.h>
 #include <interfaces/json/JsonData_TimeSync.h>
 
@@ -55,6 +56,57 @@ namespace Plugin {
             TimeRep Time;
         };
 
+        class ServerData : public Core::JSON::Container {
+        public:
+            ServerData& operator=(ServerData const& other) = delete;
+
+            ServerData()
+                : Core::JSON::Container()
+            {
+                Init();
+            }
+            ServerData(ServerData const& other)
+                : Core::JSON::Container()
+                , Server(other.Server)
+                , Stratum(other.Stratum)
+                , Sent(other.Sent)
+                , Received(other.Received)
+                , Offset(other.Offset)
+                , Delay(other.Delay)
+                , Jitter(other.Jitter)
+                , Selected(other.Selected)
+            {
+                Init();
+            }
+
+            virtual ~ServerData()
+            {
+            }
+
+        private:
+            void Init()
+            {
+                Add(_T("server"), &Server);
+                Add(_T("stratum"), &Stratum);
+                Add(_T("sent"), &Sent);
+                Add(_T("received"), &Received);
+                Add(_T("offset"), &Offset);
+                Add(_T("delay"), &Delay);
+                Add(_T("jitter"), &Jitter);
+                Add(_T("selected"), &Selected);
+            }
+
+        public:
+            Core::JSON::String Server;
+            Core::JSON::DecUInt8 Stratum;
+            Core::JSON::DecUInt16 Sent;
+            Core::JSON::DecUInt16 Received;
+            Core::JSON::DecSInt64 Offset;
+            Core::JSON::DecUInt32 Delay;
+            Core::JSON::DecUInt32 Jitter;
+            Core::JSON::Boolean Selected;
+        };
+
     private:
         class Notification : protected Exchange::ITimeSync::INotification {
         private:
@@ -103,12 +155,7 @@ namespace Plugin {
 
             virtual void Completed()
             {
-                uint64_t timeTicks = _client->SyncTime();
-
-                if (timeTicks != 0) {
-                    _parent.SyncedTime(timeTicks);
-                    _parent.EnsureSubsystemIsActive();
-                }
+                _parent.SyncedTime(_client->SyncTime());
             }
 
             BEGIN_INTERFACE_MAP(Notification)
@@ -133,12 +180,18 @@ namespace Plugin {
                 , Retries(8)
                 , Sources()
                 , Periodicity(0)
+                , Discipline(false)
+                , MinimumPoll(64)
+                , MaximumPoll(1024)
             {
                 Add(_T("deferred"), &Deferred);
                 Add(_T("interval"), &Interval);
                 Add(_T("retries"), &Retries);
                 Add(_T("sources"), &Sources);
                 Add(_T("periodicity"), &Periodicity);
+                Add(_T("discipline"), &Discipline);
+                Add(_T("minpoll"), &MinimumPoll);
+                Add(_T("maxpoll"), &MaximumPoll);
             }
             ~Config()
             {
@@ -150,6 +203,9 @@ namespace Plugin {
             Core::JSON::DecUInt8 Retries;
             Core::JSON::ArrayType<Core::JSON::String> Sources;
             Core::JSON::DecUInt16 Periodicity;
+            Core::JSON::Boolean Discipline;
+            Core::JSON::DecUInt16 MinimumPoll;
+            Core::JSON::DecUInt16 MaximumPoll;
         };
 
         class PeriodicSync : public Core::IDispatchType<void> {
@@ -219,12 +275,16 @@ namespace Plugin {
         void UnregisterAll();
         uint32_t endpoint_synchronize();
         uint32_t get_synctime(JsonData::TimeSync::SynctimeData& response) const;
+        uint32_t get_servers(Core::JSON::ArrayType<ServerData>& response) const;
         uint32_t get_time(Core::JSON::String& response) const;
         uint32_t set_time(const Core::JSON::String& param);
 
     private:
         uint16_t _skipURL;
         uint32_t _periodicity;
+        bool _disciplined;
+        uint64_t _syncedTime;
+        Discipline _discipline;
         Exchange::ITimeSync* _client;
         Core::ProxyType<Core::IDispatchType<void>> _activity;
         Core::Sink<Notification> _sink;
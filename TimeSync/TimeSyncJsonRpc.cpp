@@ -1,6 +1,7 @@
 
 #include <interfaces/json/JsonData_TimeSync.h>
 #include "TimeSync.h"
+#include "NTPClient.h"
 #include "Module.h"
 
 namespace WPEFramework {
@@ -16,6 +17,7 @@ namespace Plugin {
     {
         Register<void,void>(_T("synchronize"), &TimeSync::endpoint_synchronize, this);
         Property<SynctimeData>(_T("synctime"), &TimeSync::get_synctime, nullptr, this);
+        Property<Core::JSON::ArrayType<ServerData>>(_T("servers"), &TimeSync::get_servers, nullptr, this);
         Property<Core::JSON::String>(_T("time"), &TimeSync::get_time, &TimeSync::set_time, this);
     }
 
@@ -24,6 +26,7 @@ namespace Plugin {
         Unregister(_T("synchronize"));
         Unregister(_T("time"));
         Unregister(_T("synctime"));
+        Unregister(_T("servers"));
     }
 
     // API implementation
@@ -59,6 +62,31 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Property: servers - State of the NTP servers during the last synchronization
+    // Return codes:
+    //  - ERROR_NONE: Success
+    uint32_t TimeSync::get_servers(Core::JSON::ArrayType<ServerData>& response) const
+    {
+        std::list<NTPClient::Server> servers;
+
+        static_cast<NTPClient*>(_client)->Servers(servers);
+
+        for (const NTPClient::Server& server : servers) {
+            ServerData& entry(response.Add());
+
+            entry.Server = server.Name;
+            entry.Stratum = server.Stratum;
+            entry.Sent = server.Sent;
+            entry.Received = server.Received;
+            entry.Offset = server.Offset;
+            entry.Delay = server.Delay;
+            entry.Jitter = server.Jitter;
+            entry.Selected = server.Selected;
+        }
+
+        return Core::ERROR_NONE;
+    }
+
     // Property: time - Current system time
     // Return codes:
     //  - ERROR_NONE: Success
@@ -90,6 +118,7 @@ namespace Plugin {
             // Stop automatic synchronisation
             _client->Cancel();
             PluginHost::WorkerPool::Instance().Revoke(_activity);
+            _discipline.Reset();
 
             if (newTime.IsValid()) {
                 Core::SystemInfo::Instance().SetTime(newTime);
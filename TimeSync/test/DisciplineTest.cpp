@@ -0,0 +1,270 @@
+// Runs the clock discipline of the TimeSync plugin against a simulated kernel clock, so hours of
+// synchronizations take less than a second. The local oscillator runs off by a fixed frequency
+// error, a slew is applied at the 500 ppm the kernel uses, and every synchronization measures the
+// offset like the NTP client does: a few exchanges with a stand-in server over a path with an
+// injected (random) delay, of which the one with the shortest round trip is used.
+//
+//     DisciplineTest
+//
+// Returns 0 if all checks pass.
+
+#include "Discipline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+class Kernel : public Plugin::Discipline {
+public:
+    Kernel(const double drift)
+        : Plugin::Discipline()
+        , _drift(drift)
+        , _true(1000000000.0)
+        , _local(_true)
+        , _pending(0)
+        , _frequency(0)
+        , _permitted(true)
+    {
+    }
+    ~Kernel() override
+    {
+    }
+
+public:
+    inline void Permitted(const bool permitted)
+    {
+        _permitted = permitted;
+    }
+    inline double Error() const
+    {
+        return (_true - _local);
+    }
+    inline double Frequency() const
+    {
+        return (_frequency);
+    }
+    // Sets the local clock, like the plugin does when it steps the time.
+    inline void Step(const double offset)
+    {
+        _local += offset;
+    }
+    // Lets the (true) time pass, in steps of a second.
+    void Run(const uint32_t seconds)
+    {
+        // The kernel slews a singleshot adjustment at 500 ppm.
+        const double rate = 0.0005;
+
+        for (uint32_t index = 0; index < seconds; index++) {
+            const double slew = std::max(-rate, std::min(rate, _pending));
+
+            _true += 1.0;
+            _local += 1.0 + _drift + _frequency + slew;
+            _pending -= slew;
+        }
+    }
+    // One exchange with the stand-in server, returns the offset and the round trip delay.
+    void Exchange(const double delay, const double jitter, double& offset, double& roundtrip) const
+    {
+        const double outbound = delay + (jitter * (rand() / static_cast<double>(RAND_MAX)));
+        const double inbound = delay + (jitter * (rand() / static_cast<double>(RAND_MAX)));
+
+        const double t1 = _local;
+        const double t2 = _true + outbound;
+        const double t3 = t2;
+        const double t4 = _local + outbound + inbound;
+
+        offset = ((t2 - t1) + (t3 - t4)) / 2;
+        roundtrip = (t4 - t1) - (t3 - t2);
+    }
+    // A synchronization: the offset of the fastest exchange and the spread of the others around it.
+    void Synchronize(const double delay, const double jitter, double& offset, double& spread) const
+    {
+        static constexpr uint8_t Exchanges = 4;
+        double offsets[Exchanges];
+        double best = 0;
+
+        for (uint8_t index = 0; index < Exchanges; index++) {
+            double roundtrip;
+
+            Exchange(delay, jitter, offsets[index], roundtrip);
+
+            if ((index == 0) || (roundtrip < best)) {
+                best = roundtrip;
+                offset = offsets[index];
+            }
+        }
+
+        spread = 0;
+        for (uint8_t index = 0; index < Exchanges; index++) {
+            spread += (offsets[index] - offset) * (offsets[index] - offset);
+        }
+        spread = std::max(sqrt(spread / (Exchanges - 1)), 0.000001);
+    }
+
+protected:
+    uint64_t Now() const override
+    {
+        return (static_cast<uint64_t>(_true * 1000000));
+    }
+    bool State(double& pending, double& frequency) const override
+    {
+        pending = _pending;
+        frequency = _frequency;
+        return (_permitted);
+    }
+    bool Slew(const double offset) override
+    {
+        if (_permitted == true) {
+            _pending = offset;
+        }
+        return (_permitted);
+    }
+    bool Tune(const double frequency) override
+    {
+        if (_permitted == true) {
+            _frequency = frequency;
+        }
+        return (_permitted);
+    }
+
+private:
+    const double _drift;
+    double _true;
+    double _local;
+    double _pending;
+    double _frequency;
+    bool _permitted;
+};
+
+// Runs a number of synchronizations, like TimeSync does: slew if the discipline can, step otherwise.
+// Returns the number of synchronizations that were stepped.
+uint32_t Synchronize(Kernel& kernel, const uint32_t count, const double delay, const double jitter, const double reported = 0)
+{
+    uint32_t stepped = 0;
+
+    for (uint32_t index = 0; index < count; index++) {
+        double offset, spread;
+
+        kernel.Synchronize(delay, jitter, offset, spread);
+
+        if (kernel.Adjust(offset, (reported != 0 ? reported : spread)) == false) {
+            kernel.Step(offset);
+            stepped++;
+        }
+
+        kernel.Run(kernel.Poll());
+    }
+
+    return (stepped);
+}
+
+uint32_t _failures = 0;
+
+void Check(const bool condition, const char description[])
+{
+    printf("%s: %s\n", (condition == true ? "PASS" : "FAIL"), description);
+
+    if (condition == false) {
+        _failures++;
+    }
+}
+
+void Stable()
+{
+    // 50 ppm fast, a 20 ms path with up to 1 ms jitter per leg.
+    Kernel kernel(0.000050);
+
+    kernel.Configure(64, 1024);
+    kernel.Step(2.0);
+
+    Check(Synchronize(kernel, 1, 0.020, 0.001) == 1, "the first synchronization steps the clock");
+    Check(kernel.Poll() == 64, "the first synchronization keeps the minimum poll interval");
+
+    const uint32_t stepped = Synchronize(kernel, 40, 0.020, 0.001);
+
+    Check(stepped == 0, "small offsets are slewed, not stepped");
+    Check(fabs(kernel.Frequency() + 0.000050) < 0.000002, "the frequency error is corrected within 2 ppm");
+    Check(fabs(kernel.Error()) < 0.002, "the clock stays within 2 ms");
+    Check(kernel.Poll() == 1024, "the poll interval grows to the maximum while the offsets are stable");
+}
+
+void Jitter()
+{
+    Kernel kernel(-0.000020);
+
+    kernel.Configure(64, 1024);
+    kernel.Step(0.5);
+
+    Synchronize(kernel, 30, 0.020, 0.0005);
+    Check(kernel.Poll() == 1024, "the poll interval grows while the offsets are stable");
+
+    // The path gets worse than the jitter reported, the offsets no longer fit in it.
+    Synchronize(kernel, 6, 0.020, 0.040, 0.0001);
+    Check(kernel.Poll() == 64, "the poll interval shrinks back to the minimum on jitter");
+    Check(fabs(kernel.Error()) < 0.128, "the clock is not stepped on jitter");
+}
+
+void Step()
+{
+    Kernel kernel(0.000010);
+
+    kernel.Configure(64, 1024);
+    kernel.Step(1.0);
+
+    Synchronize(kernel, 20, 0.010, 0.001);
+    Check(kernel.Poll() > 64, "the poll interval grew");
+
+    // Someone else set the clock.
+    kernel.Step(0.3);
+
+    Check(Synchronize(kernel, 1, 0.010, 0.001) == 1, "an offset beyond 128 ms is stepped");
+    Check(kernel.Poll() == 64, "after a step the poll interval starts at the minimum again");
+    Check(fabs(kernel.Error()) < 0.01, "the step brings the clock back");
+}
+
+void NotPermitted()
+{
+    // Stepping does not correct the frequency error, keep it small enough for the offsets to stay stable.
+    Kernel kernel(0.000001);
+
+    kernel.Configure(64, 1024);
+    kernel.Permitted(false);
+    kernel.Step(1.0);
+
+    const uint32_t stepped = Synchronize(kernel, 20, 0.010, 0.001);
+
+    Check(stepped == 20, "without permission to adjust the clock, every offset is stepped");
+    Check(kernel.Poll() > 64, "the poll interval still adapts when stepping");
+}
+
+void Bounds()
+{
+    Kernel kernel(0.0);
+
+    kernel.Configure(1, 10);
+    Check(kernel.Poll() == 16, "the minimum poll interval is at least 16 s");
+
+    kernel.Configure(128, 64);
+    Check(kernel.Poll() == 128, "the maximum poll interval is at least the minimum");
+}
+
+}
+
+int main(int, char*[])
+{
+    srand(1);
+
+    Stable();
+    Jitter();
+    Step();
+    NotPermitted();
+    Bounds();
+
+    printf("%u check(s) failed\n", _failures);
+
+    return (_failures == 0 ? 0 : 1);
+}
@@ -0,0 +1,160 @@
+// Stand-in NTP server (RFC 5905, server mode only) answering with a configurable offset, delay
+// and jitter, so the TimeSync plugin can be run against a server that behaves in a known way:
+//
+//     NTPResponder [-p <port>] [-o <offset ms>] [-d <delay ms>] [-a <asymmetry ms>] [-j <jitter ms>] [-s <stratum>]
+//
+// The delay is injected on both legs of the exchange, the asymmetry is added to the leg towards
+// the server only, which is the error a client can not see. Every leg gets a random extra delay
+// of up to the jitter. Point the plugin at it with a source like "ntp://127.0.0.1:12300".
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <map>
+
+static constexpr uint32_t PacketSize = 48;
+static constexpr uint64_t NTPToUNIXSeconds = 2208988800ULL;
+
+struct Reply {
+    sockaddr_in Client;
+    uint8_t Packet[PacketSize];
+    uint64_t Received; // Server time (us) the request arrived
+};
+
+static uint64_t Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return ((static_cast<uint64_t>(now.tv_sec) * 1000000) + (now.tv_nsec / 1000));
+}
+
+static uint32_t Random(const uint32_t range)
+{
+    return (range == 0 ? 0 : static_cast<uint32_t>(rand() % (range + 1)));
+}
+
+static void Store(uint8_t buffer[], const uint32_t value)
+{
+    buffer[0] = static_cast<uint8_t>(value >> 24);
+    buffer[1] = static_cast<uint8_t>(value >> 16);
+    buffer[2] = static_cast<uint8_t>(value >> 8);
+    buffer[3] = static_cast<uint8_t>(value);
+}
+
+static void Store(uint8_t buffer[], const uint64_t time)
+{
+    const uint64_t seconds = (time / 1000000) + NTPToUNIXSeconds;
+    const uint64_t fraction = ((time % 1000000) << 32) / 1000000;
+
+    Store(buffer, static_cast<uint32_t>(seconds));
+    Store(&(buffer[4]), static_cast<uint32_t>(fraction));
+}
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = 12300;
+    int64_t offset = 0;
+    uint32_t delay = 0;
+    uint32_t asymmetry = 0;
+    uint32_t jitter = 0;
+    uint8_t stratum = 2;
+    int option;
+
+    while ((option = getopt(argc, argv, "p:o:d:a:j:s:")) != -1) {
+        switch (option) {
+        case 'p': port = static_cast<uint16_t>(atoi(optarg)); break;
+        case 'o': offset = atoll(optarg) * 1000; break;
+        case 'd': delay = static_cast<uint32_t>(atoi(optarg)) * 1000; break;
+        case 'a': asymmetry = static_cast<uint32_t>(atoi(optarg)) * 1000; break;
+        case 'j': jitter = static_cast<uint32_t>(atoi(optarg)) * 1000; break;
+        case 's': stratum = static_cast<uint8_t>(atoi(optarg)); break;
+        default:
+            fprintf(stderr, "Usage: %s [-p <port>] [-o <offset ms>] [-d <delay ms>] [-a <asymmetry ms>] [-j <jitter ms>] [-s <stratum>]\n", argv[0]);
+            return (1);
+        }
+    }
+
+    int descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if ((descriptor < 0) || (bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)) {
+        fprintf(stderr, "Could not bind to port %u\n", port);
+        return (1);
+    }
+
+    printf("Answering on port %u, offset %lld ms, delay %u ms (+%u ms towards the server), jitter %u ms\n",
+        port, static_cast<long long>(offset / 1000), delay / 1000, asymmetry / 1000, jitter / 1000);
+
+    srand(static_cast<unsigned int>(Now()));
+
+    // Replies waiting for their injected delay, in the order they are due.
+    std::multimap<uint64_t, Reply> pending;
+
+    while (true) {
+        int timeout = -1;
+
+        if (pending.empty() == false) {
+            const uint64_t now = Now();
+            timeout = static_cast<int>(pending.begin()->first > now ? ((pending.begin()->first - now) + 999) / 1000 : 0);
+        }
+
+        struct pollfd entry = { descriptor, POLLIN, 0 };
+
+        if ((poll(&entry, 1, timeout) > 0) && ((entry.revents & POLLIN) != 0)) {
+            Reply reply;
+            socklen_t length = sizeof(reply.Client);
+            ssize_t size = recvfrom(descriptor, reply.Packet, sizeof(reply.Packet), 0, reinterpret_cast<sockaddr*>(&reply.Client), &length);
+
+            // Only client mode requests (mode 3) are answered.
+            if ((size == PacketSize) && ((reply.Packet[0] & 0x07) == 3)) {
+                const uint64_t outbound = delay + asymmetry + Random(jitter);
+                const uint64_t inbound = delay + Random(jitter);
+
+                // The request "arrives" after the outbound delay, the reply leaves right away and is
+                // held back for the inbound delay.
+                reply.Received = Now() + outbound;
+                pending.insert(std::pair<uint64_t, Reply>(reply.Received + inbound, reply));
+            }
+        }
+
+        const uint64_t now = Now();
+
+        while ((pending.empty() == false) && (pending.begin()->first <= now)) {
+            Reply& reply(pending.begin()->second);
+            uint8_t answer[PacketSize];
+            const uint64_t received = static_cast<uint64_t>(static_cast<int64_t>(reply.Received) + offset);
+
+            memset(answer, 0, sizeof(answer));
+            answer[0] = static_cast<uint8_t>((reply.Packet[0] & 0x38) | 4); // LI 0, version of the request, server mode
+            answer[1] = stratum;
+            answer[2] = reply.Packet[2]; // poll
+            answer[3] = static_cast<uint8_t>(-20); // precision, about a microsecond
+            Store(&(answer[4]), static_cast<uint32_t>(0x00000100)); // root delay
+            Store(&(answer[8]), static_cast<uint32_t>(0x00000100)); // root dispersion
+            memcpy(&(answer[12]), "LOCL", 4);
+            Store(&(answer[16]), received - 1000000); // reference
+            memcpy(&(answer[24]), &(reply.Packet[40]), 8); // originate, the transmit timestamp of the request
+            Store(&(answer[32]), received); // receive
+            Store(&(answer[40]), received); // transmit
+
+            sendto(descriptor, answer, sizeof(answer), 0, reinterpret_cast<const sockaddr*>(&reply.Client), sizeof(reply.Client));
+
+            pending.erase(pending.begin());
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+// Layout of the binary trace files written by the BinaryOutput of the TraceControl plugin.
+// This header is shared with the offline decoder and should not depend on the framework.
+//
+// A file starts with a header: Magic (8 bytes) followed by the Version (2 bytes). After that
+// records follow, each starting with a one byte type. All values are stored little endian.
+//
+//   STRING: type (1) - id (2) - length (2) - characters (length)
+//   ENTRY:  type (1) - timestamp - file id - line - module id - category id - class id - length
+//           - payload (length)
+//
+// To keep entries small, all fields of an entry header are variable length integers: 7 bits per
+// byte, least significant bits first, with the top bit set on every byte but the last. The
+// timestamp (microseconds since the epoch) is stored as the difference with the timestamp of the
+// previous entry in the file, zigzag encoded as traces are not strictly ordered. The first entry
+// in a file holds the difference with 0. A typical entry header takes about 10 bytes this way.
+//
+// File, module, category and class names are interned: the first time a name is used in a
+// file a STRING record assigns an id to it, later entries only refer to that id. Every file
+// holds its own string table, so each file can be decoded on its own. A record type of 0
+// marks the end of the data in the file.
+
+#include <stdint.h>
+
+namespace WPEFramework {
+namespace Plugin {
+namespace BinaryTrace {
+
+    static const char Magic[8] = { 'W', 'P', 'E', 'T', 'R', 'A', 'C', 'E' };
+    static const uint16_t Version = 2;
+    static const uint32_t HeaderSize = sizeof(Magic) + sizeof(uint16_t);
+
+    enum record : uint8_t {
+        END = 0,
+        STRING = 1,
+        ENTRY = 2
+    };
+
+    static const uint32_t StringHeaderSize = 1 + 2 + 2;
+    // The largest an entry header can get.
+    static const uint32_t EntryHeaderSize = 1 + 10 + 3 + 5 + 3 + 3 + 3 + 3;
+
+    inline uint8_t* Store(uint8_t* buffer, const uint8_t value)
+    {
+        buffer[0] = value;
+        return (buffer + 1);
+    }
+    inline uint8_t* Store(uint8_t* buffer, const uint16_t value)
+    {
+        buffer[0] = static_cast<uint8_t>(value & 0xFF);
+        buffer[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        return (buffer + 2);
+    }
+    inline uint8_t* Store(uint8_t* buffer, const uint32_t value)
+    {
+        Store(buffer, static_cast<uint16_t>(value & 0xFFFF));
+        Store(buffer + 2, static_cast<uint16_t>((value >> 16) & 0xFFFF));
+        return (buffer + 4);
+    }
+    inline uint8_t* Store(uint8_t* buffer, const uint64_t value)
+    {
+        Store(buffer, static_cast<uint32_t>(value & 0xFFFFFFFF));
+        Store(buffer + 4, static_cast<uint32_t>((value >> 32) & 0xFFFFFFFF));
+        return (buffer + 8);
+    }
+
+    inline const uint8_t* Load(const uint8_t* buffer, uint8_t& value)
+    {
+        value = buffer[0];
+        return (buffer + 1);
+    }
+    inline const uint8_t* Load(const uint8_t* buffer, uint16_t& value)
+    {
+        value = static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+        return (buffer + 2);
+    }
+    inline const uint8_t* Load(const uint8_t* buffer, uint32_t& value)
+    {
+        uint16_t low, high;
+        Load(buffer, low);
+        Load(buffer + 2, high);
+        value = (static_cast<uint32_t>(high) << 16) | low;
+        return (buffer + 4);
+    }
+    inline const uint8_t* Load(const uint8_t* buffer, uint64_t& value)
+    {
+        uint32_t low, high;
+        Load(buffer, low);
+        Load(buffer + 4, high);
+        value = (static_cast<uint64_t>(high) << 32) | low;
+        return (buffer + 8);
+    }
+
+    inline uint8_t* StoreVariable(uint8_t* buffer, uint64_t value)
+    {
+        while (value >= 0x80) {
+            *buffer++ = static_cast<uint8_t>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        *buffer++ = static_cast<uint8_t>(value);
+        return (buffer);
+    }
+    // Returns nullptr if the value runs past the end of the buffer.
+    inline const uint8_t* LoadVariable(const uint8_t* buffer, const uint8_t* end, uint64_t& value)
+    {
+        uint8_t shift = 0;
+
+        value = 0;
+
+        while ((buffer < end) && (shift < 64)) {
+            const uint8_t part = *buffer++;
+
+            value |= (static_cast<uint64_t>(part & 0x7F) << shift);
+
+            if ((part & 0x80) == 0) {
+                return (buffer);
+            }
+            shift += 7;
+        }
+
+        return (nullptr);
+    }
+    inline uint64_t ZigZag(const int64_t value)
+    {
+        return ((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    inline int64_t UnZigZag(const uint64_t value)
+    {
+        return (static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+    }
+}
+}
+}
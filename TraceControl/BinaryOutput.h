@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Module.h"
+#include "BinaryFormat.h"
+#include "TraceControl.h"
+
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Writes the traces, without any formatting, as binary records into a memory mapped file.
+    // Once the file is full, it is rotated: <name> becomes <name>.1, <name>.1 becomes <name>.2,
+    // etc. up to the configured number of files. See BinaryFormat.h for the layout and the
+    // TraceDecoder tool to turn the files into readable text again.
+    class BinaryOutput : public Trace::ITraceMedia {
+    private:
+        BinaryOutput() = delete;
+        BinaryOutput(const BinaryOutput&) = delete;
+        BinaryOutput& operator=(const BinaryOutput&) = delete;
+
+        static constexpr uint16_t NoString = 0xFFFF;
+
+    public:
+        BinaryOutput(const string& fileName, const uint32_t size, const uint8_t files)
+            : _fileName(fileName)
+            , _size(std::max(size, static_cast<uint32_t>(BinaryTrace::HeaderSize + BinaryTrace::EntryHeaderSize + (4 * BinaryTrace::StringHeaderSize) + 1024)))
+            , _files(files)
+            , _descriptor(-1)
+            , _base(nullptr)
+            , _offset(0)
+            , _previous(0)
+            , _strings()
+        {
+            Open();
+        }
+        virtual ~BinaryOutput()
+        {
+            Close();
+        }
+
+    public:
+        virtual void Output(const char fileName[], const uint32_t lineNumber, const char className[], const Trace::ITrace* information)
+        {
+            // Traces handed out by this plugin carry the moment they were made, record that one.
+            const TraceControl::InformationWrapper* wrapper = dynamic_cast<const TraceControl::InformationWrapper*>(information);
+
+            Write(fileName, lineNumber, className, information, (wrapper != nullptr ? wrapper->Timestamp() : Core::Time::Now().Ticks()));
+        }
+
+    private:
+        void Write(const char fileName[], const uint32_t lineNumber, const char className[], const Trace::ITrace* information, const uint64_t timestamp)
+        {
+            if (_base != nullptr) {
+                const char* file = Core::FileNameOnly(fileName);
+                const char* module = information->Module();
+                const char* category = information->Category();
+                uint16_t length = information->Length();
+
+                // Make sure the entry, including the names it needs to define, fits in the file.
+                uint32_t names = Required(file) + Required(module) + Required(category) + Required(className);
+
+                if ((_offset + names + BinaryTrace::EntryHeaderSize + length) > _size) {
+                    Rotate();
+
+                    // A new file has no names defined yet.
+                    names = Required(file) + Required(module) + Required(category) + Required(className);
+                }
+
+                // If the names alone do not fit in an empty file, the file is configured too small
+                // for this entry, it is dropped.
+                if ((_base != nullptr) && ((_offset + names + BinaryTrace::EntryHeaderSize) <= _size)) {
+                    uint16_t fileId = Intern(file);
+                    uint16_t moduleId = Intern(module);
+                    uint16_t categoryId = Intern(category);
+                    uint16_t classId = Intern(className);
+
+                    // Only huge payloads can still not fit, those are truncated.
+                    if ((_offset + BinaryTrace::EntryHeaderSize + length) > _size) {
+                        length = static_cast<uint16_t>(_size - _offset - BinaryTrace::EntryHeaderSize);
+                    }
+
+                    uint8_t* location = &(_base[_offset]);
+
+                    location = BinaryTrace::Store(location, static_cast<uint8_t>(BinaryTrace::ENTRY));
+                    location = BinaryTrace::StoreVariable(location, BinaryTrace::ZigZag(static_cast<int64_t>(timestamp - _previous)));
+                    location = BinaryTrace::StoreVariable(location, fileId);
+                    location = BinaryTrace::StoreVariable(location, lineNumber);
+                    location = BinaryTrace::StoreVariable(location, moduleId);
+                    location = BinaryTrace::StoreVariable(location, categoryId);
+                    location = BinaryTrace::StoreVariable(location, classId);
+                    location = BinaryTrace::StoreVariable(location, length);
+                    ::memcpy(location, information->Data(), length);
+
+                    _offset = static_cast<uint32_t>((location - _base) + length);
+                    _previous = timestamp;
+                }
+            }
+        }
+        // The room a STRING record for the name takes, if it still needs to be defined in this file.
+        uint32_t Required(const char name[]) const
+        {
+            uint32_t result = 0;
+
+            if (_strings.find(string(name)) == _strings.end()) {
+                result = BinaryTrace::StringHeaderSize + static_cast<uint32_t>(std::min(strlen(name), static_cast<size_t>(0xFFFF)));
+            }
+
+            return (result);
+        }
+        uint16_t Intern(const char name[])
+        {
+            uint16_t result = NoString;
+            string key(name);
+            std::unordered_map<string, uint16_t>::const_iterator index(_strings.find(key));
+
+            if (index != _strings.end()) {
+                result = index->second;
+            } else {
+                uint16_t length = static_cast<uint16_t>(std::min(key.length(), static_cast<size_t>(0xFFFF)));
+
+                // Never write past the mapped region, the caller made room but stay on the safe side.
+                if (((_offset + BinaryTrace::StringHeaderSize + length) <= _size) && (_strings.size() < NoString)) {
+                    result = static_cast<uint16_t>(_strings.size());
+                    _strings.insert(std::pair<string, uint16_t>(key, result));
+
+                    uint8_t* location = &(_base[_offset]);
+
+                    location = BinaryTrace::Store(location, static_cast<uint8_t>(BinaryTrace::STRING));
+                    location = BinaryTrace::Store(location, result);
+                    location = BinaryTrace::Store(location, length);
+                    ::memcpy(location, key.c_str(), length);
+
+                    _offset += BinaryTrace::StringHeaderSize + length;
+                }
+            }
+
+            return (result);
+        }
+
+#ifdef __WIN32__
+        void Open()
+        {
+        }
+        void Close()
+        {
+        }
+        void Rotate()
+        {
+        }
+#else
+        void Open()
+        {
+            ASSERT(_base == nullptr);
+
+            _descriptor = ::open(_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+            if (_descriptor < 0) {
+                TRACE_L1("Could not open binary trace file %s, error %d", _fileName.c_str(), errno);
+            } else if (::ftruncate(_descriptor, _size) != 0) {
+                TRACE_L1("Could not size binary trace file %s, error %d", _fileName.c_str(), errno);
+                ::close(_descriptor);
+                _descriptor = -1;
+            } else {
+                void* base = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _descriptor, 0);
+
+                if (base == MAP_FAILED) {
+                    TRACE_L1("Could not map binary trace file %s, error %d", _fileName.c_str(), errno);
+                    ::close(_descriptor);
+                    _descriptor = -1;
+                } else {
+                    _base = static_cast<uint8_t*>(base);
+
+                    ::memcpy(_base, BinaryTrace::Magic, sizeof(BinaryTrace::Magic));
+                    BinaryTrace::Store(&(_base[sizeof(BinaryTrace::Magic)]), BinaryTrace::Version);
+                    _offset = BinaryTrace::HeaderSize;
+                }
+            }
+
+            _strings.clear();
+            _previous = 0;
+        }
+        void Close()
+        {
+            if (_base != nullptr) {
+                ::munmap(_base, _size);
+                _base = nullptr;
+
+                // Strip the unused part of the file.
+                if (::ftruncate(_descriptor, _offset) != 0) {
+                    TRACE_L1("Could not truncate binary trace file %s, error %d", _fileName.c_str(), errno);
+                }
+            }
+            if (_descriptor >= 0) {
+                ::close(_descriptor);
+                _descriptor = -1;
+            }
+        }
+        void Rotate()
+        {
+            Close();
+
+            if (_files > 1) {
+                for (uint8_t index = (_files - 1); index > 1; index--) {
+                    ::rename((_fileName + '.' + Core::NumberType<uint8_t>(index - 1).Text()).c_str(), (_fileName + '.' + Core::NumberType<uint8_t>(index).Text()).c_str());
+                }
+                ::rename(_fileName.c_str(), (_fileName + _T(".1")).c_str());
+            }
+
+            Open();
+        }
+#endif
+
+    private:
+        const string _fileName;
+        const uint32_t _size;
+        const uint8_t _files;
+        int _descriptor;
+        uint8_t* _base;
+        uint32_t _offset;
+        uint64_t _previous;
+        std::unordered_map<string, uint16_t> _strings;
+    };
+}
+}
@@ -1,4 +1,5 @@
 #include "TraceControl.h"
+#include "BinaryOutput.h"
 #include "TraceOutput.h"
 
 namespace WPEFramework {
@@ -63,6 +64,15 @@ namespace Plugin {
 
             _outputs.push_back(new Trace::TraceMedia(logNode));
         }
+        if (_config.Binary.IsSet() == true) {
+            string fileName(_config.Binary.Path.Value());
+
+            if ((fileName.empty() == false) && (fileName[0] != '/')) {
+                fileName = service->VolatilePath() + fileName;
+            }
+
+            _outputs.push_back(new Plugin::BinaryOutput(fileName, _config.Binary.Size.Value() * 1024, _config.Binary.Files.Value()));
+        }
 
         _service->Register(&_observer);
 
@@ -109,6 +109,8 @@ namespace Plugin {
                     , _classname(0)
                     , _information()
                     , _state(EMPTY)
+                    , _queued(false)
+                    , _retired(false)
                 {
                     if (_connection != nullptr) {
                         TRACE_L1("Constructing TraceControl::Source (%d)", connection->Id());
@@ -286,6 +288,24 @@ namespace Plugin {
                 {
                     _state = EMPTY;
                 }
+                // A queued source is referenced by the drain of the Observer, it may only be
+                // deleted by the drain. A retired source is no longer part of the observed buffers.
+                inline bool IsQueued() const
+                {
+                    return (_queued);
+                }
+                inline void Queued(const bool queued)
+                {
+                    _queued = queued;
+                }
+                inline bool IsRetired() const
+                {
+                    return (_retired);
+                }
+                inline void Retire()
+                {
+                    _retired = true;
+                }
 
             private:
                 virtual uint32_t GetReadSize(Core::CyclicBuffer::Cursor& cursor) override
@@ -305,6 +325,8 @@ namespace Plugin {
                 uint16_t _information;
                 uint16_t _length;
                 state _state;
+                bool _queued;
+                bool _retired;
                 uint8_t _traceBuffer[Trace::CyclicBufferSize];
                 static LocalIterator _localIterator;
             };
@@ -531,7 +553,9 @@ namespace Plugin {
         public:
             Observer(TraceControl& parent)
                 : Thread(Core::Thread::DefaultStackSize(), _T("TraceWorker"))
+                , _adminLock()
                 , _buffers()
+                , _latency()
                 , _traceControl(Trace::TraceUnit::Instance())
                 , _parent(parent)
                 , _refcount(0)
@@ -591,7 +615,12 @@ namespace Plugin {
                 std::map<const uint32_t, Source*>::iterator index(_buffers.find(connection->Id()));
 
                 if (index != _buffers.end()) {
-                    delete (index->second);
+                    if (index->second->IsQueued() == true) {
+                        // The drain is using it, it will be deleted as soon as the drain is done with it.
+                        index->second->Retire();
+                    } else {
+                        delete (index->second);
+                    }
                     _buffers.erase(index);
                 }
 
@@ -631,6 +660,14 @@ namespace Plugin {
                 return (ModuleIterator(_buffers));
             }
 
+            // Delay (us) between the creation of a trace and the moment it was handed to the outputs.
+            void Latency(Core::MeasurementType<uint64_t>& latency) const
+            {
+                _adminLock.Lock();
+                latency = _latency;
+                _adminLock.Unlock();
+            }
+
         private:
             BEGIN_INTERFACE_MAP(Observer)
             INTERFACE_ENTRY(RPC::IRemoteConnection::INotification)
@@ -648,73 +685,113 @@ namespace Plugin {
             }
             virtual uint32_t Worker()
             {
-                
                 while ((IsRunning() == true) && (_traceControl.Wait(Core::infinite) == Core::ERROR_NONE)) {
                     // Before we start we reset the flag, if new info is coming in, we will get a retrigger flag.
                     _traceControl.Acknowledge();
 
-                    Source* selected;
+                    Drain();
+                }
 
-                    uint64_t timeStamp;
+                return (Core::infinite);
+            }
 
-                    do {
-                        selected = nullptr;
+            // Min-heap ordering on the timestamp of the loaded trace entry.
+            static bool Later(const Source* lhs, const Source* rhs)
+            {
+                return (lhs->Timestamp() > rhs->Timestamp());
+            }
 
-                        _adminLock.Lock();
+            // Must be called with the _adminLock taken, returns true if the source has an entry to dispatch.
+            bool Enqueue(Source* source, std::vector<Source*>& queue)
+            {
+                Source::state state(source->Load());
+
+                if (state == Source::LOADED) {
+                    source->Queued(true);
+                    queue.push_back(source);
+                    std::push_heap(queue.begin(), queue.end(), Later);
+                } else if (state == Source::FAILURE) {
+                    // Oops this requires recovery, so let's flush
+                    source->Flush();
+                }
 
-                        timeStamp = static_cast<uint64_t>(~0);
+                return (state == Source::LOADED);
+            }
 
-                        std::map<const uint32_t, Source*>::iterator index(_buffers.begin());
+            // K-way merge of all sources on the timestamp of their entries. Only the source that
+            // delivered the last dispatched entry is reloaded, and the lock is not held while the
+            // entry is handed to the outputs, so Set()/Relinquish() and (de)activation of remote
+            // connections are not stalled by slow outputs.
+            void Drain()
+            {
+                std::vector<Source*> queue;
 
-                        while (index != _buffers.end()) {
+                _adminLock.Lock();
 
-                            Source::state state(index->second->Load());
+                queue.reserve(_buffers.size());
 
-                            if (state == Source::LOADED) {
-                                if (index->second->Timestamp() < timeStamp) {
-                                    timeStamp = index->second->Timestamp();
+                std::map<const uint32_t, Source*>::iterator index(_buffers.begin());
 
-                                    if (state == Source::LOADED) {
-                                        selected = index->second;
-                                    }
-                                }
-                            } else if (state == Source::FAILURE) {
-                                // Oops this requires recovery, so let's flush
-                                index->second->Flush();
-                            }
+                while (index != _buffers.end()) {
+                    Enqueue(index->second, queue);
+                    index++;
+                }
 
-                            index++;
-                        }
+                while ((IsRunning() == true) && (queue.empty() == false)) {
+                    std::pop_heap(queue.begin(), queue.end(), Later);
+                    Source* selected = queue.back();
+                    queue.pop_back();
 
-                        if (selected != nullptr) {
+                    if (selected->IsRetired() == false) {
+                        _adminLock.Unlock();
 
-                            // Oke, output this entry
-                            _parent.Dispatch(*selected);
+                        // Oke, output this entry
+                        _parent.Dispatch(*selected);
 
-                            // Ready to load a new one..
-                            selected->Clear();
-                        } else if (timeStamp != static_cast<uint64_t>(~0)) {
-                            // Looks like we are waiting for a message to be completed.
-                            // Give up our slice, so the producer, can produce.
-                            ::SleepMs(0);
-                        }
+                        uint64_t now(Core::Time::Now().Ticks());
+                        uint64_t stamp(selected->Timestamp());
 
-                        _adminLock.Unlock();
+                        _adminLock.Lock();
 
-                    } while ((IsRunning() == true) && (timeStamp != static_cast<uint64_t>(~0)));
+                        _latency.Set(now > stamp ? now - stamp : 0);
+                    }
+
+                    selected->Queued(false);
+
+                    if (selected->IsRetired() == true) {
+                        delete selected;
+                    } else {
+                        // Ready to load a new one..
+                        selected->Clear();
+                        Enqueue(selected, queue);
+                    }
                 }
 
-                return (Core::infinite);
+                // If we are stopped halfway, release whatever is still in the queue.
+                while (queue.empty() == false) {
+                    Source* pending = queue.back();
+                    queue.pop_back();
+
+                    pending->Queued(false);
+
+                    if (pending->IsRetired() == true) {
+                        delete pending;
+                    }
+                }
+
+                _adminLock.Unlock();
             }
 
         private:
-            Core::CriticalSection _adminLock;
+            mutable Core::CriticalSection _adminLock;
             std::map<const uint32_t, Source*> _buffers;
+            Core::MeasurementType<uint64_t> _latency;
             Trace::TraceUnit& _traceControl;
             TraceControl& _parent;
             mutable uint32_t _refcount;
         };
 
+    public:
         class InformationWrapper : public Trace::ITrace {
         private:
             InformationWrapper() = delete;
@@ -747,6 +824,10 @@ namespace Plugin {
             {
                 return (_info.Length());
             }
+            inline uint64_t Timestamp() const
+            {
+                return (_info.Timestamp());
+            }
 
         private:
             const TraceControl::Observer::Source& _info;
@@ -787,6 +868,31 @@ namespace Plugin {
             Core::JSON::DecUInt16 Port;
             Core::JSON::String Binding;
         };
+        class BinaryNode : public Core::JSON::Container {
+        private:
+            BinaryNode(const BinaryNode&) = delete;
+            BinaryNode& operator=(const BinaryNode&) = delete;
+
+        public:
+            BinaryNode()
+                : Core::JSON::Container()
+                , Path(_T("trace.bin"))
+                , Size(1024)
+                , Files(4)
+            {
+                Add(_T("path"), &Path);
+                Add(_T("size"), &Size);
+                Add(_T("files"), &Files);
+            }
+            ~BinaryNode()
+            {
+            }
+
+        public:
+            Core::JSON::String Path; // Relative paths are relative to the volatile path of the plugin
+            Core::JSON::DecUInt32 Size; // Size of a single file in KB
+            Core::JSON::DecUInt8 Files; // Number of files kept when rotating
+        };
         class Config : public Core::JSON::Container {
         private:
             Config(const Config&);
@@ -798,10 +904,12 @@ namespace Plugin {
                 , Console(false)
                 , SysLog(true)
                 , Remote()
+                , Binary()
             {
                 Add(_T("console"), &Console);
                 Add(_T("syslog"), &SysLog);
                 Add(_T("remote"), &Remote);
+                Add(_T("binary"), &Binary);
             }
             ~Config()
             {
@@ -811,6 +919,7 @@ namespace Plugin {
             Core::JSON::Boolean Console;
             Core::JSON::Boolean SysLog;
             NetworkNode Remote;
+            BinaryNode Binary;
         };
         class Data : public Core::JSON::Container {
         public:
@@ -898,6 +1007,32 @@ namespace Plugin {
             Core::JSON::ArrayType<Trace> Settings;
         };
 
+        class LatencyData : public Core::JSON::Container {
+        private:
+            LatencyData& operator=(const LatencyData&) = delete;
+
+        public:
+            LatencyData()
+                : Core::JSON::Container()
+            {
+                Add(_T("min"), &Min);
+                Add(_T("max"), &Max);
+                Add(_T("average"), &Average);
+                Add(_T("last"), &Last);
+                Add(_T("count"), &Count);
+            }
+            ~LatencyData()
+            {
+            }
+
+        public:
+            Core::JSON::DecUInt64 Min;
+            Core::JSON::DecUInt64 Max;
+            Core::JSON::DecUInt64 Average;
+            Core::JSON::DecUInt64 Last;
+            Core::JSON::DecUInt32 Count;
+        };
+
     public:
 #ifdef __WIN32__
 #pragma warning(disable : 4355)
@@ -967,6 +1102,7 @@ namespace Plugin {
         JsonData::TraceControl::StateType TranslateState(TraceControl::state state);
         uint32_t endpoint_status(const JsonData::TraceControl::StatusParamsData& params, JsonData::TraceControl::StatusResultData& response);
         uint32_t endpoint_set(const JsonData::TraceControl::TraceInfo& params);
+        uint32_t get_latency(LatencyData& response) const;
         inline const string& TracePath() const 
         {
             return (_tracePath);
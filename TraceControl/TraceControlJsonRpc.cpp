@@ -16,12 +16,14 @@ namespace Plugin {
     {
         Register<StatusParamsData,StatusResultData>(_T("status"), &TraceControl::endpoint_status, this);
         Register<TraceInfo,void>(_T("set"), &TraceControl::endpoint_set, this);
+        Property<LatencyData>(_T("latency"), &TraceControl::get_latency, nullptr, this);
     }
 
     void TraceControl::UnregisterAll()
     {
         Unregister(_T("set"));
         Unregister(_T("status"));
+        Unregister(_T("latency"));
     }
 
     JsonData::TraceControl::StateType TraceControl::TranslateState(TraceControl::state state)
@@ -98,6 +100,24 @@ namespace Plugin {
 
         return result;
     }
+
+    // Property: latency - Delay (in microseconds) between the creation of a trace and its output
+    // Return codes:
+    //  - ERROR_NONE: Success
+    uint32_t TraceControl::get_latency(LatencyData& response) const
+    {
+        Core::MeasurementType<uint64_t> latency;
+
+        _observer.Latency(latency);
+
+        response.Min = latency.Min();
+        response.Max = latency.Max();
+        response.Average = latency.Average();
+        response.Last = latency.Last();
+        response.Count = latency.Measurements();
+
+        return Core::ERROR_NONE;
+    }
 } // namespace Plugin
 
 }
@@ -0,0 +1,143 @@
+// Turns the binary trace files, written by the TraceControl plugin, back into readable text.
+//
+//     TraceDecoder <file> [<file> ...]
+//
+// Files are decoded in the order given, so to get the rotated files in chronological order
+// pass the oldest first, e.g.: TraceDecoder trace.bin.3 trace.bin.2 trace.bin.1 trace.bin
+
+#include "BinaryFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+using namespace WPEFramework::Plugin;
+
+static const std::string& Lookup(const std::vector<std::string>& strings, const uint16_t id)
+{
+    static const std::string unknown("<unknown>");
+    return (id < strings.size() ? strings[id] : unknown);
+}
+
+static bool Decode(const char fileName[])
+{
+    FILE* file = fopen(fileName, "rb");
+
+    if (file == nullptr) {
+        fprintf(stderr, "Could not open %s\n", fileName);
+        return (false);
+    }
+
+    std::vector<uint8_t> content;
+    uint8_t block[4096];
+    size_t size;
+
+    while ((size = fread(block, 1, sizeof(block), file)) > 0) {
+        content.insert(content.end(), block, block + size);
+    }
+    fclose(file);
+
+    if ((content.size() < BinaryTrace::HeaderSize) || (memcmp(content.data(), BinaryTrace::Magic, sizeof(BinaryTrace::Magic)) != 0)) {
+        fprintf(stderr, "%s is not a binary trace file\n", fileName);
+        return (false);
+    }
+
+    uint16_t version;
+    BinaryTrace::Load(&(content[sizeof(BinaryTrace::Magic)]), version);
+
+    if (version != BinaryTrace::Version) {
+        fprintf(stderr, "%s has an unsupported version: %u\n", fileName, version);
+        return (false);
+    }
+
+    std::vector<std::string> strings;
+    uint64_t timestamp = 0;
+    const uint8_t* end = content.data() + content.size();
+    const uint8_t* location = content.data() + BinaryTrace::HeaderSize;
+    bool result = true;
+
+    while ((location < end) && (*location != BinaryTrace::END)) {
+        uint8_t type;
+        const uint8_t* record = BinaryTrace::Load(location, type);
+
+        if ((type == BinaryTrace::STRING) && ((location + BinaryTrace::StringHeaderSize) <= end)) {
+            uint16_t id, length;
+
+            record = BinaryTrace::Load(record, id);
+            record = BinaryTrace::Load(record, length);
+
+            if ((record + length) > end) {
+                break;
+            }
+            if (id >= strings.size()) {
+                strings.resize(id + 1);
+            }
+            strings[id].assign(reinterpret_cast<const char*>(record), length);
+
+            location = record + length;
+        } else if (type == BinaryTrace::ENTRY) {
+            uint64_t fields[7];
+            uint8_t index = 0;
+
+            while ((index < 7) && (record != nullptr)) {
+                record = BinaryTrace::LoadVariable(record, end, fields[index]);
+                index++;
+            }
+
+            if ((record == nullptr) || ((record + fields[6]) > end)) {
+                break;
+            }
+
+            timestamp += BinaryTrace::UnZigZag(fields[0]);
+
+            const uint16_t fileId = static_cast<uint16_t>(fields[1]);
+            const uint32_t line = static_cast<uint32_t>(fields[2]);
+            const uint16_t moduleId = static_cast<uint16_t>(fields[3]);
+            const uint16_t categoryId = static_cast<uint16_t>(fields[4]);
+            const uint16_t length = static_cast<uint16_t>(fields[6]);
+
+            // The timestamp is in microseconds since the epoch.
+            time_t seconds = static_cast<time_t>(timestamp / 1000000);
+            struct tm moment;
+            char stamp[32];
+
+            gmtime_r(&seconds, &moment);
+            strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &moment);
+
+            printf("[%s.%06u]:[%s:%u] %s/%s: %.*s\n",
+                stamp, static_cast<uint32_t>(timestamp % 1000000),
+                Lookup(strings, fileId).c_str(), line,
+                Lookup(strings, moduleId).c_str(), Lookup(strings, categoryId).c_str(),
+                static_cast<int>(length), reinterpret_cast<const char*>(record));
+
+            location = record + length;
+        } else {
+            fprintf(stderr, "%s is corrupt at offset %u\n", fileName, static_cast<uint32_t>(location - content.data()));
+            result = false;
+            break;
+        }
+    }
+
+    return (result);
+}
+
+int main(int argc, const char* argv[])
+{
+    int result = 0;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file> [<file> ...]\n", argv[0]);
+        result = 1;
+    } else {
+        for (int index = 1; index < argc; index++) {
+            if (Decode(argv[index]) == false) {
+                result = 1;
+            }
+        }
+    }
+
+    return (result);
+}
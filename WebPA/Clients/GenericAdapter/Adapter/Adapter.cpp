@@ -163,6 +163,7 @@ void Adapter::ProcessRequest(char* reqPayload,char* transactionId, char** resPay
 {
     TRACE(Trace::Information, (string(__FUNCTION__)));
 
+    uint64_t start = Core::Time::Now().Ticks();
     req_struct* reqObj = nullptr;
     wdmp_parse_request(reqPayload, &reqObj);
 
@@ -217,6 +218,7 @@ void Adapter::ProcessRequest(char* reqPayload,char* transactionId, char** resPay
 
             wdmp_free_res_struct(resObj);
         }
+        TRACE(Trace::Information, (_T("Request:> Type : %d handled in %d us"), reqObj->reqType, static_cast<uint32_t>(Core::Time::Now().Ticks() - start)));
         wdmp_free_req_struct(reqObj);
     }
 
@@ -283,12 +285,12 @@ WebPAStatus Adapter::Helper::GetParameters(const req_struct*& reqObj, res_struct
 
     if ((status == WEBPA_SUCCESS) && (reqObj->u.getReq->paramCnt > 0)) {
         resObj->paramCnt = reqObj->u.getReq->paramCnt;
-        std::map<std::vector<Data>, WebPAStatus> parametersList;
+        Parameter::ValueList parametersList;
         _parameter->Values(parameterNames, parametersList);
         if (parametersList.size() > 0) {
 
             int i = 0;
-            for (std::map<std::vector<Data>, WebPAStatus>::iterator parameters = parametersList.begin(); parameters != parametersList.end(); parameters++, i++) {
+            for (Parameter::ValueList::iterator parameters = parametersList.begin(); parameters != parametersList.end(); parameters++, i++) {
                 resObj->u.getRes->paramNames[i] = strdup(parameterNames[i].c_str());
                 resObj->u.getRes->retParamCnt[i] = parameters->first.size();
                 resObj->retStatus[i] = static_cast<WDMP_STATUS>(parameters->second);
@@ -111,7 +111,7 @@ std::string Notifier::Source()
     if (notificationSource.empty() == true) {
 
         std::vector<std::string> paramaterName = { DeviceStbMACParam };
-        std::map<std::vector<Data>, WebPAStatus> paramaters;
+        Parameter::ValueList paramaters;
         notificationSource = UnknownParamValue;
 
         _parameter->Values(paramaterName, paramaters);
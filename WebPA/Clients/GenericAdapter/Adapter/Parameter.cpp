@@ -6,28 +6,95 @@ namespace WebPA {
 Parameter::Parameter(Handler* handler, WalDB* walDB)
     : _walDB(walDB)
     , _handler(handler)
-    , _adminLock()
 {
 }
 
 Parameter::~Parameter()
 {
 }
-const void Parameter::Values(const std::vector<std::string>& parameterNames, std::map<std::vector<Data>, WebPAStatus>& parametersList) const
+
+void Parameter::Batch::Add(const IProfileControl* profile, const uint32_t index)
+{
+    uint32_t group = 0;
+
+    while ((group < _groups.size()) && (_groups[group].first != profile)) {
+        group++;
+    }
+
+    if (group == _groups.size()) {
+        _groups.emplace_back(profile, std::vector<uint32_t>());
+    }
+
+    _groups[group].second.push_back(index);
+}
+
+void Parameter::Batch::Dispatch()
 {
-    for (auto& name: parameterNames) {
-        std::vector<Data> parameters;
+    _pending = Groups() - 1;
+
+    for (uint32_t group = 1; group < Groups(); group++) {
+        PluginHost::WorkerPool::Instance().Submit(Core::proxy_cast<Core::IDispatchType<void>>(Core::ProxyType<Job>::Create(this, group)));
+    }
+
+    Run(0);
+
+    if (Groups() > 1) {
+        // The jobs refer to this batch, so wait until all of them are done.
+        _completed.Lock(Core::infinite);
+    }
+}
+
+void Parameter::Batch::Run(const uint32_t group)
+{
+    ASSERT(group < _groups.size());
+
+    uint64_t start = Core::Time::Now().Ticks();
 
-        WebPAStatus ret = Values(name, parameters);
-        parametersList.insert(std::make_pair(parameters, ret));
-        if ((ret == WEBPA_SUCCESS) && (parameters.size() > 0)) {
-            TRACE(Trace::Information, (_T( "Parameter Name: %s return: %d"), name.c_str(), parameters.size()));
+    for (const uint32_t index : _groups[group].second) {
+        std::pair<std::vector<Data>, WebPAStatus>& entry(_parametersList[index]);
+
+        entry.second = _parent.Values(_parameterNames[index], entry.first);
+        if ((entry.second == WEBPA_SUCCESS) && (entry.first.size() > 0)) {
+            TRACE(Trace::Information, (_T( "Parameter Name: %s return: %d"), _parameterNames[index].c_str(), entry.first.size()));
         } else {
-            TRACE(Trace::Information, (_T( "Parameter Name: %s return no value, so keeping empty values to get the status")));
+            TRACE(Trace::Information, (_T( "Parameter Name: %s return no value, so keeping empty values to get the status"), _parameterNames[index].c_str()));
+        }
+    }
+
+    TRACE(Trace::Information, (_T("Group %d of %d: %d parameters in %d us"), group, Groups(), static_cast<uint32_t>(_groups[group].second.size()), static_cast<uint32_t>(Core::Time::Now().Ticks() - start)));
+
+    if (group > 0) {
+        _adminLock.Lock();
+
+        ASSERT(_pending > 0);
+
+        bool done = (--_pending == 0);
+
+        _adminLock.Unlock();
+
+        if (done == true) {
+            _completed.SetEvent();
         }
     }
 }
 
+void Parameter::Values(const std::vector<std::string>& parameterNames, ValueList& parametersList) const
+{
+    Batch batch(*this, parameterNames, parametersList);
+
+    parametersList.clear();
+    parametersList.resize(parameterNames.size(), std::make_pair(std::vector<Data>(), WEBPA_FAILURE));
+
+    // Group the names per profile controller, in one pass over the request.
+    for (uint32_t index = 0; index < parameterNames.size(); index++) {
+        batch.Add(_handler->Profile(parameterNames[index]), index);
+    }
+
+    if (batch.Groups() > 0) {
+        batch.Dispatch();
+    }
+}
+
 WebPAStatus Parameter::Values(const std::vector<Data>& parameters, std::vector<WebPAStatus>& status)
 {
     WebPAStatus ret = WEBPA_SUCCESS;
@@ -57,9 +124,7 @@ const WebPAStatus Parameter::Values(const std::string& parameterName, std::vecto
                     Variant value(Utils::ConvertToParamType(dbParamter.second));
                     Data param(dbParamter.first, value);
 
-                    _adminLock.Lock();
                     WebPAStatus ret = (WebPAStatus) Utils::ConvertFaultCodeToWPAStatus((static_cast<const Handler&>(*_handler)).Parameter(param));
-                    _adminLock.Unlock();
 
                     // Fill Only if we can able to get Proper value
                     if (WEBPA_SUCCESS == ret) {
@@ -84,9 +149,7 @@ const WebPAStatus Parameter::Values(const std::string& parameterName, std::vecto
 
                 // Convert param.paramType to ParamVal.type
                 TRACE(Trace::Information, (_T( " Values parameterType is %d"), dataType));
-                _adminLock.Lock();
                 status = (WebPAStatus) Utils::ConvertFaultCodeToWPAStatus((static_cast<const Handler&>(*_handler)).Parameter(param));
-                _adminLock.Unlock();
                 if (WEBPA_SUCCESS == status) {
                     parameters.push_back(param);
                 } else {
@@ -115,9 +178,7 @@ WebPAStatus Parameter::Values(const Data& parameter)
         if (_walDB->IsValidParameter(parameter.Name(), dataType)) {
             if (Utils::ConvertToParamType(dataType) == parameter.Value().Type()) {
 
-                _adminLock.Lock();
                 ret = Utils::ConvertFaultCodeToWPAStatus(_handler->Parameter(parameter));
-                _adminLock.Unlock();
                 TRACE(Trace::Information, (_T("handler::Parameter %d"), ret));
             } else {
                 ret = WEBPA_ERR_INVALID_PARAMETER_TYPE;
@@ -15,7 +15,81 @@ typedef enum
     WEBPA_ATOMIC_SET_XPC
 } WEBPA_SET_TYPE;
 
+// A get request is grouped per profile controller. The groups are handled in parallel, the first one
+// on the calling thread and the others on the worker pool, the names within a group are handled in
+// order. Each group fills in the values of its own names, so the results keep the order of the request.
 class Parameter {
+public:
+    typedef std::vector<std::pair<std::vector<Data>, WebPAStatus>> ValueList;
+
+private:
+    class Batch {
+    public:
+        Batch() = delete;
+        Batch(const Batch&) = delete;
+        Batch& operator= (const Batch&) = delete;
+
+    public:
+        Batch(const Parameter& parent, const std::vector<std::string>& parameterNames, ValueList& parametersList)
+            : _parent(parent)
+            , _parameterNames(parameterNames)
+            , _parametersList(parametersList)
+            , _groups()
+            , _pending(0)
+            , _completed(false, true)
+            , _adminLock()
+        {
+        }
+        ~Batch()
+        {
+        }
+
+    public:
+        inline uint32_t Groups() const
+        {
+            return (static_cast<uint32_t>(_groups.size()));
+        }
+        void Add(const IProfileControl* profile, const uint32_t index);
+        void Dispatch();
+        void Run(const uint32_t group);
+
+    private:
+        const Parameter& _parent;
+        const std::vector<std::string>& _parameterNames;
+        ValueList& _parametersList;
+        std::vector<std::pair<const IProfileControl*, std::vector<uint32_t>>> _groups;
+        uint32_t _pending;
+        Core::Event _completed;
+        Core::CriticalSection _adminLock;
+    };
+
+    class Job : public Core::IDispatchType<void> {
+    public:
+        Job() = delete;
+        Job(const Job&) = delete;
+        Job& operator= (const Job&) = delete;
+
+    public:
+        Job(Batch* batch, const uint32_t group)
+            : _batch(*batch)
+            , _group(group)
+        {
+            ASSERT(batch != nullptr);
+        }
+        virtual ~Job()
+        {
+        }
+
+    public:
+        virtual void Dispatch() override
+        {
+            _batch.Run(_group);
+        }
+
+    private:
+        Batch& _batch;
+        const uint32_t _group;
+    };
 
 public:
     Parameter() = delete;
@@ -26,7 +100,7 @@ public:
     Parameter(Handler* handler, WalDB* walDB);
     virtual ~Parameter();
 
-    const void Values(const std::vector<std::string>& parameterNames, std::map<std::vector<Data>, WebPAStatus>& parametersList) const;
+    void Values(const std::vector<std::string>& parameterNames, ValueList& parametersList) const;
     WebPAStatus Values(const std::vector<Data>& parameters, std::vector<WebPAStatus>& status);
 
 private:
@@ -36,8 +110,6 @@ private:
 private:
     WalDB* _walDB;
     Handler* _handler;
-
-    mutable Core::CriticalSection _adminLock;
 };
 
 } // WebPA
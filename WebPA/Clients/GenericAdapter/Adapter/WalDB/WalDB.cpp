@@ -1,408 +1,216 @@
-
 #include "WalDB.h"
 
+#include <tinyxml.h>
+
 namespace WPEFramework {
 
 WalDB::WalDB(Handler* handler)
     : _dbHandle(0)
     , _handler(handler)
+    , _root()
 {
 }
 
 WalDB::~WalDB()
 {
-    if (_dbHandle) {
-        TiXmlDocument* doc = reinterpret_cast<TiXmlDocument*>(_dbHandle);
-        delete (doc);
-    }
 }
 
 DBStatus WalDB::LoadDB(const std::string& filename)
 {
-    TiXmlDocument* doc = new TiXmlDocument(filename.c_str());
+    TiXmlDocument doc(filename.c_str());
     DBStatus status = DB_FAILURE;
 
-    if (nullptr != doc) {
-        bool loadOK = doc->LoadFile();
-        if (loadOK) {
-            _dbHandle = reinterpret_cast<int>(doc);
-            status = DB_SUCCESS;
-        } else {
-            _dbHandle = 0;
-        }
-    } else {
-        _dbHandle = 0;
-    }
-    return status;
-}
+    _root.Children.clear();
+    _root.Parameters.clear();
+    _dbHandle = 0;
 
-int16_t WalDB::ParameterInstanceCount(const std::string& paramName) const
-{
-    int16_t instanceCount = 0;
-
-    if (paramName.empty() != true) {
-        std::size_t found = paramName.find(InstanceNumberIndicator);
-        if (found != std::string::npos) {
-
-            // Get the number of instances from Adapter
-            std::string paramType;
-
-            if (IsValidParameter (paramName, paramType)) {
-                TRACE(Trace::Information, (_T( "Valid Parameter..! ")));
-                string name(paramName, 0, found - 1 );
-                Data param(name + "NumberOfEntries", static_cast<const int>(0));
-
-                FaultCode status = (static_cast<const Handler&>(*_handler)).Parameter(param);
-                if (status != FaultCode::NoFault) {
-                    TRACE(Trace::Error, (_T("[%s:%s:%d] Error in Get Message Handler : faultCode = %d"), __FILE__, __FUNCTION__, __LINE__, status));
-                } else {
-                    TRACE(Trace::Information, (_T("[%s:%s:%d] The value for param: %s is %d"), __FILE__, __FUNCTION__, __LINE__, param.Name().c_str(), param.Value().Integer()));
-                    instanceCount = param.Value().Integer();
-                }
+    if (doc.LoadFile() == true) {
+        const TiXmlElement* model = (doc.RootElement() != nullptr ? doc.RootElement()->FirstChildElement("model") : nullptr);
 
-            }
-        }
-    }
-    return instanceCount;
-}
+        if (model != nullptr) {
+            std::vector<std::string> segments;
 
+            for (const TiXmlElement* object = model->FirstChildElement("object"); object != nullptr; object = object->NextSiblingElement("object")) {
+                const char* base = object->Attribute("base");
 
-void WalDB::ReplaceWithInstanceNumber(string& paramName, uint16_t instanceNumber) const
-{
-    if (paramName.empty() != true) {
-        std::size_t position = paramName.find(InstanceNumberIndicator);
-        if (position != std::string::npos) {
-            std::string number = std::to_string(instanceNumber);
-            paramName.replace(position, strlen(InstanceNumberIndicator) - 1, number);
-        }
-    }
-}
+                if (base != nullptr) {
+                    Node* node = &_root;
 
-bool WalDB::CheckMatchingParameter(const char* attrValue, const char* paramName, uint32_t& ret) const
-{
-    bool status = false;
+                    Split(base, segments);
 
-    int i = 10;
-    int inst = 0;
+                    for (const std::string& segment : segments) {
+                        std::unique_ptr<Node>& child(node->Children[segment]);
 
-    while (true) {
-        if (!(*attrValue && *paramName && (*attrValue == *paramName))) {
+                        if (child == nullptr) {
+                            child.reset(new Node());
+                        }
+                        node = child.get();
+                    }
 
-            ret = 0;
-            if (*attrValue == '{' && *paramName >= 48 && *paramName <= 56) {
-                attrValue += 3;
-                while(*paramName &&* paramName != '.') {
-                    ret = ret*i + (*paramName - 48);
-                    paramName++;
-                    inst = ret;
-                }
-            } else {
+                    node->IsObject = true;
 
-                ret = 0;
-                if (!*paramName) {
-                    if (!*attrValue && (*(attrValue - 2) == '}')) {
-                        ret = inst;
+                    for (const TiXmlElement* parameter = object->FirstChildElement("parameter"); parameter != nullptr; parameter = parameter->NextSiblingElement("parameter")) {
+                        const char* name = parameter->Attribute("base");
+                        const TiXmlElement* syntax = parameter->FirstChildElement("syntax");
+                        const TiXmlElement* type = (syntax != nullptr ? syntax->FirstChildElement() : nullptr);
+
+                        if ((name != nullptr) && (type != nullptr)) {
+                            const char* getIdx = parameter->Attribute("getIdx");
+                            Parameter& entry(node->Parameters[name]);
+
+                            entry.DataType = type->Value();
+                            entry.Readable = ((getIdx != nullptr) && (strtol(getIdx, nullptr, 10) >= 1));
+                        }
                     }
-                    status = true;
+
+                    _dbHandle++;
                 }
-                break;
             }
         }
-        attrValue++;
-        paramName++;
+
+        if (_dbHandle != 0) {
+            status = DB_SUCCESS;
+        }
     }
+
+    TRACE(Trace::Information, (_T("Indexed %d objects of data model %s"), _dbHandle, filename.c_str()));
+
     return status;
 }
 
-TiXmlNode* WalDB::Parameters(TiXmlNode* parent, const std::string& paramName, std::string& currentParam, std::map<std::string, std::string>& paramList) const
+uint16_t WalDB::ParameterInstanceCount(const std::string& objectName) const
 {
-    // If parent is Null Return
-    if (!parent) {
-        return nullptr;
-    }
+    uint16_t instanceCount = 0;
 
-    int isReccursiveCall = 0;
-    // Identify whether the call is recursive or initial call
-    if (currentParam.empty() != true) {
-        isReccursiveCall = 1;
-    }
+    // The number of instances of "Device.Object.{i}." is held by "Device.ObjectNumberOfEntries".
+    Data param(objectName.substr(0, objectName.length() - 1) + "NumberOfEntries", static_cast<const int>(0));
 
-    TiXmlNode* child;
-    // Goto actual Object node ie "Device."
-    if (parent->Type() != TiXmlNode::TINYXML_ELEMENT) {
-        for (child = parent->FirstChild(); child != 0;) {
-            if (child->Type() != TiXmlNode::TINYXML_ELEMENT) {
-                child = child->NextSibling();
-            } else {
-                if (!strcmp (child->Value(), "object"))
-                    break;
-                child = child->FirstChild();
-            }
-        }
+    FaultCode status = (static_cast<const Handler&>(*_handler)).Parameter(param);
+    if (status != FaultCode::NoFault) {
+        TRACE(Trace::Error, (_T("[%s:%s:%d] Error in Get Message Handler : faultCode = %d"), __FILE__, __FUNCTION__, __LINE__, status));
     } else {
-        child = parent;
+        TRACE(Trace::Information, (_T("[%s:%s:%d] The value for param: %s is %d"), __FILE__, __FUNCTION__, __LINE__, param.Name().c_str(), param.Value().Integer()));
+        instanceCount = param.Value().Integer();
     }
 
-    std::string zeroInstance;
-    while (child) {
-        TiXmlElement* pElement =  child->ToElement();
-        TiXmlAttribute* pAttrib = pElement->FirstAttribute();
-        uint32_t inst = 0;
-        int status = 0;
-
-        // Check if node is an Object
-        if (!strcmp(child->Value(),"object")) {
-            if (strstr(pAttrib->Value(), paramName.c_str()) || (status = CheckMatchingParameter(pAttrib->Value(), paramName.c_str(), inst))) {
-                // If the number of instances are 0 then skip this object and go to next sibling
-                if ((zeroInstance.empty() != true) && strstr(pAttrib->Value(), zeroInstance.c_str())) {
-                    child = child->NextSibling();
-                    continue;
-                } else if (zeroInstance.empty() != true) {
-                    zeroInstance = "";
-                }
-                // If matching found update the current parameter with wild card input std::string
-                if (status && !isReccursiveCall) {
-                    currentParam = paramName;
-                }
-                currentParam = pAttrib->Value();
-                TiXmlNode* bChild, *sChild;
-                bChild = child;
-                // Goto the parameters
-                child = child->FirstChild();
-
-                // Object not having any parameter thus go to next Sibling
-                if (nullptr == child) {
-                    child = bChild->NextSibling();
-                }
+    return instanceCount;
+}
 
-                char* endPtr = nullptr;
-                const std::string maxEntries = pElement->Attribute("maxEntries");
-                // Seems like a {i} instance
-                if (maxEntries.empty() != true && ((!strcmp(maxEntries.c_str(),"unbounded")) || (strtol(maxEntries.c_str(), &endPtr, 10) > 1))) {
-                    // Make Sure that its ends with {i}
-                    if (IsParamEndsWithInstance(pAttrib->Value()) == true ) {
-                        uint16_t instanceNumber = 0;
-                        uint16_t i = 1;
-                        // Get the Number of instances for that attribute
-                        uint16_t actualInstance = ParameterInstanceCount(pAttrib->Value());
-                        if (inst) {
-                            // Check if valid instance count is given in input wild card if not make it as zero, this will skip current branch
-                            if (actualInstance >= inst)
-                                i = instanceNumber = inst;
-                            else
-                                instanceNumber = 0;
-                        } else {
-                            instanceNumber = actualInstance;
+void WalDB::Split(const std::string& name, std::vector<std::string>& segments)
+{
+    std::size_t start = 0;
+    std::size_t separator;
 
-                        }
-                        sChild = child;
-                        // Number of instances are > 0 go through each and populate data for each instance
-                        std::string tempParamName;
-                        while (i <= instanceNumber) {
-                            tempParamName = child->Parent()->ToElement()->FirstAttribute()->Value();
-                            currentParam = tempParamName;
-
-                            // Replace {i} with current instance number and call recursively
-                            ReplaceWithInstanceNumber(currentParam, i);
-                            sChild = Parameters(child, tempParamName, currentParam, paramList);
-                            i++;
-                        }
-                        child = sChild;
-                        // Seems like instance count is empty
-                        if (!instanceNumber) {
-                            zeroInstance = pAttrib->Value();
-                            child = child->Parent();
-                        }
-                    }
-                }
-            }
-            else if (isReccursiveCall) { // Tree found once and processed and going to another branch so break
-                return child;
-            }
-            else { // Tree not found yet goto next sibling and get it
-                child = child->NextSibling();
-            }
-        }
-        // Found the Parameter
-        else if (!strcmp(child->Value(),"parameter")) {
-            TiXmlNode* bChild;
-            // Find all parameters
-            for (bChild = child ; child ; child=child->NextSibling()) {
-                if (paramList.size() <= MaxNumParameters) {
-                    if (currentParam.length() > 0) {
-                        if (child->ToElement()->Attribute("getIdx") && strtol(child->ToElement()->Attribute("getIdx"),nullptr,10) >= 1) {
-                            paramList.insert(std::pair<string, std::string>(currentParam + child->ToElement()->FirstAttribute()->Value(), child->FirstChild()->FirstChild()->Value()));
-                        }
-                    }
-                }
-            }
-            // Go to next object
-            child = bChild->Parent();
-            child = child->NextSibling();
-        }
+    segments.clear();
+
+    while ((separator = name.find('.', start)) != std::string::npos) {
+        segments.emplace_back(name, start, separator - start);
+        start = separator + 1;
     }
-    return child;
 }
 
-DBStatus WalDB::Parameters(const std::string& paramName, std::map<std::string, std::string>& paramList) const
+bool WalDB::IsInstanceNumber(const std::string& segment)
 {
-    std::string currentParam;
-    std::string parameterName = paramName;
-
-    ASSERT(_dbHandle != 0);
-    DBStatus status = DB_SUCCESS;
-    if (Utils::IsWildCardParam(parameterName)) {
-        Parameters(reinterpret_cast<TiXmlDocument*>(_dbHandle), parameterName, currentParam, paramList);
-        if (paramList.size() == 0) {
-            status = DB_ERR_INVALID_PARAMETER;
-        }
-    } else {
-        status = DB_ERR_WILDCARD_NOT_SUPPORTED;
-    }
-    return status;
+    return ((segment.empty() == false) && (segment.find_first_not_of("0123456789") == std::string::npos));
 }
 
-void WalDB::CheckforParameterMatch(TiXmlNode* parent, const std::string& paramName, bool& match, std::string& dataType) const
+const WalDB::Node* WalDB::Find(const Node& node, const std::vector<std::string>& segments, const uint32_t index) const
 {
-    if (!parent)
-        return;
+    const Node* result = &node;
+
+    if (index < segments.size()) {
+        result = nullptr;
 
-    static bool isObject = false;
-    static bool isMatched = false;
+        auto child(node.Children.find(segments[index]));
 
-    if (parent->Type() == TiXmlNode::TINYXML_ELEMENT) {
-        TiXmlElement* pElement = parent->ToElement();
-        TiXmlAttribute* pAttrib = pElement->FirstAttribute();
-        if (!strcmp(parent->Value(), "object")) {
-            isObject = true;
+        if (child != node.Children.end()) {
+            result = Find(*(child->second), segments, index + 1);
         }
 
-        if (pAttrib) {
-            // Construct Object without parameter from input ParamName
-            std::size_t found = paramName.find_last_of(".");
+        if ((result == nullptr) && (IsInstanceNumber(segments[index]) == true)) {
+            child = node.Children.find(InstanceSegment);
 
-            std::string tempObject;
-            if (found != std::string::npos) {
-                tempObject.assign(paramName, 0, found + 1);
-            } else {
-                tempObject = paramName;
+            if (child != node.Children.end()) {
+                result = Find(*(child->second), segments, index + 1);
             }
+        }
+    }
 
-            static std::string objectName;
-            if (!strcmp(pAttrib->Value(), tempObject.c_str())) {
-                objectName = pAttrib->Value();
-                isMatched = true;
-            }
+    return result;
+}
 
-            if (isMatched || !isObject) {
-                if (objectName == paramName) {
-                    match = true;
-                    return;
-                } else {
-                    isObject = 0;
-                    if (!strcmp(parent->Value(), "parameter")) {
-                        std::string nameFromParamater = objectName + pAttrib->Value();
-
-                        if ((objectName + pAttrib->Value()) == paramName) {
-                            dataType = parent->FirstChild()->FirstChild()->Value();
-                            match = true;
-                            return;
-                        }
-                    }
-                }
+void WalDB::Parameters(const Node& node, const std::string& name, std::map<std::string, std::string>& paramList) const
+{
+    if (node.IsObject == true) {
+        for (const auto& parameter : node.Parameters) {
+            if ((parameter.second.Readable == true) && (paramList.size() <= MaxNumParameters)) {
+                paramList.insert(std::pair<string, std::string>(name + parameter.first, parameter.second.DataType));
             }
         }
     }
 
-    for (TiXmlNode* child = parent->FirstChild(); child != 0; child = child->NextSibling()) {
-        CheckforParameterMatch(child, paramName, match, dataType);
-        if (match == true) {
-            break;
-        }
-    }
-    isMatched = 0;
-}
+    for (const auto& child : node.Children) {
+        if (child.first == InstanceSegment) {
+            // Get the number of instances from the Adapter and populate the data for each of them.
+            const uint16_t instanceCount = ParameterInstanceCount(name);
 
-uint8_t WalDB::FindInstanceOccurance(const std::string& paramName, std::map<uint8_t, std::pair<std::size_t, std::size_t>>& positions) const
-{
-    uint8_t count = 0;
-    std::string name = paramName;
-    std::size_t separator = 0;
-    while (true) {
-        std::size_t position =  name.find_first_of("0123456789", separator);
-        if (position != std::string::npos) {
-            separator = name.find(".", position);
-            if (separator != std::string::npos) {
-                positions.insert(std::make_pair(count, std::make_pair(position, separator)));
-                count++;
-            } else {
-                break;
+            for (uint16_t instance = 1; instance <= instanceCount; instance++) {
+                Parameters(*(child.second), name + std::to_string(instance) + '.', paramList);
             }
         } else {
-            break;
+            Parameters(*(child.second), name + child.first + '.', paramList);
         }
     }
-
-    return count;
 }
 
-bool WalDB::ValidateParameterInstance(const std::string& paramName, std::string& dataType) const
+DBStatus WalDB::Parameters(const std::string& paramName, std::map<std::string, std::string>& paramList) const
 {
-    bool valid = false;
-
-    std::map<uint8_t, std::pair<std::size_t, std::size_t>> positions;
-    uint8_t occurrences = FindInstanceOccurance(paramName, positions);
-
-    for (uint8_t i = occurrences; (i > 0) && (valid != true); --i) {
-        uint8_t index = occurrences - i;
+    ASSERT(_dbHandle != 0);
+    DBStatus status = DB_SUCCESS;
+    if (Utils::IsWildCardParam(paramName)) {
+        std::vector<std::string> segments;
 
-        std::string tempName = paramName;
-        std::map<uint8_t, std::pair<std::size_t, std::size_t>>::iterator position = positions.find(index);
-        tempName.replace(position->second.first, ((position->second.second + 1) - position->second.first), InstanceNumberIndicator);
-        uint16_t maxCombinations = pow(2, i - 1);
-        for (uint16_t j = 0; j < maxCombinations; ++j) {
-            std::string name = tempName;
-            int8_t newPosition = 0;
-            for (uint8_t k = 0; k < i; ++k) {
-                if ((j & (1 << k))) {
+        Split(paramName, segments);
 
-                    index = (occurrences - 1) - k;
-                    std::map<uint8_t, std::pair<std::size_t, std::size_t>>::iterator position = positions.find(index);
+        const Node* node = Find(_root, segments, 0);
 
-                    newPosition = strlen(InstanceNumberIndicator) - ((position->second.second + 1) - position->second.first);
-                    name.replace(position->second.first + newPosition, ((position->second.second + 1) - position->second.first), InstanceNumberIndicator);
-                }
-            }
-            CheckforParameterMatch(reinterpret_cast<TiXmlDocument*>(_dbHandle), name, valid, dataType);
-            if (valid == true) {
-                break;
-            }
+        if (node != nullptr) {
+            Parameters(*node, paramName, paramList);
         }
+        if (paramList.size() == 0) {
+            status = DB_ERR_INVALID_PARAMETER;
+        }
+    } else {
+        status = DB_ERR_WILDCARD_NOT_SUPPORTED;
     }
-    return valid;
+    return status;
 }
 
 bool WalDB::IsValidParameter(const std::string& paramName, std::string& dataType) const
 {
     bool valid = false;
     ASSERT(_dbHandle != 0);
-    CheckforParameterMatch(reinterpret_cast<TiXmlDocument*>(_dbHandle), paramName, valid, dataType);
-    if (valid != true) {
-        valid = ValidateParameterInstance(paramName, dataType);
-    }
-    return valid;
-}
 
-bool WalDB::IsParamEndsWithInstance(const std::string& paramName) const
-{
-    bool isInstance = false;
+    std::vector<std::string> segments;
+    const std::size_t separator = paramName.find_last_of('.');
 
-    if (paramName.empty() != true) {
-        std::size_t position = paramName.find(string(InstanceNumberIndicator));
-        if ((position != std::string::npos) && ((position + strlen(InstanceNumberIndicator)) != std::string::npos)) {
-            isInstance = true;
+    Split(paramName, segments);
+
+    const Node* node = Find(_root, segments, 0);
+
+    if (node != nullptr) {
+        if (separator == (paramName.length() - 1)) {
+            // The name of an object
+            valid = node->IsObject;
+        } else {
+            auto parameter(node->Parameters.find(paramName.substr(separator + 1)));
+
+            if (parameter != node->Parameters.end()) {
+                dataType = parameter->second.DataType;
+                valid = true;
+            }
         }
     }
-    return isInstance;
+    return valid;
 }
 }
@@ -3,7 +3,8 @@
 #include "Handler.h"
 #include "Utils.h"
 
-#include <tinyxml.h>
+#include <memory>
+#include <unordered_map>
 
 namespace WPEFramework {
 
@@ -18,10 +19,39 @@ typedef enum
 }
 DBStatus;
 
+// The data model is loaded once and indexed in a trie on the segments of the object names, after
+// which the XML document is dropped. A segment "{i}" in the data model is a node of its own, that
+// matches any instance number in a parameter name.
 class WalDB {
 private:
     static constexpr const uint32_t  MaxNumParameters = 2048;
-    static constexpr const TCHAR* InstanceNumberIndicator = "{i}.";
+    static constexpr const TCHAR* InstanceSegment = "{i}";
+
+    struct Parameter {
+        string DataType;
+        bool Readable;
+    };
+
+    class Node {
+    public:
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        Node()
+            : IsObject(false)
+            , Children()
+            , Parameters()
+        {
+        }
+        ~Node()
+        {
+        }
+
+    public:
+        bool IsObject;
+        std::unordered_map<string, std::unique_ptr<Node>> Children;
+        std::unordered_map<string, Parameter> Parameters;
+    };
 
 public:
     WalDB() = delete;
@@ -34,20 +64,20 @@ public:
     DBStatus LoadDB(const std::string& filename);
     DBStatus Parameters(const std::string& paramName, std::map<std::string, std::string>& paramList) const;
     bool IsValidParameter(const std::string& paramName, std::string& dataType) const;
+    // Non zero once the data model is loaded, it holds the number of objects in the model.
     int DBHandle() { return _dbHandle; }
 
 private:
-    TiXmlNode* Parameters(TiXmlNode* pParent, const std::string& paramName, std::string& currentParam, std::map<std::string, std::string>& paramList) const;
-    void CheckforParameterMatch(TiXmlNode *pParent, const std::string& paramName, bool& pMatch, std::string& dataType) const;
-    bool IsParamEndsWithInstance(const std::string& paramName) const;
-    void ReplaceWithInstanceNumber(string& paramName, uint16_t instanceNumber) const;
-    bool CheckMatchingParameter(const char* attrValue, const char* paramName, uint32_t& ret) const;
-    bool ValidateParameterInstance(const std::string& paramName, std::string& dataType) const;
-    uint8_t FindInstanceOccurance(const std::string& paramName, std::map<uint8_t, std::pair<std::size_t, std::size_t>>& positions) const;
-    int16_t ParameterInstanceCount(const std::string& paramName) const;
+    void Parameters(const Node& node, const std::string& name, std::map<std::string, std::string>& paramList) const;
+    const Node* Find(const Node& node, const std::vector<std::string>& segments, const uint32_t index) const;
+    uint16_t ParameterInstanceCount(const std::string& objectName) const;
+
+    static void Split(const std::string& name, std::vector<std::string>& segments);
+    static bool IsInstanceNumber(const std::string& segment);
 
 private:
     int _dbHandle;
     Handler* _handler;
+    Node _root;
 };
 }
@@ -50,7 +50,7 @@ Handler::~Handler()
         delete _notificationCallback;
     }
     for (auto& profileController: _systemProfileControllers) {
-        profileController.second.control->Deinitialize();
+        profileController.control->Deinitialize();
     }
     _systemLibraries.clear();
 }
@@ -77,13 +77,18 @@ uint32_t Handler::Configure(PluginHost::IShell* service)
         const std::string name(index.Current().ProfileControl.Value());
 
         if (name.empty() == false) {
-            SystemProfileController systemProfileController;
-            systemProfileController.name = name;
+            IProfileControl* control = WebPAProfileInstance(name.c_str());
 
-            systemProfileController.control = WebPAProfileInstance(name.c_str());
-            systemProfileController.control->Initialize();
-            if (systemProfileController.control) {
-                _systemProfileControllers.insert(std::pair<const std::string, SystemProfileController>(index.Current().ProfileName.Value(), systemProfileController));
+            // The first mapping of a profile wins.
+            if ((control != nullptr) && (GetProfileController('.' + index.Current().ProfileName.Value()) == nullptr)) {
+                control->Initialize();
+
+                _systemProfileControllers.emplace_back();
+
+                SystemProfileController& systemProfileController(_systemProfileControllers.back());
+                systemProfileController.profile = index.Current().ProfileName.Value();
+                systemProfileController.name = name;
+                systemProfileController.control = control;
             }
         } else {
             TRACE_GLOBAL(Trace::Information, (_T("Required adapter not found for %s"), index.Current().ProfileName.Value()));
@@ -102,7 +107,9 @@ uint32_t Handler::Worker()
     if (IsRunning() == true) {
 
         for (auto& profileController: _systemProfileControllers) {
-            profileController.second.control->CheckForUpdates();
+            profileController.lock.Lock();
+            profileController.control->CheckForUpdates();
+            profileController.lock.Unlock();
         }
 
         _signaled.Lock(MaxWaitTime);
@@ -116,10 +123,12 @@ const FaultCode Handler::Parameter(Data& parameter) const
     FaultCode ret = FaultCode::NoFault;
 
     /* Find the respective manager and forward the request*/
-    const IProfileControl* control = GetProfileController(parameter.Name());
+    const SystemProfileController* controller = GetProfileController(parameter.Name());
 
-    if (control) {
-        ret = control->Parameter(parameter);
+    if (controller) {
+        controller->lock.Lock();
+        ret = controller->control->Parameter(parameter);
+        controller->lock.Unlock();
     }
 
     return ret;
@@ -131,10 +140,12 @@ FaultCode Handler::Parameter(const Data& parameter)
     FaultCode ret = FaultCode::NoFault;
 
     /* Find the respective manager and forward the request*/
-    IProfileControl* control = GetProfileController(parameter.Name());
+    const SystemProfileController* controller = GetProfileController(parameter.Name());
 
-    if (control) {
-        ret = control->Parameter(parameter);
+    if (controller) {
+        controller->lock.Lock();
+        ret = controller->control->Parameter(parameter);
+        controller->lock.Unlock();
     }
 
     return ret;
@@ -146,11 +157,14 @@ const FaultCode Handler::Attribute(Data& parameter) const
     FaultCode ret = FaultCode::NoFault;
 
     /* Find the respective manager and forward the request*/
-    const IProfileControl* control = GetProfileController(parameter.Name());
+    const SystemProfileController* controller = GetProfileController(parameter.Name());
 
-    if (control) {
-        ret = control->Attribute(parameter);
+    if (controller) {
+        controller->lock.Lock();
+        ret = controller->control->Attribute(parameter);
+        controller->lock.Unlock();
     }
+
     return ret;
 }
 
@@ -160,9 +174,12 @@ FaultCode Handler::Attribute(const Data& parameter)
     FaultCode ret = FaultCode::NoFault;
 
     /* Find the respective manager and forward the request*/
-    IProfileControl* control = GetProfileController(parameter.Name());
-    if (control) {
-        ret = control->Attribute(parameter);
+    const SystemProfileController* controller = GetProfileController(parameter.Name());
+
+    if (controller) {
+        controller->lock.Lock();
+        ret = controller->control->Attribute(parameter);
+        controller->lock.Unlock();
     }
 
     return ret;
@@ -176,51 +193,43 @@ void Handler::FreeData(Data* parameter)
     }
 }
 
-std::vector<std::string> Handler::SplitParam(std::string parameter, char delimeter) const
-{
-    std::stringstream ss(parameter);
-    std::string str;
-    std::vector<std::string> splittedParams;
-    while (std::getline(ss, str, delimeter))
-    {
-       splittedParams.push_back(str);
-    }
-    return splittedParams;
-}
-
 void Handler::ConfigureProfileControllers()
 {
     for (auto& profileController: _systemProfileControllers) {
-        profileController.second.control->SetCallback(_notificationCallback);
+        profileController.control->SetCallback(_notificationCallback);
     }
 }
 
-IProfileControl* Handler::GetProfileController(const std::string& name)
+const IProfileControl* Handler::Profile(const std::string& name) const
 {
-    TRACE(Trace::Information, (string(__FUNCTION__)));
-    IProfileControl* pRet = nullptr;
+    const SystemProfileController* controller = GetProfileController(name);
 
-    std::vector<std::string> paramComponents = SplitParam(name, '.');
-    std::map<const std::string, SystemProfileController>::iterator index(_systemProfileControllers.find(paramComponents[1]));
-    if (_systemProfileControllers.end() != index) {
-        pRet = index->second.control;
-    } else {
-        TRACE(Trace::Information, (_T("Could not able to find Profile controller for %s"), name.c_str()));
-    }
-
-    return pRet;
+    return (controller != nullptr ? controller->control : nullptr);
 }
 
-const IProfileControl* Handler::GetProfileController(const std::string& name) const
+const Handler::SystemProfileController* Handler::GetProfileController(const std::string& name) const
 {
     TRACE(Trace::Information, (string(__FUNCTION__)));
-    const IProfileControl* pRet = nullptr;
+    const SystemProfileController* pRet = nullptr;
+
+    // The profile is the second component of the name, compare it in place.
+    std::size_t start = name.find('.');
+
+    if (start != std::string::npos) {
+        start++;
+
+        std::size_t end = name.find('.', start);
+        const std::size_t length = (end == std::string::npos ? name.length() : end) - start;
+
+        for (const SystemProfileController& controller: _systemProfileControllers) {
+            if (controller.profile.compare(0, std::string::npos, name, start, length) == 0) {
+                pRet = &controller;
+                break;
+            }
+        }
+    }
 
-    std::vector<std::string> paramComponents = SplitParam(name, '.');
-    std::map<const std::string, SystemProfileController>::const_iterator index(_systemProfileControllers.find(paramComponents[1]));
-    if (_systemProfileControllers.end() != index) {
-        pRet = index->second.control;
-    } else {
+    if (pRet == nullptr) {
         TRACE(Trace::Information, (_T("Could not able to find Profile controller for %s"), name.c_str()));
     }
 
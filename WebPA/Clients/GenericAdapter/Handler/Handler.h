@@ -106,9 +106,14 @@ public:
     };
 
 public:
+    // The controller serving the parameters of a profile, which is the second segment of the name of
+    // a parameter, e.g. "DeviceInfo" for "Device.DeviceInfo.Manufacturer". Calls on a controller are
+    // serialized with its lock, calls on different controllers may run concurrently.
     struct SystemProfileController {
+        std::string profile;
         std::string name;
         IProfileControl* control;
+        mutable Core::CriticalSection lock;
     };
 
 public:
@@ -125,21 +130,23 @@ public:
     const FaultCode Attribute(Data& value) const;
     FaultCode Attribute(const Data& value);
 
+    // Returns the controller serving the given parameter, or nullptr if there is none. Parameters with
+    // the same controller can not be handled in parallel.
+    const IProfileControl* Profile(const std::string& name) const;
+
     void FreeData(Data* value);
     void ConfigureProfileControllers();
     uint32_t Configure(PluginHost::IShell* service);
 
 private:
     virtual uint32_t Worker();
-    IProfileControl* GetProfileController(const std::string& value);
-    const IProfileControl* GetProfileController(const std::string& value) const;
-    std::vector<std::string> SplitParam(std::string parameter, char delimeter) const;
+    const SystemProfileController* GetProfileController(const std::string& value) const;
 
 private:
     std::string _configFile;
     std::list<Core::Library> _systemLibraries;
 
-    std::map<const std::string, SystemProfileController> _systemProfileControllers;
+    std::list<SystemProfileController> _systemProfileControllers;
 
     NotificationCallback* _notificationCallback;
 
@@ -0,0 +1,84 @@
+#ifndef __PLUGINWEBPROXY_RINGBUFFER_H
+#define __PLUGINWEBPROXY_RINGBUFFER_H
+
+#include "Module.h"
+
+#include <atomic>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Byte ring for exactly one producer thread and one consumer thread. The producer only moves
+    // the head, the consumer only moves the tail, so neither side needs a lock. Both positions run
+    // freely and are masked on access, which requires the size to be a power of two.
+    template <const uint32_t SIZE>
+    class RingBuffer {
+    private:
+        RingBuffer(const RingBuffer<SIZE>&) = delete;
+        RingBuffer<SIZE>& operator=(const RingBuffer<SIZE>&) = delete;
+
+        static_assert((SIZE != 0) && ((SIZE & (SIZE - 1)) == 0), "The size of a RingBuffer must be a power of two");
+
+    public:
+        RingBuffer()
+            : _head(0)
+            , _tail(0)
+        {
+        }
+        ~RingBuffer()
+        {
+        }
+
+    public:
+        inline bool IsEmpty() const
+        {
+            return (_head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire));
+        }
+        // Producer side, returns the number of bytes that fitted.
+        uint32_t Write(const uint8_t data[], const uint32_t length)
+        {
+            const uint32_t head = _head.load(std::memory_order_relaxed);
+            const uint32_t free = SIZE - (head - _tail.load(std::memory_order_acquire));
+            const uint32_t result = std::min(length, free);
+
+            if (result > 0) {
+                const uint32_t offset = head & (SIZE - 1);
+                const uint32_t first = std::min(result, SIZE - offset);
+
+                ::memcpy(&(_buffer[offset]), data, first);
+                ::memcpy(_buffer, &(data[first]), result - first);
+
+                _head.store(head + result, std::memory_order_release);
+            }
+
+            return (result);
+        }
+        // Consumer side, returns the number of bytes read.
+        uint32_t Read(uint8_t data[], const uint32_t length)
+        {
+            const uint32_t tail = _tail.load(std::memory_order_relaxed);
+            const uint32_t used = _head.load(std::memory_order_acquire) - tail;
+            const uint32_t result = std::min(length, used);
+
+            if (result > 0) {
+                const uint32_t offset = tail & (SIZE - 1);
+                const uint32_t first = std::min(result, SIZE - offset);
+
+                ::memcpy(data, &(_buffer[offset]), first);
+                ::memcpy(&(data[first]), _buffer, result - first);
+
+                _tail.store(tail + result, std::memory_order_release);
+            }
+
+            return (result);
+        }
+
+    private:
+        std::atomic<uint32_t> _head;
+        std::atomic<uint32_t> _tail;
+        uint8_t _buffer[SIZE];
+    };
+}
+}
+
+#endif // __PLUGINWEBPROXY_RINGBUFFER_H
@@ -241,6 +241,9 @@ namespace Plugin {
         // First do a cleanup of all "completely" closed channels.
         std::map<const uint32_t, Connector*>::iterator connection(_connectionMap.begin());
 
+        // The map is only changed here, on the channel thread, the lock is for Information().
+        _adminLock.Lock();
+
         while (connection != _connectionMap.end()) {
             if (connection->second->IsClosed() == true) {
                 delete connection->second;
@@ -250,12 +253,16 @@ namespace Plugin {
             }
         }
 
+        _adminLock.Unlock();
+
         // See if we are still allowed to create a new connection..
         if (_connectionMap.size() < _maxConnections) {
             Connector* newLink = CreateConnector(channel);
 
             if (newLink != nullptr) {
+                _adminLock.Lock();
                 _connectionMap.insert(std::pair<uint32_t, Connector*>(channel.Id(), newLink));
+                _adminLock.Unlock();
                 TRACE(Trace::Information, (Trace::Format(_T("Proxy connection channel ID [%d] to %s"), channel.Id(), newLink->RemoteId().c_str()).c_str()));
                 added = true;
 
@@ -278,8 +285,28 @@ namespace Plugin {
 
     /* virtual */ string WebProxy::Information() const
     {
-        // No additional info to report.
-        return (string());
+        Metadata metadata;
+        string result;
+
+        _adminLock.Lock();
+
+        std::map<const uint32_t, Connector*>::const_iterator index(_connectionMap.begin());
+
+        while (index != _connectionMap.end()) {
+            if (index->second->IsClosed() == false) {
+                Metadata::Link& link(metadata.Links.Add());
+
+                link.Id = index->first;
+                index->second->Statistics(link);
+            }
+            index++;
+        }
+
+        _adminLock.Unlock();
+
+        metadata.ToString(result);
+
+        return (result);
     }
 
     // IChannel methods
@@ -2,6 +2,7 @@
 #define __PLUGINWEBPROXY_H
 
 #include "Module.h"
+#include "RingBuffer.h"
 
 namespace WPEFramework {
 namespace Plugin {
@@ -12,18 +13,198 @@ namespace Plugin {
         WebProxy& operator=(const WebProxy&) = delete;
 
     public:
+        class Metadata : public Core::JSON::Container {
+        public:
+            class Direction : public Core::JSON::Container {
+            private:
+                Direction& operator=(const Direction&) = delete;
+
+            public:
+                Direction()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("bytes"), &Bytes);
+                    Add(_T("wakeups"), &Wakeups);
+                    Add(_T("latency"), &Latency);
+                    Add(_T("peak"), &Peak);
+                }
+                Direction(const Direction& copy)
+                    : Core::JSON::Container()
+                    , Bytes(copy.Bytes)
+                    , Wakeups(copy.Wakeups)
+                    , Latency(copy.Latency)
+                    , Peak(copy.Peak)
+                {
+                    Add(_T("bytes"), &Bytes);
+                    Add(_T("wakeups"), &Wakeups);
+                    Add(_T("latency"), &Latency);
+                    Add(_T("peak"), &Peak);
+                }
+                ~Direction()
+                {
+                }
+
+            public:
+                Core::JSON::DecUInt64 Bytes;
+                Core::JSON::DecUInt32 Wakeups; // Number of times data arrived while the relay was idle
+                Core::JSON::DecUInt32 Latency; // Average time in us from such an arrival till the data is picked up
+                Core::JSON::DecUInt32 Peak; // Longest time in us from such an arrival till the data is picked up
+            };
+
+            class Link : public Core::JSON::Container {
+            private:
+                Link& operator=(const Link&) = delete;
+
+            public:
+                Link()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("id"), &Id);
+                    Add(_T("remote"), &Remote);
+                    Add(_T("upstream"), &Upstream);
+                    Add(_T("downstream"), &Downstream);
+                }
+                Link(const Link& copy)
+                    : Core::JSON::Container()
+                    , Id(copy.Id)
+                    , Remote(copy.Remote)
+                    , Upstream(copy.Upstream)
+                    , Downstream(copy.Downstream)
+                {
+                    Add(_T("id"), &Id);
+                    Add(_T("remote"), &Remote);
+                    Add(_T("upstream"), &Upstream);
+                    Add(_T("downstream"), &Downstream);
+                }
+                ~Link()
+                {
+                }
+
+            public:
+                Core::JSON::DecUInt32 Id;
+                Core::JSON::String Remote;
+                Direction Upstream; // From the websocket to the link
+                Direction Downstream; // From the link to the websocket
+            };
+
+        private:
+            Metadata(const Metadata&) = delete;
+            Metadata& operator=(const Metadata&) = delete;
+
+        public:
+            Metadata()
+                : Core::JSON::Container()
+            {
+                Add(_T("links"), &Links);
+            }
+            ~Metadata()
+            {
+            }
+
+        public:
+            Core::JSON::ArrayType<Link> Links;
+        };
+
         class Connector {
         private:
             Connector(const Connector&) = delete;
             Connector& operator=(const Connector&) = delete;
 
+            // The data for one direction is written by the thread reading one side and read by the thread
+            // writing the other side, so it can pass through a lock free ring. The side that writes only needs
+            // to be woken up if it ran out of data before, that is what the idle flag tracks.
+            class Relay {
+            private:
+                Relay(const Relay&) = delete;
+                Relay& operator=(const Relay&) = delete;
+
+            public:
+                Relay()
+                    : _buffer()
+                    , _idle(true)
+                    , _signalled(0)
+                    , _bytes(0)
+                    , _wakeups(0)
+                    , _latency(0)
+                    , _peak(0)
+                {
+                }
+                ~Relay()
+                {
+                }
+
+            public:
+                // Returns true in wakeup if the consuming side must be triggered.
+                uint16_t Push(const uint8_t data[], const uint16_t length, bool& wakeup)
+                {
+                    uint16_t result = static_cast<uint16_t>(_buffer.Write(data, length));
+
+                    wakeup = ((result > 0) && (_idle.exchange(false) == true));
+
+                    if (wakeup == true) {
+                        _signalled.store(Core::Time::Now().Ticks(), std::memory_order_release);
+                    }
+
+                    return (result);
+                }
+                uint16_t Pop(uint8_t data[], const uint16_t length)
+                {
+                    uint64_t signalled = _signalled.exchange(0, std::memory_order_acquire);
+
+                    if (signalled != 0) {
+                        uint64_t now = Core::Time::Now().Ticks();
+                        uint32_t latency = static_cast<uint32_t>(now > signalled ? now - signalled : 0);
+
+                        _wakeups.fetch_add(1, std::memory_order_relaxed);
+                        _latency.fetch_add(latency, std::memory_order_relaxed);
+                        if (latency > _peak.load(std::memory_order_relaxed)) {
+                            _peak.store(latency, std::memory_order_relaxed);
+                        }
+                    }
+
+                    uint16_t result = static_cast<uint16_t>(_buffer.Read(data, length));
+
+                    if (result == 0) {
+                        // Going idle. If the producer added data just before it could see the flag, it did
+                        // not trigger us, so check once more and if so, take the data ourselves.
+                        _idle.store(true);
+
+                        if ((_buffer.IsEmpty() == false) && (_idle.exchange(false) == true)) {
+                            result = static_cast<uint16_t>(_buffer.Read(data, length));
+                        }
+                    }
+
+                    _bytes.fetch_add(result, std::memory_order_relaxed);
+
+                    return (result);
+                }
+                void Statistics(Metadata::Direction& info) const
+                {
+                    uint32_t wakeups = _wakeups.load(std::memory_order_relaxed);
+
+                    info.Bytes = _bytes.load(std::memory_order_relaxed);
+                    info.Wakeups = wakeups;
+                    info.Latency = static_cast<uint32_t>(wakeups > 0 ? _latency.load(std::memory_order_relaxed) / wakeups : 0);
+                    info.Peak = _peak.load(std::memory_order_relaxed);
+                }
+
+            private:
+                RingBuffer<8192> _buffer;
+                std::atomic<bool> _idle;
+                std::atomic<uint64_t> _signalled;
+                std::atomic<uint64_t> _bytes;
+                std::atomic<uint32_t> _wakeups;
+                std::atomic<uint64_t> _latency;
+                std::atomic<uint32_t> _peak;
+            };
+
         public:
             Connector(PluginHost::Channel& channel, Core::IStream* link)
                 : _link(link)
                 , _channel(&channel)
                 , _adminLock()
-                , _channelBuffer()
-                , _socketBuffer()
+                , _upstream()
+                , _downstream()
             {
             }
             virtual ~Connector()
@@ -52,62 +233,52 @@ namespace Plugin {
             {
                 return ((_channel == nullptr) && (_link->IsClosed()));
             }
-            // Methods to extract and insert data into the socket buffers
-            uint16_t SendData(uint8_t* dataFrame, const uint16_t maxSendSize)
+            inline void Statistics(Metadata::Link& info) const
             {
-                _adminLock.Lock();
-
-                uint16_t result = _socketBuffer.Read(dataFrame, maxSendSize);
-
-                _adminLock.Unlock();
+                info.Remote = RemoteId();
+                _upstream.Statistics(info.Upstream);
+                _downstream.Statistics(info.Downstream);
+            }
 
-                return (result);
+            // Methods to extract and insert data into the socket buffers. The data path itself is lock free,
+            // the lock is only taken to wake up the websocket, as the channel might be detached concurrently.
+            uint16_t SendData(uint8_t* dataFrame, const uint16_t maxSendSize)
+            {
+                return (_upstream.Pop(dataFrame, maxSendSize));
             }
 
             uint16_t ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize)
             {
-                _adminLock.Lock();
+                bool wakeup;
+                uint16_t result = _downstream.Push(dataFrame, receivedSize, wakeup);
 
-                bool wasEmpty = _channelBuffer.IsEmpty();
-
-                uint16_t result = _channelBuffer.Write(dataFrame, receivedSize);
-
-                if (wasEmpty == true) {
+                if (wakeup == true) {
                     // This is new data, there was nothing pending, trigger a request for a frambuffer.
-                    _channel->RequestOutbound();
+                    _adminLock.Lock();
+                    if (_channel != nullptr) {
+                        _channel->RequestOutbound();
+                    }
+                    _adminLock.Unlock();
                 }
 
-                _adminLock.Unlock();
-
                 return (result);
             }
 
-            uint16_t ChannelSend(uint8_t* dataFrame, const uint16_t maxSendSize) const
+            uint16_t ChannelSend(uint8_t* dataFrame, const uint16_t maxSendSize)
             {
-                _adminLock.Lock();
-
-                uint16_t result = _channelBuffer.Read(dataFrame, maxSendSize);
-
-                _adminLock.Unlock();
-
-                return (result);
+                return (_downstream.Pop(dataFrame, maxSendSize));
             }
 
             uint16_t ChannelReceive(const uint8_t* dataFrame, const uint16_t receivedSize)
             {
-                _adminLock.Lock();
-
-                bool wasEmpty = _socketBuffer.IsEmpty();
+                bool wakeup;
+                uint16_t result = _upstream.Push(dataFrame, receivedSize, wakeup);
 
-                uint16_t result = _socketBuffer.Write(dataFrame, receivedSize);
-
-                if (wasEmpty == true) {
+                if (wakeup == true) {
                     // This is new data, there was nothing pending, trigger a request for a frambuffer.
                     _link->Trigger();
                 }
 
-                _adminLock.Unlock();
-
                 return (result);
             }
 
@@ -142,8 +313,8 @@ namespace Plugin {
             Core::IStream* _link;
             PluginHost::Channel* _channel;
             mutable Core::CriticalSection _adminLock;
-            Core::CyclicDataBuffer<Core::ScopedStorage<8192>> _channelBuffer;
-            Core::CyclicDataBuffer<Core::ScopedStorage<8192>> _socketBuffer;
+            Relay _upstream;
+            Relay _downstream;
         };
         class Config : public Core::JSON::Container {
         public:
@@ -314,7 +485,8 @@ namespace Plugin {
 
     public:
         WebProxy()
-            : _connectionMap()
+            : _adminLock()
+            , _connectionMap()
         {
         }
         virtual ~WebProxy()
@@ -370,6 +542,7 @@ namespace Plugin {
     private:
         string _prefix;
         uint32_t _maxConnections;
+        mutable Core::CriticalSection _adminLock;
         std::map<const uint32_t, Connector*> _connectionMap;
         std::map<const string, Config::Link> _linkInfo;
     };
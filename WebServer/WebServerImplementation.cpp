@@ -1,11 +1,79 @@
 #include "Module.h"
 #include <interfaces/IMemory.h>
 #include <interfaces/IWebServer.h>
+#include <deque>
+#include <memory>
+#include <sys/stat.h>
+#include <unordered_map>
 
 namespace WPEFramework {
 namespace Plugin {
 
+    // Serves content owned by the FileCache, so a response does not need its own copy of it. The
+    // content is reference counted, so it stays valid while the response is being sent, even if
+    // the cache drops the entry in the mean time. Every body keeps its own position in the content.
+    class SharedBody : public Web::IBody {
+    private:
+        SharedBody(const SharedBody&) = delete;
+        SharedBody& operator=(const SharedBody&) = delete;
+
+    public:
+        SharedBody()
+            : _content()
+            , _offset(0)
+        {
+        }
+        virtual ~SharedBody()
+        {
+        }
+
+    public:
+        inline void Content(const std::shared_ptr<const string>& content)
+        {
+            _content = content;
+            _offset = 0;
+        }
+
+    private:
+        virtual uint32_t Serialize() const override
+        {
+            _offset = 0;
+            return (_content != nullptr ? static_cast<uint32_t>(_content->length()) : 0);
+        }
+        virtual uint32_t Deserialize() override
+        {
+            // Only used for outgoing content.
+            ASSERT(false);
+            return (0);
+        }
+        virtual void End() const override
+        {
+        }
+        virtual uint16_t Serialize(uint8_t stream[], const uint16_t maxLength) const override
+        {
+            uint16_t size = 0;
+
+            if ((_content != nullptr) && (_offset < _content->length())) {
+                size = static_cast<uint16_t>(std::min(static_cast<size_t>(maxLength), _content->length() - _offset));
+                ::memcpy(stream, &((*_content)[_offset]), size);
+                _offset += size;
+            }
+
+            return (size);
+        }
+        virtual uint16_t Deserialize(const uint8_t[], const uint16_t) override
+        {
+            ASSERT(false);
+            return (0);
+        }
+
+    private:
+        std::shared_ptr<const string> _content;
+        mutable uint32_t _offset;
+    };
+
     static Core::ProxyPoolType<Web::TextBody> _textBodies(5);
+    static Core::ProxyPoolType<SharedBody> _sharedBodies(5);
 
     class WebServerImplementation : public Exchange::IWebServer, public PluginHost::IStateControl {
     private:
@@ -82,20 +150,36 @@ namespace Plugin {
                     , Path()
                     , Subst()
                     , Server()
+                    , Connections(4)
+                    , MinIdle(0)
+                    , MaxIdle(2)
+                    , Pipeline(1)
                 {
                     Add(_T("path"), &Path);
                     Add(_T("subst"), &Subst);
                     Add(_T("server"), &Server);
+                    Add(_T("connections"), &Connections);
+                    Add(_T("minidle"), &MinIdle);
+                    Add(_T("maxidle"), &MaxIdle);
+                    Add(_T("pipeline"), &Pipeline);
                 }
                 Proxy(const Proxy& copy)
                     : Core::JSON::Container()
                     , Path(copy.Path)
                     , Subst(copy.Subst)
                     , Server(copy.Server)
+                    , Connections(copy.Connections)
+                    , MinIdle(copy.MinIdle)
+                    , MaxIdle(copy.MaxIdle)
+                    , Pipeline(copy.Pipeline)
                 {
                     Add(_T("path"), &Path);
                     Add(_T("subst"), &Subst);
                     Add(_T("server"), &Server);
+                    Add(_T("connections"), &Connections);
+                    Add(_T("minidle"), &MinIdle);
+                    Add(_T("maxidle"), &MaxIdle);
+                    Add(_T("pipeline"), &Pipeline);
                 }
                 virtual ~Proxy()
                 {
@@ -105,6 +189,10 @@ namespace Plugin {
                 Core::JSON::String Path;
                 Core::JSON::String Subst;
                 Core::JSON::String Server;
+                Core::JSON::DecUInt8 Connections; // Maximum number of connections to the server
+                Core::JSON::DecUInt8 MinIdle; // Connections opened up front and kept for reuse
+                Core::JSON::DecUInt8 MaxIdle; // Idle connections kept open, any above this are closed
+                Core::JSON::DecUInt8 Pipeline; // Requests sent on a connection before a response is received
             };
 
         public:
@@ -115,6 +203,9 @@ namespace Plugin {
                 , Interface()
                 , Path(_T("www"))
                 , IdleTime(180)
+                , Statistics()
+                , CacheSize(1024)
+                , CacheFileSize(64)
             {
                 Add(_T("port"), &Port);
                 Add(_T("binding"), &Binding);
@@ -122,6 +213,9 @@ namespace Plugin {
                 Add(_T("path"), &Path);
                 Add(_T("idletime"), &IdleTime);
                 Add(_T("proxies"), &Proxies);
+                Add(_T("statistics"), &Statistics);
+                Add(_T("cachesize"), &CacheSize);
+                Add(_T("cachefilesize"), &CacheFileSize);
             }
             ~Config()
             {
@@ -134,6 +228,105 @@ namespace Plugin {
             Core::JSON::String Path;
             Core::JSON::DecUInt16 IdleTime;
             Core::JSON::ArrayType<Proxy> Proxies;
+            Core::JSON::String Statistics; // If set, a GET on this path returns the proxy statistics
+            Core::JSON::DecUInt32 CacheSize; // Size in KB of the file content cache, 0 disables it
+            Core::JSON::DecUInt32 CacheFileSize; // Size in KB of the largest file kept in the cache
+        };
+
+        class Statistics : public Core::JSON::Container {
+        public:
+            class Bucket : public Core::JSON::Container {
+            private:
+                Bucket& operator=(const Bucket&) = delete;
+
+            public:
+                Bucket()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("limit"), &Limit);
+                    Add(_T("count"), &Count);
+                }
+                Bucket(const Bucket& copy)
+                    : Core::JSON::Container()
+                    , Limit(copy.Limit)
+                    , Count(copy.Count)
+                {
+                    Add(_T("limit"), &Limit);
+                    Add(_T("count"), &Count);
+                }
+                ~Bucket()
+                {
+                }
+
+            public:
+                Core::JSON::DecUInt32 Limit; // Upper bound in ms, not set for the last bucket
+                Core::JSON::DecUInt32 Count;
+            };
+
+            class Upstream : public Core::JSON::Container {
+            private:
+                Upstream& operator=(const Upstream&) = delete;
+
+            public:
+                Upstream()
+                    : Core::JSON::Container()
+                {
+                    Add(_T("path"), &Path);
+                    Add(_T("server"), &Server);
+                    Add(_T("connections"), &Connections);
+                    Add(_T("idle"), &Idle);
+                    Add(_T("requests"), &Requests);
+                    Add(_T("latency"), &Latency);
+                    Add(_T("histogram"), &Histogram);
+                }
+                Upstream(const Upstream& copy)
+                    : Core::JSON::Container()
+                    , Path(copy.Path)
+                    , Server(copy.Server)
+                    , Connections(copy.Connections)
+                    , Idle(copy.Idle)
+                    , Requests(copy.Requests)
+                    , Latency(copy.Latency)
+                    , Histogram(copy.Histogram)
+                {
+                    Add(_T("path"), &Path);
+                    Add(_T("server"), &Server);
+                    Add(_T("connections"), &Connections);
+                    Add(_T("idle"), &Idle);
+                    Add(_T("requests"), &Requests);
+                    Add(_T("latency"), &Latency);
+                    Add(_T("histogram"), &Histogram);
+                }
+                ~Upstream()
+                {
+                }
+
+            public:
+                Core::JSON::String Path;
+                Core::JSON::String Server;
+                Core::JSON::DecUInt8 Connections;
+                Core::JSON::DecUInt8 Idle;
+                Core::JSON::DecUInt32 Requests;
+                Core::JSON::DecUInt32 Latency; // Average time in ms from receiving a request till its response
+                Core::JSON::ArrayType<Bucket> Histogram;
+            };
+
+        private:
+            Statistics(const Statistics&) = delete;
+            Statistics& operator=(const Statistics&) = delete;
+
+        public:
+            Statistics()
+                : Core::JSON::Container()
+            {
+                Add(_T("upstreams"), &Upstreams);
+            }
+            ~Statistics()
+            {
+            }
+
+        public:
+            Core::JSON::ArrayType<Upstream> Upstreams;
         };
 
         class RequestFactory {
@@ -179,12 +372,17 @@ namespace Plugin {
         };
 
         // IMPORTANT NOTE:
-        // There is no need to lock/unlock usage on this server as all action->response senarious take place on
-        // the communication thread from the SoketPortMonitor. There is only 1 such thread per process.
+        // There is hardly any need to lock/unlock usage on this server as all action->response senarious take
+        // place on the communication thread from the SoketPortMonitor. There is only 1 such thread per process.
+        // The exception is a delayed reconnect of an OutgoingChannel, it runs from the reconnect timer, so the
+        // state of a channel is guarded by its own lock. The timer thread never holds that lock while calling
+        // into the link, so the communication thread can hold it while it does.
         // Given this, make sure that all actions done by the ProxyMap are deterministic and short <100ms as it
         // upholds all other network traffic.
         class ProxyMap {
         private:
+            class Upstream;
+
             class OutgoingChannel : public Web::WebLinkType<Core::SocketStream, Web::Response, Web::Request, ResponseFactory> {
             private:
                 OutgoingChannel() = delete;
@@ -194,38 +392,72 @@ namespace Plugin {
                 struct OutstandingMessage {
                     Core::ProxyType<Web::Request> Request;
                     uint32_t Id;
+                    uint64_t Start;
                 };
 
+                // A lost connection is reestablished right away, after that with a delay that doubles
+                // on every attempt. Once all attempts failed, the waiting requests fail.
+                static constexpr uint8_t MaxReconnects = 5;
+                static constexpr uint32_t ReconnectDelay = 100;
+
             public:
-                OutgoingChannel(const string& path, const string& replacement, ProxyMap& proxyMap, const Core::NodeId& remoteId)
+                OutgoingChannel(Upstream& upstream, const Core::NodeId& remoteId, const uint8_t pipeline)
                     : Web::WebLinkType<Core::SocketStream, Web::Response, Web::Request, ResponseFactory>(2, false, remoteId.AnyInterface(), remoteId, 1024, 1024)
-                    , _path(path)
-                    , _replacement(replacement)
                     , _outstandingMessages()
-                    , _proxyMap(proxyMap)
+                    , _pipeline(std::max(pipeline, static_cast<uint8_t>(1)))
+                    , _sent(0)
+                    , _sending(false)
+                    , _reconnects(0)
+                    , _delayed(false)
+                    , _upstream(upstream)
+                    , _lock()
                 {
                 }
+                ~OutgoingChannel();
 
                 void ProxyRequest(Core::ProxyType<Web::Request>& request, uint32_t id)
                 {
+                    OutstandingMessage message = { request, id, Core::Time::Now().Ticks() };
 
-                    OutstandingMessage message = { request, id };
+                    _lock.Lock();
 
                     _outstandingMessages.push_back(message);
 
-                    if (_outstandingMessages.size() == 1) {
-                        if (IsOpen() == false) {
+                    if (IsOpen() == false) {
+                        // While waiting for a reconnect, the request is sent once that succeeds.
+                        if ((IsClosed() == true) && (_reconnects == 0)) {
                             Open(0);
-                        } else {
-                            Submit(request);
                         }
+                    } else {
+                        SubmitNext();
+                    }
+
+                    _lock.Unlock();
+                }
+                // Called from the timer, once the delay before the next attempt passed. As long as a
+                // delayed reconnect is pending, the communication thread does not open the link itself.
+                void Reconnect()
+                {
+                    _lock.Lock();
+
+                    const bool reconnect = (_delayed == true);
+                    _delayed = false;
+
+                    _lock.Unlock();
+
+                    if ((reconnect == true) && (IsClosed() == true)) {
+                        Open(0);
                     }
                 }
 
             public:
-                inline const string& Path() const
+                inline uint32_t Pending() const
                 {
-                    return (_path);
+                    _lock.Lock();
+                    uint32_t result = static_cast<uint32_t>(_outstandingMessages.size());
+                    _lock.Unlock();
+
+                    return (result);
                 }
                 virtual void LinkBody(Core::ProxyType<Web::Response>& response)
                 {
@@ -233,35 +465,264 @@ namespace Plugin {
                 }
                 virtual void Send(const Core::ProxyType<Web::Request>& request)
                 {
-                    std::list<OutstandingMessage>::iterator index(_outstandingMessages.begin());
+                    _lock.Lock();
 
-                    while ((index != _outstandingMessages.end()) && (index->Request.IsValid() == false)) {
-                        index++;
-                    }
+                    ASSERT(_sending == true);
+                    ASSERT(_sent <= _outstandingMessages.size());
+                    ASSERT(_outstandingMessages[_sent - 1].Request == request);
 
-                    ASSERT(index != _outstandingMessages.end());
-                    ASSERT(index->Request == request);
+                    _sending = false;
 
-                    index->Request.Release();
+                    SubmitNext();
+
+                    _lock.Unlock();
                 }
                 // Whenever there is a state change on the link, it is reported here.
                 virtual void StateChange()
                 {
+                    _lock.Lock();
+
                     if (IsOpen() == true) {
+                        _reconnects = 0;
+                        SubmitNext();
+                    } else if (IsClosed() == true) {
+                        Closed();
+                    }
+
+                    _lock.Unlock();
+                }
+                virtual void Received(Core::ProxyType<Web::Response>& response);
+
+            private:
+                static bool IsIdempotent(const Web::Request& request)
+                {
+                    return ((request.Verb == Web::Request::HTTP_GET) || (request.Verb == Web::Request::HTTP_HEAD) || (request.Verb == Web::Request::HTTP_PUT) || (request.Verb == Web::Request::HTTP_DELETE) || (request.Verb == Web::Request::HTTP_OPTIONS));
+                }
+
+                // Called with the lock taken.
+                void Closed();
+                void Fail(const OutstandingMessage& message);
+
+                // Called with the lock taken. Requests are submitted one at a time, as the link only queues a few, but up to the pipeline
+                // depth they do not wait for the response of the previous one.
+                void SubmitNext()
+                {
+                    if ((_sending == false) && (_sent < _pipeline) && (_sent < _outstandingMessages.size())) {
+                        _sending = true;
+                        Submit(_outstandingMessages[_sent++].Request);
+                    }
+                }
+
+            private:
+                std::deque<OutstandingMessage> _outstandingMessages;
+                const uint32_t _pipeline;
+                uint32_t _sent;
+                bool _sending;
+                uint8_t _reconnects;
+                bool _delayed;
+                Upstream& _upstream;
+                mutable Core::CriticalSection _lock;
+            };
+
+            // The pool of connections to the server behind a proxied path. Requests go to an idle
+            // connection if there is one, otherwise a new connection is made as long as the maximum
+            // is not reached, otherwise the connections are used in turn. All selections are O(1).
+            class Upstream {
+            private:
+                Upstream() = delete;
+                Upstream(const Upstream&) = delete;
+                Upstream& operator=(const Upstream&) = delete;
+
+                // Upper bounds, in ms, of the latency histogram buckets. Everything slower ends up in an extra, last, bucket.
+                static constexpr uint8_t Buckets = 10;
+
+            public:
+                Upstream(ProxyMap& parent, const string& path, const string& replacement, const Core::NodeId& remoteId, const uint8_t connections, const uint8_t minIdle, const uint8_t maxIdle, const uint8_t pipeline)
+                    : _parent(parent)
+                    , _path(path)
+                    , _replacement(replacement)
+                    , _remoteId(remoteId)
+                    , _connections(std::max(connections, static_cast<uint8_t>(1)))
+                    , _maxIdle(std::max(minIdle, maxIdle))
+                    , _pipeline(pipeline)
+                    , _channels()
+                    , _idle()
+                    , _next(0)
+                    , _requests(0)
+                    , _latency(0)
+                {
+                    ::memset(_histogram, 0, sizeof(_histogram));
+
+                    // Have the minimum number of connections ready for the first requests.
+                    for (uint8_t index = 0; index < std::min(minIdle, _connections); index++) {
+                        OutgoingChannel* channel = new OutgoingChannel(*this, _remoteId, _pipeline);
+
+                        _channels.push_back(channel);
+                        _idle.push_back(channel);
+                        channel->Open(0);
+                    }
+                }
+                ~Upstream()
+                {
+                    for (OutgoingChannel* channel : _channels) {
+                        delete channel;
+                    }
+                }
+
+            public:
+                inline const string& Path() const
+                {
+                    return (_path);
+                }
+                void Relay(Core::ProxyType<Web::Request>& request, uint32_t id)
+                {
+                    OutgoingChannel* channel;
+
+                    if (_idle.empty() == false) {
+                        // The most recently used connection is the most likely to still be open.
+                        channel = _idle.back();
+                        _idle.pop_back();
+                    } else if (_channels.size() < _connections) {
+                        channel = new OutgoingChannel(*this, _remoteId, _pipeline);
+                        _channels.push_back(channel);
+                    } else {
+                        channel = _channels[_next];
+                        _next = (_next + 1) % _channels.size();
+                    }
 
-                        if (!_outstandingMessages.empty()) {
-                            Submit(_outstandingMessages.front().Request);
+                    channel->ProxyRequest(request, id);
+                }
+                // A connection handled all its requests.
+                void Idle(OutgoingChannel& channel)
+                {
+                    uint8_t open = 0;
+
+                    for (const OutgoingChannel* entry : _idle) {
+                        if (entry->IsOpen() == true) {
+                            open++;
                         }
                     }
+
+                    if (open >= _maxIdle) {
+                        // Closed connections go to the front, so the open ones are picked first.
+                        channel.Close(0);
+                        _idle.push_front(&channel);
+                    } else {
+                        _idle.push_back(&channel);
+                    }
+                }
+                void Completed(const uint32_t id, Core::ProxyType<Web::Response>& response, const uint64_t start)
+                {
+                    const uint64_t now = Core::Time::Now().Ticks();
+                    const uint32_t duration = static_cast<uint32_t>(now > start ? (now - start) / 1000 : 0);
+                    uint8_t bucket = 0;
+
+                    while ((bucket < Buckets) && (duration >= Limits()[bucket])) {
+                        bucket++;
+                    }
+
+                    _histogram[bucket]++;
+                    _requests++;
+                    _latency += duration;
+
+                    _parent.Submit(id, response);
+                }
+                void Failed(const uint32_t id, Core::ProxyType<Web::Response>& response)
+                {
+                    _parent.Submit(id, response);
+                }
+                inline void Reconnect(OutgoingChannel& channel, const uint32_t delay)
+                {
+                    _parent.Reconnect(channel, delay);
+                }
+                inline void Revoke(OutgoingChannel& channel)
+                {
+                    _parent.Revoke(channel);
+                }
+                void Statistics(Plugin::WebServerImplementation::Statistics::Upstream& info) const
+                {
+                    info.Path = _path;
+                    info.Server = _remoteId.HostAddress() + ':' + Core::NumberType<uint16_t>(_remoteId.PortNumber()).Text();
+                    info.Connections = static_cast<uint8_t>(_channels.size());
+                    info.Idle = static_cast<uint8_t>(_idle.size());
+                    info.Requests = _requests;
+                    info.Latency = static_cast<uint32_t>(_requests > 0 ? _latency / _requests : 0);
+
+                    for (uint8_t index = 0; index <= Buckets; index++) {
+                        Plugin::WebServerImplementation::Statistics::Bucket& entry(info.Histogram.Add());
+
+                        if (index < Buckets) {
+                            entry.Limit = Limits()[index];
+                        }
+                        entry.Count = _histogram[index];
+                    }
+                }
+
+            private:
+                static const uint32_t* Limits()
+                {
+                    static const uint32_t limits[Buckets] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+                    return (limits);
                 }
-                virtual void Received(Core::ProxyType<Web::Response>& response);
 
             private:
+                ProxyMap& _parent;
                 const string _path;
                 const string _replacement;
+                const Core::NodeId _remoteId;
+                const uint8_t _connections;
+                const uint8_t _maxIdle;
+                const uint8_t _pipeline;
+                std::vector<OutgoingChannel*> _channels;
+                std::deque<OutgoingChannel*> _idle;
+                uint32_t _next;
+                uint32_t _requests;
+                uint64_t _latency;
+                uint32_t _histogram[Buckets + 1];
+            };
+
+            // Delayed reconnects run from a timer, all it does is opening the link, see OutgoingChannel::Reconnect.
+            // The outcome is reported on the communication thread, like any other state change of the link.
+            class ReconnectHandler {
+            public:
+                ReconnectHandler()
+                    : _channel(nullptr)
+                {
+                }
+                ReconnectHandler(OutgoingChannel& channel)
+                    : _channel(&channel)
+                {
+                }
+                ReconnectHandler(const ReconnectHandler& copy)
+                    : _channel(copy._channel)
+                {
+                }
+                ~ReconnectHandler()
+                {
+                }
+
+                ReconnectHandler& operator=(const ReconnectHandler& RHS)
+                {
+                    _channel = RHS._channel;
+                    return (*this);
+                }
+                bool operator==(const ReconnectHandler& RHS) const
+                {
+                    return (_channel == RHS._channel);
+                }
+
+            public:
+                uint64_t Timed(const uint64_t scheduledTime)
+                {
+                    ASSERT(_channel != nullptr);
+
+                    _channel->Reconnect();
+
+                    return (0);
+                }
 
-                std::list<OutstandingMessage> _outstandingMessages;
-                ProxyMap& _proxyMap;
+            private:
+                OutgoingChannel* _channel;
             };
 
         private:
@@ -273,6 +734,7 @@ namespace Plugin {
             ProxyMap(ChannelMap& server)
                 : _server(server)
                 , _proxies()
+                , _reconnectTimer(Core::Thread::DefaultStackSize(), _T("ProxyReconnect"))
             {
             }
             ~ProxyMap()
@@ -292,13 +754,13 @@ namespace Plugin {
 
                 while (index.Next() == true) {
 
-                    const string& path(index.Current().Path.Value());
-                    const string& subst(index.Current().Subst.Value());
-                    const Core::NodeId address(index.Current().Server.Value().c_str());
+                    const Config::Proxy& proxy(index.Current());
+                    const Core::NodeId address(proxy.Server.Value().c_str());
 
                     if (address.IsValid() == true) {
 
-                        _proxies.push_back(new OutgoingChannel(path, subst, *this, address));
+                        _proxies.push_back(new Upstream(*this, proxy.Path.Value(), proxy.Subst.Value(), address,
+                            proxy.Connections.Value(), proxy.MinIdle.Value(), proxy.MaxIdle.Value(), proxy.Pipeline.Value()));
                     }
                 }
             }
@@ -306,7 +768,7 @@ namespace Plugin {
             void Destroy()
             {
 
-                std::list<OutgoingChannel*>::iterator index(_proxies.begin());
+                std::list<Upstream*>::iterator index(_proxies.begin());
 
                 while (index != _proxies.end()) {
 
@@ -322,7 +784,7 @@ namespace Plugin {
 
                 bool found = false;
                 const string& originalPath = request->Path;
-                std::list<OutgoingChannel*>::iterator index(_proxies.begin());
+                std::list<Upstream*>::iterator index(_proxies.begin());
                 string proxyPath;
 
                 while ((found == false) && (index != _proxies.end())) {
@@ -344,7 +806,7 @@ namespace Plugin {
 
                     request->Path = (proxyPath + request->Path.substr(proxyPath.length()));
 
-                    (*index)->ProxyRequest(request, channelId);
+                    (*index)->Relay(request, channelId);
                 }
 
                 return (found);
@@ -355,13 +817,15 @@ namespace Plugin {
                 const Core::NodeId node(address.c_str());
 
                 if (node.IsValid() == true) {
+                    const Config::Proxy defaults;
 
-                    _proxies.push_back(new OutgoingChannel(path, subst, *this, node));
+                    _proxies.push_back(new Upstream(*this, path, subst, node,
+                        defaults.Connections.Value(), defaults.MinIdle.Value(), defaults.MaxIdle.Value(), defaults.Pipeline.Value()));
                 }
             }
             inline void RemoveProxy(const string& path)
             {
-                std::list<OutgoingChannel*>::iterator index(_proxies.begin());
+                std::list<Upstream*>::iterator index(_proxies.begin());
 
                 while ((index != _proxies.end()) && ((*index)->Path() != path)) {
 
@@ -378,10 +842,165 @@ namespace Plugin {
             {
                 _server.Submit(channelId, response);
             }
+            void Reconnect(OutgoingChannel& channel, const uint32_t delay)
+            {
+                Core::Time nextTick(Core::Time::Now());
+
+                nextTick.Add(delay);
+
+                _reconnectTimer.Schedule(nextTick.Ticks(), ReconnectHandler(channel));
+            }
+            inline void Revoke(OutgoingChannel& channel)
+            {
+                _reconnectTimer.Revoke(ReconnectHandler(channel));
+            }
+            void Statistics(Plugin::WebServerImplementation::Statistics& info) const
+            {
+                for (const Upstream* proxy : _proxies) {
+                    proxy->Statistics(info.Upstreams.Add());
+                }
+            }
 
         private:
             ChannelMap& _server;
-            std::list<OutgoingChannel*> _proxies;
+            std::list<Upstream*> _proxies;
+            Core::TimerType<ReconnectHandler> _reconnectTimer;
+        };
+
+        // Keeps the content of recently served (small) files in memory, least recently used ones are
+        // dropped first. Before an entry is used, it is validated against the file on disk (size and
+        // modification time), which costs a stat() instead of an open() and read() of the file.
+        // Like the ProxyMap, it is only used from the communication thread, so it needs no locking.
+        class FileCache {
+        private:
+            FileCache(const FileCache&) = delete;
+            FileCache& operator=(const FileCache&) = delete;
+
+        public:
+            struct Entry {
+                string Path;
+                uint64_t Size;
+                uint64_t Modified;
+                bool Cached; // Too large files are tracked, but their content is not cached.
+                std::shared_ptr<const string> Content;
+            };
+
+        private:
+            typedef std::list<Entry> EntryList;
+
+        public:
+            FileCache()
+                : _entries()
+                , _index()
+                , _capacity(0)
+                , _maxFileSize(0)
+                , _size(0)
+            {
+            }
+            ~FileCache()
+            {
+            }
+
+        public:
+            void Configure(const uint32_t capacity, const uint32_t maxFileSize)
+            {
+                _capacity = capacity;
+                _maxFileSize = std::min(maxFileSize, capacity);
+                Evict(0);
+            }
+            // Returns nullptr if the file does not exist.
+            const Entry* Find(const string& path)
+            {
+                const Entry* result = nullptr;
+                struct stat info;
+                std::unordered_map<string, EntryList::iterator>::iterator index(_index.find(path));
+
+                if (::stat(path.c_str(), &info) != 0) {
+                    if (index != _index.end()) {
+                        Remove(index);
+                    }
+                } else {
+                    const uint64_t size = static_cast<uint64_t>(info.st_size);
+                    const uint64_t modified = static_cast<uint64_t>(info.st_mtime);
+
+                    if ((index != _index.end()) && ((index->second->Size != size) || (index->second->Modified != modified))) {
+                        // Changed on disk since it was loaded.
+                        Remove(index);
+                        index = _index.end();
+                    }
+
+                    if (index != _index.end()) {
+                        _entries.splice(_entries.begin(), _entries, index->second);
+                        result = &(*(index->second));
+                    } else {
+                        Entry entry;
+
+                        entry.Path = path;
+                        entry.Size = size;
+                        entry.Modified = modified;
+                        entry.Cached = (size <= _maxFileSize) && (Load(path, size, entry.Content) == true);
+
+                        Evict(entry.Cached == true ? size : 0);
+
+                        _entries.push_front(std::move(entry));
+                        _index[path] = _entries.begin();
+                        _size += (_entries.front().Cached == true ? size : 0);
+
+                        result = &(_entries.front());
+                    }
+                }
+
+                return (result);
+            }
+
+        private:
+            static bool Load(const string& path, const uint64_t size, std::shared_ptr<const string>& content)
+            {
+                Core::File file(path);
+                bool result = false;
+
+                if (file.Open(true) == true) {
+                    std::shared_ptr<string> loaded(std::make_shared<string>(static_cast<size_t>(size), '\0'));
+
+                    result = (size == 0) || (file.Read(reinterpret_cast<uint8_t*>(&((*loaded)[0])), static_cast<uint32_t>(size)) == size);
+                    file.Close();
+
+                    if (result == true) {
+                        content = loaded;
+                    }
+                }
+
+                return (result);
+            }
+            void Remove(std::unordered_map<string, EntryList::iterator>::iterator& index)
+            {
+                if (index->second->Cached == true) {
+                    _size -= index->second->Size;
+                }
+                _entries.erase(index->second);
+                _index.erase(index);
+            }
+            // Make room for the given number of bytes, the metadata of uncached files is negligible,
+            // so those are only limited in number to the number of cached files.
+            void Evict(const uint64_t required)
+            {
+                while ((_entries.empty() == false) && (((_size + required) > _capacity) || (_entries.size() >= MaxEntries))) {
+                    std::unordered_map<string, EntryList::iterator>::iterator index(_index.find(_entries.back().Path));
+
+                    ASSERT(index != _index.end());
+
+                    Remove(index);
+                }
+            }
+
+        private:
+            static constexpr uint32_t MaxEntries = 1024;
+
+            EntryList _entries;
+            std::unordered_map<string, EntryList::iterator> _index;
+            uint64_t _capacity;
+            uint64_t _maxFileSize;
+            uint64_t _size;
         };
 
         class IncomingChannel : public Web::WebLinkType<Core::SocketStream, Web::Request, Web::Response, RequestFactory> {
@@ -488,9 +1107,11 @@ namespace Plugin {
                 : Core::SocketServerType<IncomingChannel>()
                 , _accessor()
                 , _prefixPath()
+                , _statisticsPath()
                 , _connectionCheckTimer(0)
                 , _cleanupTimer(Core::Thread::DefaultStackSize(), _T("ConnectionChecker"))
                 , _proxyMap(*this)
+                , _fileCache()
             {
             }
 #ifdef __WIN32__
@@ -530,6 +1151,10 @@ namespace Plugin {
 
                 _proxyMap.Create(index);
 
+                _statisticsPath = configuration.Statistics.Value();
+
+                _fileCache.Configure(configuration.CacheSize.Value() * 1024, configuration.CacheFileSize.Value() * 1024);
+
                 if (configuration.Interface.Value().empty() == false) {
                     Core::NodeId selectedNode = Plugin::Config::IPV4UnicastNode(configuration.Interface.Value());
 
@@ -590,6 +1215,21 @@ namespace Plugin {
             {
                 return (_proxyMap.Relay(request, id));
             }
+            inline FileCache& Files()
+            {
+                return (_fileCache);
+            }
+            inline bool IsStatistics(const string& path) const
+            {
+                return ((_statisticsPath.empty() == false) && (path == _statisticsPath));
+            }
+            inline void Statistics(string& text) const
+            {
+                Plugin::WebServerImplementation::Statistics info;
+
+                _proxyMap.Statistics(info);
+                info.ToString(text);
+            }
             inline string Accessor() const
             {
                 return (_accessor);
@@ -636,9 +1276,11 @@ namespace Plugin {
         private:
             string _accessor;
             string _prefixPath;
+            string _statisticsPath;
             uint32_t _connectionCheckTimer;
             Core::TimerType<TimeHandler> _cleanupTimer;
             ProxyMap _proxyMap;
+            FileCache _fileCache;
         };
 
     private:
@@ -737,51 +1379,153 @@ namespace Plugin {
 
         TRACE(WebFlow, (Core::proxy_cast<Web::Request>(request)));
 
+        if ((request->Verb == Web::Request::HTTP_GET) && (_parent.IsStatistics(request->Path) == true)) {
+            Core::ProxyType<Web::Response> response(PluginHost::Factories::Instance().Response());
+            Core::ProxyType<Web::TextBody> body(_textBodies.Element());
+
+            _parent.Statistics(*body);
+
+            response->ErrorCode = Web::STATUS_OK;
+            response->ContentType = Web::MIME_JSON;
+            response->Body(Core::proxy_cast<Web::IBody>(body));
+            Submit(response);
+        }
         // Check if the channel server will relay this message.
-        if (_parent.Relay(request, Id()) == false) {
+        else if (_parent.Relay(request, Id()) == false) {
 
             Core::ProxyType<Web::Response> response(PluginHost::Factories::Instance().Response());
-            Core::ProxyType<Web::FileBody> fileBody(PluginHost::Factories::Instance().FileBody());
 
             // If so, don't deal with it ourselves.
             Web::MIMETypes result;
             string fileToService = _parent.PrefixPath();
 
             if (Web::MIMETypeForFile(request->Path, fileToService, result) == false) {
+                // No filename gives, be default, we go for the index.html page..
+                fileToService += _T("index.html");
+                result = Web::MIME_HTML;
+            }
 
-                string fullPath = fileToService + _T("index.html");
+            response->ContentType = result;
+
+            const FileCache::Entry* entry = _parent.Files().Find(fileToService);
+
+            if (entry == nullptr) {
+                // Let the FileBody report the missing file, as before.
+                Core::ProxyType<Web::FileBody> fileBody(PluginHost::Factories::Instance().FileBody());
 
-                // No filename gives, be default, we go for the index.html page..
-                *fileBody = fileToService + _T("index.html");
-                response->ContentType = Web::MIME_HTML;
-                response->Body<Web::FileBody>(fileBody);
-            } else {
                 *fileBody = fileToService;
-                response->ContentType = result;
                 response->Body<Web::FileBody>(fileBody);
+            } else {
+                response->Modified = Core::Time(entry->Modified * 1000000);
+
+                if ((request->IfModifiedSince.IsSet() == true) && ((request->IfModifiedSince.Value().Ticks() / 1000000) >= entry->Modified)) {
+                    response->ErrorCode = Web::STATUS_NOT_MODIFIED;
+                    response->Message = _T("Not Modified");
+                } else if (entry->Cached == true) {
+                    Core::ProxyType<SharedBody> body(_sharedBodies.Element());
+
+                    body->Content(entry->Content);
+                    response->Body(Core::proxy_cast<Web::IBody>(body));
+                } else {
+                    Core::ProxyType<Web::FileBody> fileBody(PluginHost::Factories::Instance().FileBody());
+
+                    *fileBody = entry->Path;
+                    response->Body<Web::FileBody>(fileBody);
+                }
             }
+
             Submit(response);
         }
     }
 
+    WebServerImplementation::ProxyMap::OutgoingChannel::~OutgoingChannel()
+    {
+        _upstream.Revoke(*this);
+
+        _lock.Lock();
+        _delayed = false;
+        _lock.Unlock();
+
+        Close(Core::infinite);
+    }
+
+    void WebServerImplementation::ProxyMap::OutgoingChannel::Closed()
+    {
+        // The server may or may not have handled the requests that were sent but not answered. Only
+        // the idempotent ones can safely be sent again, the others fail.
+        std::deque<OutstandingMessage>::iterator index(_outstandingMessages.begin());
+
+        while ((_sent > 0) && (index != _outstandingMessages.end())) {
+            _sent--;
+
+            if (IsIdempotent(*(index->Request)) == true) {
+                index++;
+            } else {
+                Fail(*index);
+                index = _outstandingMessages.erase(index);
+            }
+        }
+
+        _sent = 0;
+        _sending = false;
+
+        if (_outstandingMessages.empty() == false) {
+            if (_reconnects == 0) {
+                _reconnects++;
+                Open(0);
+            } else if (_reconnects < MaxReconnects) {
+                _delayed = true;
+                _upstream.Reconnect(*this, ReconnectDelay << (_reconnects - 1));
+                _reconnects++;
+            } else {
+                TRACE_L1("Upstream %s unreachable, failing %d requests", RemoteId().c_str(), static_cast<uint32_t>(_outstandingMessages.size()));
+
+                while (_outstandingMessages.empty() == false) {
+                    Fail(_outstandingMessages.front());
+                    _outstandingMessages.pop_front();
+                }
+
+                _reconnects = 0;
+                _upstream.Idle(*this);
+            }
+        }
+    }
+
+    void WebServerImplementation::ProxyMap::OutgoingChannel::Fail(const OutstandingMessage& message)
+    {
+        Core::ProxyType<Web::Response> response(PluginHost::Factories::Instance().Response());
+
+        response->ErrorCode = Web::STATUS_BAD_GATEWAY;
+        response->Message = _T("Upstream server did not respond");
+
+        _upstream.Failed(message.Id, response);
+    }
+
     /* virtual */ void WebServerImplementation::ProxyMap::OutgoingChannel::Received(Core::ProxyType<Web::Response>& response)
     {
-        // Is response to our front of the list
+        _lock.Lock();
+
+        // Responses arrive in the order the requests were sent, so this is the one at the front.
         ASSERT(_outstandingMessages.empty() == false);
-        ASSERT(_outstandingMessages.front().Request.IsValid() == false);
+        ASSERT(_sent > 0);
 
-        if (_outstandingMessages.empty() == false) {
-            _proxyMap.Submit(_outstandingMessages.front().Id, response);
-            _outstandingMessages.pop_front();
+        if ((_outstandingMessages.empty() == false) && (_sent > 0)) {
+            const OutstandingMessage message(_outstandingMessages.front());
 
-            // See if ther is a next one to send.
-            if (_outstandingMessages.size() > 0) {
+            _outstandingMessages.pop_front();
+            _sent--;
 
-                ASSERT(_outstandingMessages.front().Request.IsValid() == true);
+            _upstream.Completed(message.Id, response, message.Start);
 
-                Submit(_outstandingMessages.front().Request);
+            if (_outstandingMessages.empty() == true) {
+                _upstream.Idle(*this);
+            } else {
+                // See if there is a next one to send.
+                SubmitNext();
             }
         }
+
+        _lock.Unlock();
     }
 
 } /* namespace Plugin */
@@ -158,12 +158,18 @@ namespace WPASupplicant {
     {
         uint16_t result = 0;
         _adminLock.Lock();
-        if ((_requests.size() > 0) && (_requests.front()->Message().empty() == false)) {
+        if ((_requests.size() > 0) && (_outstanding.size() < MaxOutstanding) && (_requests.front()->Message().empty() == false)) {
             string& data = _requests.front()->Message();
             TRACE(Communication, (_T("Send: [%s]"), data.c_str()));
             result = (data.length() > maxSendSize ? maxSendSize : data.length());
             memcpy(dataFrame, data.c_str(), result);
             data = data.substr(result);
+
+            if (data.empty() == true) {
+                // Completely sent, from now on it is waiting for its answer.
+                _outstanding.push_back(_requests.front());
+                _requests.pop_front();
+            }
         }
         _adminLock.Unlock();
         return (result);
@@ -229,21 +235,19 @@ namespace WPASupplicant {
                     _adminLock.Lock();
 
                     // Let see what we need to do with this BSSID, add or remove :-)
-                    if ((event == CTRL_EVENT_BSS_ADDED) && (_detailRequest.Set(bssid) == true)) {
-                        // send out a request for detail.
-                        Submit(&_detailRequest);
+                    if (event == CTRL_EVENT_BSS_ADDED) {
+                        Detail(bssid);
                     } else if (event == CTRL_EVENT_BSS_REMOVED) {
 
                         NetworkInfoContainer::iterator network(_networks.find(bssid));
 
                         if (network != _networks.end()) {
                             _networks.erase(network);
+                            _viewDirty = true;
                         }
                     }
 
-                    if (_callback != nullptr) {
-                        _callback->Dispatch(event.Value());
-                    }
+                    Notify(event.Value());
 
                     _adminLock.Unlock();
                 }
@@ -252,23 +256,32 @@ namespace WPASupplicant {
             }
         } else {
             _adminLock.Lock();
-            size_t requestsNumber = _requests.size();
-            _adminLock.Unlock();
-            if (requestsNumber > 0) {
-                _adminLock.Lock();
-                Request* current = _requests.front();
-                _requests.pop_front();
-                current->Processing(false);
-                current->Completed(response, false);
+            if (_outstanding.size() > 0) {
+                Request* current = _outstanding.front();
+                _outstanding.pop_front();
+
+                // A revoked request left an empty slot, its answer is dropped.
+                if (current != nullptr) {
+                    current->Processing(false);
+                    current->Completed(response, false);
+                }
 
                 _adminLock.Unlock();
 
                 Trigger();
             } else {
+                _adminLock.Unlock();
+
                 TRACE(Trace::Error, ("There is no pending request to process"));
             }
         }
 
+        _adminLock.Lock();
+        if (_viewDirty == true) {
+            Publish();
+        }
+        _adminLock.Unlock();
+
         return (receivedSize);
     }
     // These methods (add/add/update) are assumed to be running in a locked context.
@@ -276,7 +289,16 @@ namespace WPASupplicant {
     void Controller::Add(const uint64_t& bssid, const NetworkInfo& entry)
     {
         TRACE(Communication, (_T("Added SSID: %llX - %s"), bssid, entry.SSID().c_str()));
-        _networks[bssid] = entry;
+
+        NetworkInfoContainer::iterator index(_networks.find(bssid));
+
+        if (index == _networks.end()) {
+            _networks[bssid] = entry;
+        } else {
+            // Keep the detail we already have of this BSS, the scan only refreshes what it reports.
+            index->second.Set(entry.SSID(), entry.Frequency(), entry.Signal(), entry.Pair(), entry.Key());
+        }
+        _viewDirty = true;
         Reevaluate();
     }
     void Controller::Add(const string& ssid, const bool current, const uint64_t& bssid)
@@ -315,11 +337,12 @@ namespace WPASupplicant {
         } else {
             _networks[bssid] = NetworkInfo(id, ssid, frequency, signal, pairs, keys, throughput);
         }
+        _viewDirty = true;
 
         if (scanInProgress == true) {
             Reevaluate();
-        } else if (_callback != nullptr) {
-            _callback->Dispatch(CTRL_EVENT_NETWORK_CHANGED);
+        } else {
+            Notify(CTRL_EVENT_NETWORK_CHANGED);
         }
     }
 
@@ -345,26 +368,87 @@ namespace WPASupplicant {
     }
     void Controller::Reevaluate()
     {
-
         NetworkInfoContainer::iterator index(_networks.begin());
+        std::list<DetailRequest>::iterator request(_detailRequests.begin());
+        bool pending = false;
+
+        // Hand out the networks we have no detail of to the detail requests that are idle, skipping the
+        // ones that are already requested.
+        while (index != _networks.end()) {
+            if (index->second.HasDetail() == false) {
+                std::list<DetailRequest>::const_iterator busy(_detailRequests.begin());
+
+                while ((busy != _detailRequests.end()) && ((busy->IsSettable() == true) || (busy->BSSID() != index->first))) {
+                    busy++;
+                }
+
+                if (busy == _detailRequests.end()) {
+                    while ((request != _detailRequests.end()) && (request->IsSettable() == false)) {
+                        request++;
+                    }
+                    if (request == _detailRequests.end()) {
+                        pending = true;
+                        break;
+                    }
 
-        while ((index != _networks.end()) && (index->second.HasDetail() == true)) {
+                    request->Set(index->first);
+                    // send out a request for detail.
+                    Submit(&(*request));
+                }
+                pending = true;
+            }
             index++;
         }
-        if (index != _networks.end()) {
-            if (_detailRequest.Set(index->first) == true) {
-                // send out a request for detail.
-                Submit(&_detailRequest);
+
+        if (pending == false) {
+            if (_enabled.size() == 0) {
+                // send out a request for the network list
+                if (_networkRequest.Set() == true) {
+                    // send out a request for detail.
+                    Submit(&_networkRequest);
+                }
+            } else {
+                Notify(CTRL_EVENT_NETWORK_CHANGED);
             }
-        } else if (_enabled.size() == 0) {
-            // send out a request for the network list
-            if (_networkRequest.Set() == true) {
-                // send out a request for detail.
-                Submit(&_networkRequest);
+        }
+    }
+    void Controller::Detail(const uint64_t& bssid)
+    {
+        std::list<DetailRequest>::iterator request(_detailRequests.begin());
+
+        while ((request != _detailRequests.end()) && (request->IsSettable() == false)) {
+            request++;
+        }
+
+        if (request != _detailRequests.end()) {
+            request->Set(bssid);
+            // send out a request for detail.
+            Submit(&(*request));
+        } else if (_networks.find(bssid) == _networks.end()) {
+            // All detail requests are on their way, the next evaluation will pick this one up.
+            _networks[bssid] = NetworkInfo();
+        }
+    }
+    void Controller::Publish()
+    {
+        Core::ProxyType<ScanView> view(Core::ProxyType<ScanView>::Create());
+        NetworkInfoContainer::const_iterator index(_networks.begin());
+
+        view->Networks().reserve(_networks.size());
+
+        // Networks that are only known by their BSSID are not shown until their detail is in.
+        while (index != _networks.end()) {
+            if (index->second.Frequency() != 0) {
+                view->Networks().emplace_back(index->first, index->second);
             }
-        } else {
-            _callback->Dispatch(CTRL_EVENT_NETWORK_CHANGED);
+            index++;
         }
+
+        _viewLock.Lock();
+        _view = view;
+        _viewLock.Unlock();
+
+        _viewDirty = false;
     }
 }
 } // WPEFramework::WPASupplicant
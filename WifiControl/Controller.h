@@ -34,6 +34,10 @@ namespace WPASupplicant {
     private:
         static constexpr uint32_t MaxConnectionTime = 3000;
 
+        // The supplicant handles the requests on its control socket in order and answers them in
+        // order, so several requests can be on their way and the answers are matched by position.
+        static constexpr uint8_t MaxOutstanding = 4;
+
         Controller() = delete;
         Controller(const Controller&) = delete;
         Controller& operator=(const Controller&) = delete;
@@ -273,6 +277,10 @@ namespace WPASupplicant {
             {
                 _settable = processing == false;
             }
+            inline bool IsSettable() const
+            {
+                return (_settable);
+            }
 
             virtual void Completed(const string& response, const bool abort) = 0;
 
@@ -521,10 +529,17 @@ namespace WPASupplicant {
                 }
                 return (false);
             }
+            inline const uint64_t& BSSID() const
+            {
+                return (_bssid);
+            }
+            // The answer is decoded line by line, straight from the received buffer. Only the SSID is
+            // copied out, as that is the only text that is kept.
             virtual void Completed(const string& response, const bool abort) override
             {
                 if (abort == false) {
-                    Core::TextFragment data(response);
+                    const TCHAR* line = response.c_str();
+                    const TCHAR* const end = line + response.length();
 
                     string ssid;
                     uint32_t id = static_cast<uint32_t>(~1);
@@ -533,43 +548,49 @@ namespace WPASupplicant {
                     uint16_t pair = 0;
                     uint32_t keys = 0;
                     uint32_t throughput = 0;
-                    uint32_t marker = 0;
-                    uint32_t markerEnd = data.ForwardFind('\n', marker);
 
-                    while (marker != markerEnd) {
+                    while (line < end) {
+                        const TCHAR* lineEnd = static_cast<const TCHAR*>(::memchr(line, '\n', end - line));
+                        const TCHAR* separator;
 
-                        Core::TextSegmentIterator index(Core::TextFragment(data, marker, (markerEnd - marker)), false, '=');
-
-                        if (index.Next() == true) {
-
-                            string name(index.Current().Text());
+                        if (lineEnd == nullptr) {
+                            lineEnd = end;
+                        }
 
-                            if (index.Next() == true) {
-                                if (name == _T("id")) {
-                                    id = Core::NumberType<uint32_t>(index.Current());
-                                } else if (name == _T("est_throughput")) {
-                                    throughput = Core::NumberType<uint32_t>(index.Current());
-                                } else if (name == _T("ssid")) {
-                                    ssid = index.Current().Text();
-                                } else if (name == _T("freq")) {
-                                    freq = Core::NumberType<uint32_t>(index.Current());
-                                } else if (name == _T("level")) {
-                                    signal = Core::NumberType<int32_t>(index.Current());
-                                } else if (name == _T("level")) {
-                                    signal = Core::NumberType<int32_t>(index.Current());
-                                } else if (name == _T("flags")) {
-                                    pair = KeyPair(index.Current(), keys);
-                                }
+                        separator = static_cast<const TCHAR*>(::memchr(line, '=', lineEnd - line));
+
+                        if (separator != nullptr) {
+                            const uint32_t length = static_cast<uint32_t>(separator - line);
+                            const TCHAR* value = separator + 1;
+
+                            if (IsKey(line, length, _T("id"))) {
+                                id = static_cast<uint32_t>(::strtoul(value, nullptr, 10));
+                            } else if (IsKey(line, length, _T("est_throughput"))) {
+                                throughput = static_cast<uint32_t>(::strtoul(value, nullptr, 10));
+                            } else if (IsKey(line, length, _T("ssid"))) {
+                                ssid.assign(value, lineEnd - value);
+                            } else if (IsKey(line, length, _T("freq"))) {
+                                freq = static_cast<uint32_t>(::strtoul(value, nullptr, 10));
+                            } else if (IsKey(line, length, _T("level"))) {
+                                signal = static_cast<int32_t>(::strtol(value, nullptr, 10));
+                            } else if (IsKey(line, length, _T("flags"))) {
+                                pair = KeyPair(Core::TextFragment(value, static_cast<uint32_t>(lineEnd - value)), keys);
                             }
                         }
-                        marker = (markerEnd < data.Length() ? markerEnd + 1 : markerEnd);
-                        markerEnd = data.ForwardFind('\n', marker);
+
+                        line = lineEnd + 1;
                     }
 
                     _parent.Update(_bssid, ssid, id, freq, signal, pair, keys, throughput);
                 }
             }
 
+        private:
+            static bool IsKey(const TCHAR name[], const uint32_t length, const TCHAR key[])
+            {
+                return ((::strncmp(name, key, length) == 0) && (key[length] == '\0'));
+            }
+
         private:
             Controller& _parent;
             uint64_t _bssid;
@@ -712,6 +733,45 @@ namespace WPASupplicant {
             uint32_t _result;
         };
 
+        // A copy of the networks found, taken whenever the answers of the supplicant changed them. It
+        // is never changed once published, so readers only need the lock to pick up the latest one.
+        class ScanView {
+        private:
+            ScanView(const ScanView&) = delete;
+            ScanView& operator=(const ScanView&) = delete;
+
+        public:
+            ScanView()
+                : _entries()
+            {
+            }
+            ~ScanView()
+            {
+            }
+
+        public:
+            typedef std::vector<std::pair<uint64_t, NetworkInfo>> Entries;
+
+            inline const Entries& Networks() const
+            {
+                return (_entries);
+            }
+            inline Entries& Networks()
+            {
+                return (_entries);
+            }
+            const NetworkInfo* Find(const uint64_t bssid) const
+            {
+                Entries::const_iterator index(std::lower_bound(_entries.begin(), _entries.end(), bssid,
+                    [](const std::pair<uint64_t, NetworkInfo>& entry, const uint64_t value) { return (entry.first < value); }));
+
+                return ((index != _entries.end()) && (index->first == bssid) ? &(index->second) : nullptr);
+            }
+
+        private:
+            Entries _entries;
+        };
+
         typedef std::map<const uint64_t, NetworkInfo> NetworkInfoContainer;
         typedef std::map<const string, ConfigInfo> EnabledContainer;
         typedef Core::StreamType<Core::SocketDatagram> BaseClass;
@@ -721,15 +781,23 @@ namespace WPASupplicant {
             : BaseClass(false, Core::NodeId(), Core::NodeId(), 512, 32768)
             , _adminLock()
             , _requests()
+            , _outstanding()
             , _networks()
             , _enabled()
             , _error(Core::ERROR_UNAVAILABLE)
             , _callback(nullptr)
             , _scanRequest(*this)
-            , _detailRequest(*this)
+            , _detailRequests()
             , _networkRequest(*this)
             , _statusRequest(*this)
+            , _viewLock()
+            , _view(Core::ProxyType<ScanView>::Create())
+            , _viewDirty(false)
         {
+            for (uint8_t index = 0; index < MaxOutstanding; index++) {
+                _detailRequests.emplace_back(*this);
+            }
+
             string remoteName(Core::Directory::Normalize(supplicantBase) + interfaceName);
 
             if (Core::File(remoteName).Exists() == true) {
@@ -898,26 +966,22 @@ namespace WPASupplicant {
         {
 
             Network result;
+            Core::ProxyType<ScanView> view(View());
+            const NetworkInfo* entry(view->Find(id));
 
-            _adminLock.Lock();
-
-            NetworkInfoContainer::iterator index(_networks.find(id));
-
-            if (index != _networks.end()) {
+            if (entry != nullptr) {
                 result = Network(Core::ProxyType<Controller>(*this),
-                    (index->second.HasId() ? index->second.Id() : static_cast<uint32_t>(~0)),
-                    index->first,
-                    index->second.Frequency(),
-                    index->second.Signal(),
-                    index->second.Pair(),
-                    index->second.Key(),
-                    index->second.SSID(),
-                    index->second.Throughput(),
-                    index->second.IsHidden());
+                    (entry->HasId() ? entry->Id() : static_cast<uint32_t>(~0)),
+                    id,
+                    entry->Frequency(),
+                    entry->Signal(),
+                    entry->Pair(),
+                    entry->Key(),
+                    entry->SSID(),
+                    entry->Throughput(),
+                    entry->IsHidden());
             }
 
-            _adminLock.Unlock();
-
             return (result);
         }
         inline uint32_t Terminate()
@@ -963,12 +1027,11 @@ namespace WPASupplicant {
         {
             Core::ProxyType<Controller> channel(Core::ProxyType<Controller>(*this));
             Network::Iterator result;
+            Core::ProxyType<ScanView> view(View());
 
-            _adminLock.Lock();
-
-            NetworkInfoContainer::const_iterator index(_networks.begin());
+            ScanView::Entries::const_iterator index(view->Networks().begin());
 
-            while (index != _networks.end()) {
+            while (index != view->Networks().end()) {
                 result.Insert(Network(channel,
                     (index->second.HasId() ? index->second.Id() : static_cast<uint32_t>(~0)),
                     index->first,
@@ -982,8 +1045,6 @@ namespace WPASupplicant {
                 index++;
             }
 
-            _adminLock.Unlock();
-
             result.Reset();
 
             return (result);
@@ -1134,12 +1195,11 @@ namespace WPASupplicant {
         {
             uint64_t result = 0;
             int32_t strength(Core::NumberType<int32_t>::Min());
+            Core::ProxyType<ScanView> view(View());
 
-            _adminLock.Lock();
+            ScanView::Entries::const_iterator index(view->Networks().begin());
 
-            NetworkInfoContainer::const_iterator index(_networks.begin());
-
-            while (index != _networks.end()) {
+            while (index != view->Networks().end()) {
                 if ((index->second.SSID() == SSID) && (index->second.Signal() > strength)) {
                     strength = index->second.Signal();
                     result = index->first;
@@ -1147,8 +1207,6 @@ namespace WPASupplicant {
                 index++;
             }
 
-            _adminLock.Unlock();
-
             return (result);
         }
         inline uint32_t Connect(const string& SSID)
@@ -1283,6 +1341,10 @@ namespace WPASupplicant {
         inline void Notify(const events value)
         {
             _adminLock.Lock();
+            // Whoever is notified should find the networks as they are now.
+            if (_viewDirty == true) {
+                Publish();
+            }
             if (_callback != nullptr) {
                 _callback->Dispatch(value);
             }
@@ -1601,6 +1663,16 @@ namespace WPASupplicant {
         void Update(const uint64_t& bssid, const uint32_t id, const uint32_t throughput);
         void Update(const string& ssid, const uint32_t id, const bool succeeded);
         void Reevaluate();
+        void Detail(const uint64_t& bssid);
+        void Publish();
+        inline Core::ProxyType<ScanView> View() const
+        {
+            _viewLock.Lock();
+            Core::ProxyType<ScanView> result(_view);
+            _viewLock.Unlock();
+
+            return (result);
+        }
         virtual uint16_t SendData(uint8_t* dataFrame, const uint16_t maxSendSize);
         virtual uint16_t ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize);
 
@@ -1611,12 +1683,15 @@ namespace WPASupplicant {
             std::list<Request*>::iterator index(std::find(_requests.begin(), _requests.end(), id));
 
             if (index != _requests.end()) {
-                bool retrigger(index == _requests.begin());
                 (*index)->Processing(false);
                 _requests.erase(index);
+            } else {
+                index = std::find(_outstanding.begin(), _outstanding.end(), id);
 
-                if (retrigger == true) {
-                    const_cast<Controller*>(this)->Trigger();
+                if (index != _outstanding.end()) {
+                    // The answer is still on its way, keep the position so it does not end up at the next request.
+                    (*index)->Processing(false);
+                    (*index) = nullptr;
                 }
             }
             _adminLock.Unlock();
@@ -1631,6 +1706,14 @@ namespace WPASupplicant {
         {
             _adminLock.Lock();
 
+            while (_outstanding.size() != 0) {
+                Request* current = _outstanding.front();
+                _outstanding.pop_front();
+                if (current != nullptr) {
+                    current->Processing(false);
+                    current->Completed(EMPTY_STRING, true);
+                }
+            }
             while (_requests.size() != 0) {
                 Request* current = _requests.front();
                 _requests.pop_front();
@@ -1647,16 +1730,17 @@ namespace WPASupplicant {
             _adminLock.Lock();
 
             ASSERT(std::find(_requests.begin(), _requests.end(), data) == _requests.end());
+            ASSERT(std::find(_outstanding.begin(), _outstanding.end(), data) == _outstanding.end());
 
             data->Processing(true);
             _requests.push_back(data);
 
-            if (_requests.size() == 1) {
+            if ((_requests.size() == 1) && (_outstanding.size() < MaxOutstanding)) {
                 _adminLock.Unlock();
 
                 const_cast<Controller*>(this)->Trigger();
             } else {
-                TRACE_L1("Submit does not trigger, there are %d messages pending [%s,%s]", static_cast<unsigned int>(_requests.size()), _requests.front()->Original().c_str(), _requests.front()->Message().c_str());
+                TRACE_L1("Submit does not trigger, there are %d messages pending and %d outstanding", static_cast<unsigned int>(_requests.size()), static_cast<unsigned int>(_outstanding.size()));
                 _adminLock.Unlock();
             }
         }
@@ -1664,14 +1748,18 @@ namespace WPASupplicant {
     private:
         mutable Core::CriticalSection _adminLock;
         mutable std::list<Request*> _requests;
+        mutable std::list<Request*> _outstanding;
         NetworkInfoContainer _networks;
         EnabledContainer _enabled;
         uint32_t _error;
         Core::IDispatchType<const events>* _callback;
         ScanRequest _scanRequest;
-        DetailRequest _detailRequest;
+        std::list<DetailRequest> _detailRequests;
         NetworkRequest _networkRequest;
         StatusRequest _statusRequest;
+        mutable Core::CriticalSection _viewLock;
+        Core::ProxyType<ScanView> _view;
+        bool _viewDirty;
     };
 }
 } // namespace WPEFramework::WPASupplicant